@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DocGenBinaryDumpCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenBinaryFormat.h"
+
+UDocGenBinaryDumpCommandlet::UDocGenBinaryDumpCommandlet()
+{
+	HelpParamNames.Add("input");
+	HelpParamDescriptions.Add("Binary intermediate file, or a directory to search recursively for them");
+
+	HelpParamNames.Add("output");
+	HelpParamDescriptions.Add(
+		"Directory to write json dumps to, mirroring the input layout. Defaults to writing next to each input file");
+}
+
+int32 UDocGenBinaryDumpCommandlet::Main(const FString& Params)
+{
+	Super::Main(Params);
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParsedParams;
+	ParseCommandLine(*Params, Tokens, Switches, ParsedParams);
+
+	if (!ParsedParams.Contains("input"))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("No -input specified"));
+		return 1;
+	}
+	const FString InputPath = FPaths::ConvertRelativePathToFull(ParsedParams["input"]);
+
+	FString InputRoot;
+	TArray<FString> InputFiles;
+	if (IFileManager::Get().DirectoryExists(*InputPath))
+	{
+		InputRoot = InputPath;
+		IFileManager::Get().FindFilesRecursive(InputFiles, *InputPath,
+											   *(FString("*") + DocGenBinarySerializer::FileExtension), true, false);
+	}
+	else
+	{
+		InputRoot = FPaths::GetPath(InputPath);
+		InputFiles.Add(InputPath);
+	}
+
+	const FString OutputRoot =
+		ParsedParams.Contains("output") ? FPaths::ConvertRelativePathToFull(ParsedParams["output"]) : InputRoot;
+
+	int32 FailedCount = 0;
+	for (const FString& InputFile : InputFiles)
+	{
+		FString RelativePath = InputFile;
+		FPaths::MakePathRelativeTo(RelativePath, *(InputRoot / TEXT("")));
+		const FString OutputFile = FPaths::ChangeExtension(OutputRoot / RelativePath, TEXT(".json"));
+		if (!DumpFile(InputFile, OutputFile))
+		{
+			++FailedCount;
+		}
+	}
+
+	UE_LOG(LogKantanDocGen, Display, TEXT("Dumped %d of %d binary intermediate files"),
+		   InputFiles.Num() - FailedCount, InputFiles.Num());
+	return FailedCount ? 1 : 0;
+}
+
+bool UDocGenBinaryDumpCommandlet::DumpFile(const FString& InputFile, const FString& OutputFile)
+{
+	TSharedPtr<FDocGenBinaryDocument> Document = FDocGenBinaryDocument::Open(InputFile);
+	TSharedPtr<FJsonObject> JsonDocument = Document ? Document->ToJsonObject() : nullptr;
+	if (!JsonDocument)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Unable to decode %s"), *InputFile);
+		return false;
+	}
+
+	FString Result;
+	auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
+	if (!FJsonSerializer::Serialize(JsonDocument.ToSharedRef(), JsonWriter))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Unable to serialize %s to json"), *InputFile);
+		return false;
+	}
+	if (!FFileHelper::SaveStringToFile(Result, *OutputFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Unable to write %s"), *OutputFile);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DocGenBinaryDumpCommandlet.generated.h"
+
+/**
+ * Debug tool converting binary intermediate documents back to pretty-printed json
+ */
+UCLASS()
+class UDocGenBinaryDumpCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+	UDocGenBinaryDumpCommandlet();
+
+	int32 Main(const FString& Params) override;
+	bool DumpFile(const FString& InputFile, const FString& OutputFile);
+};
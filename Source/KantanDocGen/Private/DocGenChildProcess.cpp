@@ -0,0 +1,146 @@
+#include "DocGenChildProcess.h"
+#include "DocGenProcessLimiter.h"
+#include "DocGenUTF8.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "KantanDocGenLog.h"
+
+namespace
+{
+	// Output is checked again right away while a tool is writing, backing off to the maximum while it's quiet so a
+	// short lived tool isn't kept waiting on a fixed sleep
+	constexpr float MinPollIntervalSeconds = 0.001f;
+	constexpr float MaxPollIntervalSeconds = 0.05f;
+} // namespace
+
+FDocGenChildProcess::FDocGenChildProcess(const FString& ExecutablePath, const FString& Arguments)
+	: ExecutablePath(ExecutablePath),
+	  Arguments(Arguments)
+{}
+
+FDocGenChildProcess::EResult FDocGenChildProcess::Run(int32& OutReturnCode)
+{
+	FDocGenScopedProcessSlot ProcessSlot(ProcessLimiter);
+	if (ProcessLimiter && ProcessLimiter->IsCancelRequested())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Cancelled before starting %s"), *ExecutablePath);
+		return EResult::Cancelled;
+	}
+
+	void* ReadPipe = nullptr;
+	void* WritePipe = nullptr;
+	verify(FPlatformProcess::CreatePipe(ReadPipe, WritePipe));
+
+	FProcHandle Proc = FPlatformProcess::CreateProc(*ExecutablePath, *Arguments, true, false, false, nullptr, 0,
+													WorkingDirectory.IsEmpty() ? nullptr : *WorkingDirectory,
+													WritePipe);
+	if (!Proc.IsValid())
+	{
+		FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create process %s"), *ExecutablePath);
+		return EResult::LaunchFailed;
+	}
+
+	PendingOutput.Reset();
+	PendingOutputStart = 0;
+	LineScanStart = 0;
+
+	const double TimeoutSeconds = ProcessLimiter ? ProcessLimiter->GetProcessTimeoutSeconds() : 0.0;
+	const double StartTime = FPlatformTime::Seconds();
+	float PollIntervalSeconds = MinPollIntervalSeconds;
+	EResult Result = EResult::Exited;
+	int32 ReturnCode = 0;
+	while (true)
+	{
+		// Checked before reading, so whatever the process wrote before exiting is still read below
+		const bool bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
+		const bool bReadOutput = ReadOutput(ReadPipe);
+		if (bProcessFinished)
+		{
+			// The pipe may have held more than a single read returns
+			while (ReadOutput(ReadPipe))
+			{
+			}
+			break;
+		}
+		if (ProcessLimiter && ProcessLimiter->IsCancelRequested())
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Cancelled %s"), *ExecutablePath);
+			Result = EResult::Cancelled;
+			break;
+		}
+		if (TimeoutSeconds > 0.0 && FPlatformTime::Seconds() - StartTime > TimeoutSeconds)
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("%s timed out after %.0f seconds"), *ExecutablePath, TimeoutSeconds);
+			Result = EResult::TimedOut;
+			break;
+		}
+		PollIntervalSeconds =
+			bReadOutput ? MinPollIntervalSeconds : FMath::Min(PollIntervalSeconds * 2.0f, MaxPollIntervalSeconds);
+		FPlatformProcess::Sleep(PollIntervalSeconds);
+	}
+
+	if (Result != EResult::Exited)
+	{
+		FPlatformProcess::TerminateProc(Proc, true);
+	}
+	FPlatformProcess::CloseProc(Proc);
+	FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+
+	// A last line without a terminator
+	if (PendingOutputStart < PendingOutput.Num())
+	{
+		DispatchLine(PendingOutputStart, PendingOutput.Num());
+	}
+	PendingOutput.Empty();
+
+	if (Result == EResult::Exited)
+	{
+		OutReturnCode = ReturnCode;
+	}
+	return Result;
+}
+
+bool FDocGenChildProcess::ReadOutput(void* ReadPipe)
+{
+	TArray<uint8> Bytes;
+	if (!FPlatformProcess::ReadPipeToArray(ReadPipe, Bytes) || Bytes.Num() == 0)
+	{
+		return false;
+	}
+	if (PendingOutputStart > 0 && PendingOutputStart >= PendingOutput.Num() / 2)
+	{
+		PendingOutput.RemoveAt(0, PendingOutputStart);
+		LineScanStart -= PendingOutputStart;
+		PendingOutputStart = 0;
+	}
+	PendingOutput.Append(Bytes);
+	DispatchCompleteLines();
+	return true;
+}
+
+void FDocGenChildProcess::DispatchCompleteLines()
+{
+	for (int32 Index = LineScanStart; Index < PendingOutput.Num(); ++Index)
+	{
+		if (PendingOutput[Index] == '\n')
+		{
+			DispatchLine(PendingOutputStart, Index);
+			PendingOutputStart = Index + 1;
+		}
+	}
+	LineScanStart = PendingOutput.Num();
+}
+
+void FDocGenChildProcess::DispatchLine(int32 LineStart, int32 LineEnd)
+{
+	if (LineEnd > LineStart && PendingOutput[LineEnd - 1] == '\r')
+	{
+		--LineEnd;
+	}
+	if (!OutputLineHandler)
+	{
+		return;
+	}
+	OutputLineHandler(DocGenUTF8::ToString(PendingOutput.GetData() + LineStart, LineEnd - LineStart));
+}
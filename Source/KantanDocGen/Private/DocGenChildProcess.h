@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Runs an external tool to completion, handing its output to a handler a line at a time. Shared by every
+/// output processor so they all get the same slot limiting, timeout and cancellation behaviour.
+class FDocGenChildProcess
+{
+public:
+	enum class EResult : uint8
+	{
+		// The process ran to completion, check its return code
+		Exited,
+		LaunchFailed,
+		TimedOut,
+		Cancelled
+	};
+
+	FDocGenChildProcess(const FString& ExecutablePath, const FString& Arguments);
+
+	void SetWorkingDirectory(const FString& InWorkingDirectory)
+	{
+		WorkingDirectory = InWorkingDirectory;
+	}
+
+	/// @brief Once set the process only starts once it gets a slot of the limiter, and follows its timeout and
+	/// cancellation
+	void SetProcessLimiter(TSharedPtr<class FDocGenProcessLimiter> InProcessLimiter)
+	{
+		ProcessLimiter = InProcessLimiter;
+	}
+
+	/// @brief Called on the running thread with every line the process writes, without the line terminator
+	void SetOutputLineHandler(TFunction<void(const FString& Line)> InOutputLineHandler)
+	{
+		OutputLineHandler = MoveTemp(InOutputLineHandler);
+	}
+
+	/// @brief Launches the process and blocks until it exits, times out or is cancelled. Anything but a normal exit
+	/// is logged.
+	/// @param OutReturnCode only set when the result is Exited
+	EResult Run(int32& OutReturnCode);
+
+private:
+	/// @return whether the pipe had anything to read
+	bool ReadOutput(void* ReadPipe);
+	void DispatchCompleteLines();
+	void DispatchLine(int32 LineStart, int32 LineEnd);
+
+	FString ExecutablePath;
+	FString Arguments;
+	FString WorkingDirectory;
+	TSharedPtr<FDocGenProcessLimiter> ProcessLimiter;
+	TFunction<void(const FString& Line)> OutputLineHandler;
+
+	// Output not yet split into lines. Consumed bytes are only dropped from the front once they make up half of the
+	// buffer, so splitting stays linear however much a tool writes.
+	TArray<uint8> PendingOutput;
+	int32 PendingOutputStart = 0;
+	// Where to resume looking for a line terminator, everything before it has already been searched
+	int32 LineScanStart = 0;
+};
@@ -29,6 +29,12 @@ UDocGenCommandlet::UDocGenCommandlet()
 	HelpParamNames.Add("excludeclass");
 	HelpParamDescriptions.Add("Comma-separated list of classes to exclude");
 
+	HelpParamNames.Add("metainclude");
+	HelpParamDescriptions.Add("Comma-separated list of wildcard patterns of metadata keys to document, all when empty");
+
+	HelpParamNames.Add("metaexclude");
+	HelpParamDescriptions.Add("Comma-separated list of wildcard patterns of metadata keys to leave out");
+
 	HelpParamNames.Add("outputdir");
 	HelpParamDescriptions.Add("Directory to place processed documentation in");
 
@@ -43,6 +49,30 @@ UDocGenCommandlet::UDocGenCommandlet()
 
 	HelpParamNames.Add("template");
 	HelpParamDescriptions.Add("Path to the template file to use when rendering output for formats that require it");
+
+	HelpParamNames.Add("binaryintermediate");
+	HelpParamDescriptions.Add("writes json intermediate documents in the binary encoding instead of text");
+
+	HelpParamNames.Add("packintermediate");
+	HelpParamDescriptions.Add("appends json intermediate documents to a single pack file instead of loose files");
+
+	HelpParamNames.Add("compressintermediate");
+	HelpParamDescriptions.Add("compresses documents stored in the intermediate pack");
+
+	HelpParamNames.Add("skipunchanged");
+	HelpParamDescriptions.Add("only rewrites intermediate and output files whose content changed since the last run");
+
+	HelpParamNames.Add("compactjson");
+	HelpParamDescriptions.Add("writes consolidated.json without indentation or line breaks");
+
+	HelpParamNames.Add("stringtable");
+	HelpParamDescriptions.Add("writes long strings in consolidated.json once and refers to them by index");
+
+	HelpParamNames.Add("maxprocesses");
+	HelpParamDescriptions.Add("maximum number of conversion tools run at once while processing formats in parallel");
+
+	HelpParamNames.Add("processtimeout");
+	HelpParamDescriptions.Add("seconds after which a conversion tool that is still running is terminated");
 }
 
 int32 UDocGenCommandlet::Main(const FString& Params)
@@ -104,6 +134,16 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 		}
 	}
 
+	if (ParsedParams.Contains("metainclude"))
+	{
+		ParsedParams["metainclude"].ParseIntoArray(Settings.MetaDataIncludePatterns, TEXT(","));
+	}
+
+	if (ParsedParams.Contains("metaexclude"))
+	{
+		ParsedParams["metaexclude"].ParseIntoArray(Settings.MetaDataExcludePatterns, TEXT(","));
+	}
+
 	if (ParsedParams.Contains("outputdir"))
 	{
 		Settings.OutputDirectory.Path = ParsedParams["outputdir"];
@@ -132,10 +172,42 @@ int32 UDocGenCommandlet::Main(const FString& Params)
 			}
 		}
 	}
+	if (ParsedParams.Contains("maxprocesses"))
+	{
+		Settings.MaxConcurrentProcesses = FCString::Atoi(*ParsedParams["maxprocesses"]);
+	}
+	if (ParsedParams.Contains("processtimeout"))
+	{
+		Settings.ProcessTimeoutSeconds = FCString::Atof(*ParsedParams["processtimeout"]);
+	}
 	if (Switches.Contains("cleanoutput"))
 	{
 		Settings.bCleanOutputDirectory = true;
 	}
+	if (Switches.Contains("binaryintermediate"))
+	{
+		Settings.bBinaryIntermediates = true;
+	}
+	if (Switches.Contains("packintermediate"))
+	{
+		Settings.bPackIntermediateFiles = true;
+	}
+	if (Switches.Contains("compressintermediate"))
+	{
+		Settings.bCompressIntermediatePack = true;
+	}
+	if (Switches.Contains("skipunchanged"))
+	{
+		Settings.bSkipUnchangedFiles = true;
+	}
+	if (Switches.Contains("compactjson"))
+	{
+		Settings.bCompactConsolidatedJson = true;
+	}
+	if (Switches.Contains("stringtable"))
+	{
+		Settings.bConsolidatedStringTable = true;
+	}
 	auto& Module = FModuleManager::LoadModuleChecked<FKantanDocGenModule>(TEXT("KantanDocGen"));
 	auto GenerateDocsResult = Module.GenerateDocs(Settings);
 	while (!GenerateDocsResult.IsReady())
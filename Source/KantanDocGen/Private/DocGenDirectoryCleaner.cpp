@@ -0,0 +1,155 @@
+#include "DocGenDirectoryCleaner.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// Appended to the name of a directory that's renamed aside, followed by a guid
+	const TCHAR* const DeletingSuffix = TEXT(".deleting-");
+
+	class FBackgroundDelete : public FRunnable
+	{
+	public:
+		explicit FBackgroundDelete(const FString& InDirectory) : Directory(InDirectory) {}
+
+		virtual uint32 Run() override
+		{
+			if (!IFileManager::Get().DeleteDirectory(*Directory, false, true))
+			{
+				// Whatever is left gets another go the next time the directory it was renamed from is deleted
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to delete %s"), *Directory);
+			}
+			bFinished = true;
+			return 0;
+		}
+
+		const FString Directory;
+		FThreadSafeBool bFinished;
+	};
+
+	struct FPendingDelete
+	{
+		// Declared before the thread so the thread is destroyed, and waited for, first
+		TUniquePtr<FBackgroundDelete> Delete;
+		TUniquePtr<FRunnableThread> Thread;
+	};
+
+	FCriticalSection PendingDeletesLock;
+	TArray<FPendingDelete> PendingDeletes;
+
+	void StartBackgroundDelete(const FString& Directory)
+	{
+		FScopeLock Lock(&PendingDeletesLock);
+		for (int32 Index = PendingDeletes.Num() - 1; Index >= 0; --Index)
+		{
+			if (PendingDeletes[Index].Delete->bFinished)
+			{
+				PendingDeletes.RemoveAt(Index);
+			}
+			else if (PendingDeletes[Index].Delete->Directory == Directory)
+			{
+				return;
+			}
+		}
+		FPendingDelete& Pending = PendingDeletes.AddDefaulted_GetRef();
+		Pending.Delete = MakeUnique<FBackgroundDelete>(Directory);
+		Pending.Thread.Reset(
+			FRunnableThread::Create(Pending.Delete.Get(), TEXT("DocGenBackgroundDelete"), 0, TPri_Lowest));
+		if (!Pending.Thread)
+		{
+			// No threads on this platform
+			Pending.Delete->Run();
+		}
+	}
+
+	/// @brief Queues deleting trees renamed aside from Directory by runs that ended before deleting them
+	void DeleteAbandonedTrees(const FString& Directory)
+	{
+		TArray<FString> AbandonedTrees;
+		IFileManager::Get().FindFiles(AbandonedTrees, *(Directory + DeletingSuffix + TEXT("*")), false, true);
+		for (const FString& AbandonedTree : AbandonedTrees)
+		{
+			StartBackgroundDelete(FPaths::GetPath(Directory) / AbandonedTree);
+		}
+	}
+
+	/// @brief Deletes every file in Directory using all workers, then the emptied directories
+	/// @return false if some of the files couldn't be deleted
+	bool DeleteInParallel(const FString& Directory)
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFilesRecursive(Files, *Directory, TEXT("*"), true, false);
+		FThreadSafeCounter FailedDeletes;
+		ParallelFor(Files.Num(), [&](int32 FileIndex) {
+			if (!IFileManager::Get().Delete(*Files[FileIndex], false, true, true))
+			{
+				FailedDeletes.Increment();
+			}
+		});
+		// Fails if the directory itself is held open, which a caller cleaning it can live with
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		if (FailedDeletes.GetValue())
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to delete %d of %d files in %s"), FailedDeletes.GetValue(),
+				   Files.Num(), *Directory);
+			return false;
+		}
+		return true;
+	}
+} // namespace
+
+bool FDocGenDirectoryCleaner::Delete(const FString& Directory)
+{
+	FString DirectoryName = Directory;
+	FPaths::NormalizeDirectoryName(DirectoryName);
+	DeleteAbandonedTrees(DirectoryName);
+	if (!IFileManager::Get().DirectoryExists(*DirectoryName))
+	{
+		return true;
+	}
+	// Renaming within the parent never crosses a volume, so it's a rename rather than a copy on every platform
+	const FString RenamedDirectory = DirectoryName + DeletingSuffix + FGuid::NewGuid().ToString();
+	if (FPlatformFileManager::Get().GetPlatformFile().MoveFile(*RenamedDirectory, *DirectoryName))
+	{
+		StartBackgroundDelete(RenamedDirectory);
+		return true;
+	}
+	UE_LOG(LogKantanDocGen, Log, TEXT("Couldn't rename %s aside, deleting its files in place"), *DirectoryName);
+	return DeleteInParallel(DirectoryName);
+}
+
+bool FDocGenDirectoryCleaner::Clean(const FString& Directory)
+{
+	const bool bDeleted = Delete(Directory);
+	if (!IFileManager::Get().MakeDirectory(*Directory, true))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create %s"), *Directory);
+		return false;
+	}
+	return bDeleted;
+}
+
+void FDocGenDirectoryCleaner::WaitForBackgroundDeletes()
+{
+	TArray<FPendingDelete> Deletes;
+	{
+		FScopeLock Lock(&PendingDeletesLock);
+		Deletes = MoveTemp(PendingDeletes);
+	}
+	for (FPendingDelete& Pending : Deletes)
+	{
+		if (Pending.Thread)
+		{
+			Pending.Thread->WaitForCompletion();
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+
+/// @brief Removes directory trees without making the caller wait for every file to be deleted. A tree is renamed
+/// aside, which is a single operation however many files it holds, and deleted on a lowest priority thread while the
+/// caller carries on. Where the rename fails, for example because something holds the directory open, the files are
+/// deleted in parallel instead before returning.
+/// All members are safe to call from any thread.
+class FDocGenDirectoryCleaner
+{
+public:
+	/// @brief Removes Directory. Trees renamed aside by earlier runs that didn't get to delete them are removed too.
+	/// @return false if some of the files couldn't be deleted
+	static bool Delete(const FString& Directory);
+
+	/// @brief Leaves Directory existing and empty
+	/// @return false if some of its files couldn't be deleted or it couldn't be created
+	static bool Clean(const FString& Directory);
+
+	/// @brief Blocks until every background delete has finished
+	static void WaitForBackgroundDeletes();
+};
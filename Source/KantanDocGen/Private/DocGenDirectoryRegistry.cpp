@@ -0,0 +1,44 @@
+#include "DocGenDirectoryRegistry.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Paths.h"
+
+bool FDocGenDirectoryRegistry::EnsureDirectory(const FString& Directory)
+{
+	{
+		FReadScopeLock ReadLock(KnownDirectoriesLock);
+		if (KnownDirectories.Contains(Directory))
+		{
+			return true;
+		}
+	}
+	// Parents first, which stops at the first one that's known. A path without a parent is a root, taken to exist.
+	const FString Parent = FPaths::GetPath(Directory);
+	if (!Parent.IsEmpty() && Parent != Directory && !EnsureDirectory(Parent))
+	{
+		return false;
+	}
+	// Creating a directory that already exists succeeds, so there's no need to check first. Threads racing to
+	// create the same directory both succeed too.
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.CreateDirectory(*Directory) && !PlatformFile.DirectoryExists(*Directory))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create directory %s"), *Directory);
+		return false;
+	}
+	FWriteScopeLock WriteLock(KnownDirectoriesLock);
+	KnownDirectories.Add(Directory);
+	return true;
+}
+
+bool FDocGenDirectoryRegistry::SaveArrayToFile(const TArray<uint8>& Bytes, const FString& FilePath)
+{
+	if (!EnsureDirectory(FPaths::GetPath(FilePath)))
+	{
+		return false;
+	}
+	TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath));
+	// Closing the handle can't report a failure, so whatever is still buffered is flushed while it can
+	return File && File->Write(Bytes.GetData(), Bytes.Num()) && File->Flush();
+}
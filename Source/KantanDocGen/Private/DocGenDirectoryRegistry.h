@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Containers/Set.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+/// @brief Remembers which directories exist so each is created once, by the first write into it. Creating a file
+/// through IFileManager checks and creates every parent directory on every write, writers that go through a registry
+/// pay for each directory only once.
+/// Only knows about directories it created itself, so nothing may delete them while it is in use.
+/// All members are safe to call from any thread.
+class FDocGenDirectoryRegistry
+{
+public:
+	/// @brief Creates Directory and any missing parents, unless this registry already did
+	/// @return false if it couldn't be created
+	bool EnsureDirectory(const FString& Directory);
+
+	/// @brief Writes Bytes to FilePath, creating its directory through the registry
+	/// @return Whether every byte was written and flushed to the file
+	bool SaveArrayToFile(const TArray<uint8>& Bytes, const FString& FilePath);
+
+private:
+	FRWLock KnownDirectoriesLock;
+	TSet<FString> KnownDirectories;
+};
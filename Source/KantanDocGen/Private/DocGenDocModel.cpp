@@ -0,0 +1,49 @@
+#include "DocGenDocModel.h"
+#include "DocTreeNode.h"
+#include "Json.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "OutputFormats/DocGenJsonOutputFormat.h"
+
+void FDocGenDocModel::AddDocument(const FString& JsonFilePath, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document)
+{
+	const FString Key = MakeKey(JsonFilePath);
+	FScopeLock Lock(&DocumentsLock);
+	Documents.Add(Key, Document);
+}
+
+TSharedPtr<FJsonObject> FDocGenDocModel::LoadJson(const FString& JsonFilePath) const
+{
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document;
+	{
+		const FString Key = MakeKey(JsonFilePath);
+		FScopeLock Lock(&DocumentsLock);
+		if (const TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>* FoundDocument = Documents.Find(Key))
+		{
+			Document = *FoundDocument;
+		}
+	}
+	if (!Document)
+	{
+		return nullptr;
+	}
+
+	// The json intermediate serializer builds exactly this object before printing it, so stop there
+	DocGenJsonSerializer Serializer;
+	Document->SerializeWith(Serializer);
+	return Serializer.GetJsonObject();
+}
+
+int32 FDocGenDocModel::Num() const
+{
+	FScopeLock Lock(&DocumentsLock);
+	return Documents.Num();
+}
+
+FString FDocGenDocModel::MakeKey(const FString& JsonFilePath)
+{
+	FString Key = JsonFilePath;
+	FPaths::NormalizeFilename(Key);
+	FPaths::CollapseRelativeDirectories(Key);
+	return Key;
+}
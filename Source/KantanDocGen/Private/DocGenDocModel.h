@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+
+class DocTreeNode;
+
+/// @brief Every json intermediate document produced by the current run, keyed by the path its intermediate file is
+/// written to. Processors running in the same process read documents from here rather than loading back and parsing
+/// the files the generator just wrote. All members are safe to call from any thread.
+class FDocGenDocModel
+{
+public:
+	/// @brief Records Document as the content of the json intermediate at JsonFilePath. The document must not be
+	/// modified afterwards.
+	void AddDocument(const FString& JsonFilePath, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document);
+
+	/// @brief Builds the json the intermediate at JsonFilePath would have parsed to
+	/// @return the document, or nullptr if this run didn't produce it
+	TSharedPtr<class FJsonObject> LoadJson(const FString& JsonFilePath) const;
+
+	int32 Num() const;
+
+private:
+	static FString MakeKey(const FString& JsonFilePath);
+
+	mutable FCriticalSection DocumentsLock;
+	TMap<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> Documents;
+};
@@ -0,0 +1,130 @@
+#include "DocGenImageManifest.h"
+#include "DocGenWriteQueue.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include "Windows/WindowsHWrapper.h"
+	#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	#include <unistd.h>
+#endif
+
+const TCHAR* const FDocGenImageManifest::ManifestFileName = TEXT("images.manifest");
+
+namespace
+{
+	bool CreateHardLink(const FString& LinkPath, const FString& TargetPath)
+	{
+#if PLATFORM_WINDOWS
+		return ::CreateHardLinkW(*LinkPath, *TargetPath, nullptr) != 0;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+		return ::link(TCHAR_TO_UTF8(*TargetPath), TCHAR_TO_UTF8(*LinkPath)) == 0;
+#else
+		return false;
+#endif
+	}
+} // namespace
+
+TSharedPtr<FDocGenImageManifest> FDocGenImageManifest::Load(const FString& ManifestPath)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ManifestPath))
+	{
+		return nullptr;
+	}
+	TSharedPtr<FDocGenImageManifest> Manifest = MakeShared<FDocGenImageManifest>();
+	// One image per line: <hash as hex>\t<size>\t<id>\t<absolute path>
+	for (const FString& Line : Lines)
+	{
+		TArray<FString> Fields;
+		if (Line.ParseIntoArray(Fields, TEXT("\t"), false) != 4)
+		{
+			continue;
+		}
+		FImage& Image = Manifest->Images.AddDefaulted_GetRef();
+		Image.Hash = FCString::Strtoui64(*Fields[0], nullptr, 16);
+		Image.Size = FCString::Atoi64(*Fields[1]);
+		Image.Id = MoveTemp(Fields[2]);
+		Image.Path = MoveTemp(Fields[3]);
+		Manifest->ImageIndices.Add(Image.Id, Manifest->Images.Num() - 1);
+	}
+	return Manifest;
+}
+
+void FDocGenImageManifest::Add(const FString& Path, uint64 Hash)
+{
+	FImage Image;
+	Image.Id = FPaths::GetCleanFilename(Path);
+	Image.Path = Path;
+	Image.Hash = Hash;
+
+	FScopeLock Lock(&ImagesLock);
+	if (const int32* ExistingIndex = ImageIndices.Find(Image.Id))
+	{
+		Images[*ExistingIndex] = MoveTemp(Image);
+		return;
+	}
+	ImageIndices.Add(Image.Id, Images.Num());
+	Images.Add(MoveTemp(Image));
+}
+
+bool FDocGenImageManifest::Save(const FString& ManifestPath)
+{
+	FScopeLock Lock(&ImagesLock);
+	// Images are added in whatever order the worker threads get to them, sort so the manifest itself is stable
+	Images.Sort([](const FImage& A, const FImage& B) { return A.Id.Compare(B.Id, ESearchCase::CaseSensitive) < 0; });
+	ImageIndices.Reset();
+	FString Contents;
+	for (int32 Index = 0; Index < Images.Num(); ++Index)
+	{
+		FImage& Image = Images[Index];
+		Image.Size = IFileManager::Get().FileSize(*Image.Path);
+		ImageIndices.Add(Image.Id, Index);
+		if (Image.Size < 0)
+		{
+			continue;
+		}
+		Contents += FString::Printf(TEXT("%016llx\t%lld\t%s\t%s") LINE_TERMINATOR, Image.Hash, Image.Size, *Image.Id,
+									*Image.Path);
+	}
+	if (!FFileHelper::SaveStringToFile(Contents, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to save image manifest %s"), *ManifestPath);
+		return false;
+	}
+	return true;
+}
+
+const FDocGenImageManifest::FImage* FDocGenImageManifest::Find(const FString& Id) const
+{
+	const int32* Index = ImageIndices.Find(Id);
+	return Index ? &Images[*Index] : nullptr;
+}
+
+void FDocGenImageManifest::EnqueuePlacement(FDocGenWriteQueue& WriteQueue, const FString& DestinationPath,
+											const FImage& Image, bool bFailureIsError)
+{
+	WriteQueue.EnqueueTaskIfChanged(
+		DestinationPath, Image.Hash, 0,
+		[DestinationPath, SourcePath = Image.Path]() { return PlaceImage(DestinationPath, SourcePath); },
+		bFailureIsError);
+}
+
+bool FDocGenImageManifest::PlaceImage(const FString& DestinationPath, const FString& SourcePath)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	// A link can't replace an existing file
+	FileManager.Delete(*DestinationPath, false, true, true);
+	FileManager.MakeDirectory(*FPaths::GetPath(DestinationPath), true);
+	if (CreateHardLink(DestinationPath, SourcePath))
+	{
+		return true;
+	}
+	// Linking fails across volumes and on filesystems without hard links
+	return FileManager.Copy(*DestinationPath, *SourcePath, true) == COPY_OK;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Record of every image a generator run produced, written next to the intermediate docs. Processors place
+/// images from it instead of searching the intermediate directory for them.
+/// Add is safe to call from any thread, a loaded manifest is read only.
+class FDocGenImageManifest
+{
+public:
+	static const TCHAR* const ManifestFileName;
+
+	struct FImage
+	{
+		// File name of the image, which is what documents reference it by
+		FString Id;
+		FString Path;
+		int64 Size = 0;
+		// Hash of the pixels the image was encoded from, identical pixels encode to an identical file
+		uint64 Hash = 0;
+	};
+
+	/// @return the manifest, or nullptr if it doesn't exist or couldn't be read
+	static TSharedPtr<FDocGenImageManifest> Load(const FString& ManifestPath);
+
+	/// @brief Records an image that is being written to Path
+	void Add(const FString& Path, uint64 Hash);
+
+	/// @brief Writes the manifest, filling in the size of every image. Only call once the images are on disk, images
+	/// that don't exist are left out.
+	bool Save(const FString& ManifestPath);
+
+	const FImage* Find(const FString& Id) const;
+
+	const TArray<FImage>& GetImages() const
+	{
+		return Images;
+	}
+
+	/// @brief Queues placing Image at DestinationPath, skipped if the queue's manifest shows it's already there
+	/// @param bFailureIsError whether a failure should make the next Flush fail, or only be logged
+	static void EnqueuePlacement(class FDocGenWriteQueue& WriteQueue, const FString& DestinationPath,
+								 const FImage& Image, bool bFailureIsError = true);
+
+	/// @brief Hard links DestinationPath to SourcePath, copying instead where the filesystem can't link them.
+	/// Whatever is at DestinationPath is replaced.
+	static bool PlaceImage(const FString& DestinationPath, const FString& SourcePath);
+
+private:
+	FCriticalSection ImagesLock;
+	TArray<FImage> Images;
+	TMap<FString, int32> ImageIndices;
+};
@@ -0,0 +1,113 @@
+#include "DocGenOutputManifest.h"
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+const TCHAR* const FDocGenOutputManifest::ManifestFileName = TEXT("kantandocgen.manifest");
+
+TSharedPtr<FDocGenOutputManifest> FDocGenOutputManifest::Load(const FString& ManifestPath)
+{
+	TSharedPtr<FDocGenOutputManifest> Manifest = MakeShared<FDocGenOutputManifest>();
+	Manifest->ManifestPath = ManifestPath;
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ManifestPath))
+	{
+		return Manifest;
+	}
+	// One file per line: <hash as hex> <size> <absolute path>
+	for (const FString& Line : Lines)
+	{
+		int32 HashEnd = INDEX_NONE;
+		if (!Line.FindChar(TEXT(' '), HashEnd))
+		{
+			continue;
+		}
+		const int32 SizeEnd = Line.Find(TEXT(" "), ESearchCase::CaseSensitive, ESearchDir::FromStart, HashEnd + 1);
+		if (SizeEnd == INDEX_NONE)
+		{
+			continue;
+		}
+		FEntry Entry;
+		Entry.Hash = FCString::Strtoui64(*Line.Left(HashEnd), nullptr, 16);
+		Entry.Size = FCString::Atoi64(*Line.Mid(HashEnd + 1, SizeEnd - HashEnd - 1));
+		Manifest->Entries.Add(Line.Mid(SizeEnd + 1), Entry);
+	}
+	return Manifest;
+}
+
+uint64 FDocGenOutputManifest::HashBytes(const uint8* Data, int64 Size)
+{
+	return CityHash64(reinterpret_cast<const char*>(Data), Size);
+}
+
+bool FDocGenOutputManifest::IsUnchanged(const FString& FilePath, uint64 ContentHash)
+{
+	{
+		FScopeLock Lock(&EntriesLock);
+		FEntry* Entry = Entries.Find(FilePath);
+		if (!Entry || Entry->Hash != ContentHash)
+		{
+			return false;
+		}
+	}
+	// The file may have been deleted or edited since it was recorded, and a size check catches nearly all of that
+	// without reading it back
+	const int64 SizeOnDisk = IFileManager::Get().FileSize(*FilePath);
+
+	FScopeLock Lock(&EntriesLock);
+	FEntry& Entry = Entries.FindChecked(FilePath);
+	if (SizeOnDisk != Entry.Size)
+	{
+		return false;
+	}
+	Entry.bProducedThisRun = true;
+	SkippedCount.Increment();
+	return true;
+}
+
+void FDocGenOutputManifest::RecordWrite(const FString& FilePath, uint64 ContentHash)
+{
+	const int64 SizeOnDisk = IFileManager::Get().FileSize(*FilePath);
+
+	FScopeLock Lock(&EntriesLock);
+	FEntry& Entry = Entries.FindOrAdd(FilePath);
+	Entry.Hash = ContentHash;
+	Entry.Size = SizeOnDisk;
+	Entry.bProducedThisRun = true;
+	WrittenCount.Increment();
+}
+
+void FDocGenOutputManifest::RemoveStaleFiles()
+{
+	FScopeLock Lock(&EntriesLock);
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().bProducedThisRun)
+		{
+			IFileManager::Get().Delete(*It.Key(), false, true, true);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FDocGenOutputManifest::Save()
+{
+	FScopeLock Lock(&EntriesLock);
+	// Entries are recorded in whatever order the write threads finish, sort so the manifest itself is stable
+	Entries.KeySort([](const FString& A, const FString& B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; });
+	FString Contents;
+	for (const auto& Entry : Entries)
+	{
+		Contents += FString::Printf(TEXT("%016llx %lld %s") LINE_TERMINATOR, Entry.Value.Hash, Entry.Value.Size,
+									*Entry.Key);
+	}
+	if (!FFileHelper::SaveStringToFile(Contents, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save output manifest %s"), *ManifestPath);
+		return false;
+	}
+	return true;
+}
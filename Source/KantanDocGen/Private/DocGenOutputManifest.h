@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Sidecar record of the content hash of every file a previous run wrote. Lets writers skip files whose
+/// content hasn't changed, so unchanged documents keep their timestamps and downstream syncs don't reprocess them.
+/// All members are safe to call from any thread.
+class FDocGenOutputManifest
+{
+public:
+	static const TCHAR* const ManifestFileName;
+
+	/// @brief Loads the manifest written by a previous run
+	/// @return the manifest, empty if no previous manifest exists or it couldn't be read
+	static TSharedPtr<FDocGenOutputManifest> Load(const FString& ManifestPath);
+
+	static uint64 HashBytes(const uint8* Data, int64 Size);
+
+	/// @brief Checks whether FilePath already holds content with the given hash. A file that is still up to date
+	/// counts as produced by this run and as skipped.
+	/// @return true if writing the content again can be skipped
+	bool IsUnchanged(const FString& FilePath, uint64 ContentHash);
+
+	/// @brief Records that FilePath was just written with content of the given hash
+	void RecordWrite(const FString& FilePath, uint64 ContentHash);
+
+	/// @brief Deletes files a previous run wrote that this run didn't produce. Only call after a complete run,
+	/// otherwise files that simply weren't reached yet would be deleted.
+	void RemoveStaleFiles();
+
+	/// @brief Writes the manifest back to the location it was loaded from
+	bool Save();
+
+	int32 GetWrittenCount() const
+	{
+		return WrittenCount.GetValue();
+	}
+	int32 GetSkippedCount() const
+	{
+		return SkippedCount.GetValue();
+	}
+
+private:
+	struct FEntry
+	{
+		uint64 Hash = 0;
+		int64 Size = 0;
+		bool bProducedThisRun = false;
+	};
+
+	FCriticalSection EntriesLock;
+	TMap<FString, FEntry> Entries;
+	FString ManifestPath;
+	FThreadSafeCounter WrittenCount;
+	FThreadSafeCounter SkippedCount;
+};
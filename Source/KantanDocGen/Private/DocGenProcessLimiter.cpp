@@ -0,0 +1,50 @@
+#include "DocGenProcessLimiter.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+FDocGenProcessLimiter::FDocGenProcessLimiter(int32 MaxProcesses, double ProcessTimeoutSeconds)
+	: MaxProcesses(MaxProcesses),
+	  ProcessTimeoutSeconds(ProcessTimeoutSeconds)
+{
+	if (this->MaxProcesses <= 0)
+	{
+		// The tools are single threaded for the most part, leave some cores for the editor
+		this->MaxProcesses = FMath::Max(1, FPlatformMisc::NumberOfCores() / 2);
+	}
+	SlotReleasedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FDocGenProcessLimiter::~FDocGenProcessLimiter()
+{
+	FPlatformProcess::ReturnSynchEventToPool(SlotReleasedEvent);
+}
+
+void FDocGenProcessLimiter::Acquire()
+{
+	while (true)
+	{
+		{
+			FScopeLock Lock(&SlotsLock);
+			// Once cancelled the holder gives up straight away, no point in making it wait for a slot first
+			if (UsedSlots < MaxProcesses || bCancelRequested)
+			{
+				++UsedSlots;
+				return;
+			}
+		}
+		// Several processors may be waiting on the auto-reset event, so don't rely on being the one woken
+		SlotReleasedEvent->Wait(10);
+	}
+}
+
+void FDocGenProcessLimiter::Release()
+{
+	{
+		FScopeLock Lock(&SlotsLock);
+		check(UsedSlots > 0);
+		--UsedSlots;
+	}
+	SlotReleasedEvent->Trigger();
+}
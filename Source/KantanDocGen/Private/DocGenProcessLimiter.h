@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Caps how many external tools (convert.exe, ruby, npm, the XML tool) output processors run at once. Formats
+/// are processed concurrently and each spends most of its time in child processes, this keeps them from all hitting
+/// the CPU and disk together. Also carries the timeout and cancellation every FDocGenChildProcess of a task follows.
+class FDocGenProcessLimiter
+{
+public:
+	/// @param MaxProcesses number of child processes allowed to run at once, 0 picks a default based on the core count
+	/// @param ProcessTimeoutSeconds child processes still running after this long are terminated, 0 for no limit
+	explicit FDocGenProcessLimiter(int32 MaxProcesses = 0, double ProcessTimeoutSeconds = 0.0);
+	~FDocGenProcessLimiter();
+
+	/// @brief Blocks until a process slot is available and takes it
+	void Acquire();
+	void Release();
+
+	int32 GetMaxProcesses() const
+	{
+		return MaxProcesses;
+	}
+
+	double GetProcessTimeoutSeconds() const
+	{
+		return ProcessTimeoutSeconds;
+	}
+
+	/// @brief Makes running child processes terminate and new ones fail to start
+	void RequestCancel()
+	{
+		bCancelRequested = true;
+	}
+
+	bool IsCancelRequested() const
+	{
+		return bCancelRequested;
+	}
+
+private:
+	FCriticalSection SlotsLock;
+	FEvent* SlotReleasedEvent = nullptr;
+	int32 UsedSlots = 0;
+	int32 MaxProcesses;
+	double ProcessTimeoutSeconds;
+	FThreadSafeBool bCancelRequested;
+};
+
+/// @brief Holds a slot of the limiter for as long as it's in scope, does nothing without a limiter so processors used
+/// outside of a task aren't limited
+class FDocGenScopedProcessSlot
+{
+public:
+	explicit FDocGenScopedProcessSlot(const TSharedPtr<FDocGenProcessLimiter>& InLimiter) : Limiter(InLimiter)
+	{
+		if (Limiter)
+		{
+			Limiter->Acquire();
+		}
+	}
+	~FDocGenScopedProcessSlot()
+	{
+		if (Limiter)
+		{
+			Limiter->Release();
+		}
+	}
+
+private:
+	TSharedPtr<FDocGenProcessLimiter> Limiter;
+};
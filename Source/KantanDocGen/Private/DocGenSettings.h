@@ -63,11 +63,62 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Output")
 	bool bCleanOutputDirectory;
 
+	/** Write json intermediate documents in a compact binary encoding which output processors read without parsing. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bBinaryIntermediates;
+
+	/** Append json intermediate documents to a single pack file instead of writing one file per document. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bPackIntermediateFiles;
+
+	/** Compress each document stored in the intermediate pack. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay, Meta = (EditCondition = "bPackIntermediateFiles"))
+	bool bCompressIntermediatePack;
+
+	/** Keep intermediate files between runs and only rewrite files whose content changed, preserving timestamps. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bSkipUnchangedFiles;
+
+	/** Write the consolidated json document without indentation or line breaks, for when nobody reads it directly. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bCompactConsolidatedJson;
+
+	/** Store long strings in the consolidated json document once and refer to them by index everywhere else. Output
+	 * formats resolve the references when they read the document. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	bool bConsolidatedStringTable;
+
+	/** Metadata keys documented for classes, functions and fields, as wildcard patterns such as "Display*" matched
+	 * ignoring case. Every key is documented when the list is empty. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	TArray<FString> MetaDataIncludePatterns;
+
+	/** Metadata keys never documented, even when they match an include pattern, such as "ModuleRelativePath". */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay)
+	TArray<FString> MetaDataExcludePatterns;
+
+	/** Maximum number of conversion tools run at once, as all output formats are processed in parallel. 0 picks a
+	 * default based on the core count. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay, Meta = (ClampMin = "0"))
+	int32 MaxConcurrentProcesses;
+
+	/** Conversion tools still running after this many seconds are terminated and their format fails. 0 for no limit. */
+	UPROPERTY(EditAnywhere, Category = "Output", AdvancedDisplay, Meta = (ClampMin = "0"))
+	float ProcessTimeoutSeconds;
+
 public:
 	FKantanDocGenSettings()
 	{
 		BlueprintContextClass = AActor::StaticClass();
 		bCleanOutputDirectory = false;
+		bBinaryIntermediates = false;
+		bPackIntermediateFiles = false;
+		bCompressIntermediatePack = false;
+		bSkipUnchangedFiles = false;
+		bCompactConsolidatedJson = false;
+		bConsolidatedStringTable = false;
+		MaxConcurrentProcesses = 0;
+		ProcessTimeoutSeconds = 0.0f;
 	}
 
 	bool HasAnySources() const
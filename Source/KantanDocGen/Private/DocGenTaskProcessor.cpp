@@ -9,6 +9,9 @@
 #include "Async/TaskGraphInterfaces.h"
 #include "BlueprintActionDatabase.h"
 #include "BlueprintNodeSpawner.h"
+#include "DocGenDirectoryCleaner.h"
+#include "DocGenOutputManifest.h"
+#include "DocGenProcessLimiter.h"
 #include "Enumeration/CompositeEnumerator.h"
 #include "Enumeration/ContentPathEnumerator.h"
 #include "Enumeration/ISourceObjectEnumerator.h"
@@ -20,14 +23,63 @@
 #include "K2Node.h"
 #include "KantanDocGenLog.h"
 #include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Optional.h"
 #include "NodeDocsGenerator.h"
+#include "OutputFormats/DocGenConsolidator.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
+#include "OutputFormats/DocGenParsedDocumentCache.h"
 #include "ThreadingHelpers.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
 #define LOCTEXT_NAMESPACE "KantanDocGen"
 
+namespace
+{
+	/// @brief Moves everything a format wrote into its staging directory over to the output directory, replacing
+	/// files that are already there
+	/// @param Manifest when set, files the output already holds with the same content are left alone, and files that
+	/// are moved are recorded under their output path
+	bool MergeStagedOutput(const FString& StagingDir, const FString& OutputDir, FDocGenOutputManifest* Manifest)
+	{
+		TArray<FString> StagedFiles;
+		IFileManager::Get().FindFilesRecursive(StagedFiles, *StagingDir, TEXT("*"), true, false);
+		bool bMergedAll = true;
+		for (const FString& StagedFile : StagedFiles)
+		{
+			FString RelativePath = StagedFile;
+			verify(FPaths::MakePathRelativeTo(RelativePath, *(StagingDir / TEXT(""))));
+			const FString Destination = OutputDir / RelativePath;
+			TOptional<uint64> ContentHash;
+			if (Manifest)
+			{
+				TArray<uint8> Bytes;
+				if (FFileHelper::LoadFileToArray(Bytes, *StagedFile))
+				{
+					ContentHash = FDocGenOutputManifest::HashBytes(Bytes.GetData(), Bytes.Num());
+					if (Manifest->IsUnchanged(Destination, ContentHash.GetValue()))
+					{
+						continue;
+					}
+				}
+			}
+			// Moving is a rename while both are on the same volume, copy when they aren't
+			if (!IFileManager::Get().Move(*Destination, *StagedFile, true, true, false, true) &&
+				IFileManager::Get().Copy(*Destination, *StagedFile, true, true) != COPY_OK)
+			{
+				UE_LOG(LogKantanDocGen, Error, TEXT("Failed to move %s to %s"), *StagedFile, *Destination);
+				bMergedAll = false;
+			}
+			else if (Manifest && ContentHash.IsSet())
+			{
+				Manifest->RecordWrite(Destination, ContentHash.GetValue());
+			}
+		}
+		return bMergedAll;
+	}
+} // namespace
+
 FDocGenTaskProcessor::FDocGenTaskProcessor()
 {
 	bRunning = false;
@@ -60,6 +112,9 @@ uint32 FDocGenTaskProcessor::Run()
 	{
 		ProcessTask(Next);
 	}
+	// Old trees may still be being deleted, don't report done while they are as the editor or commandlet could exit
+	// and cut them off
+	FDocGenDirectoryCleaner::WaitForBackgroundDeletes();
 
 	return 0;
 }
@@ -181,7 +236,10 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 
 		if (!Result)
 		{
-			Current->Task->NotifySetText(LOCTEXT("DocFinalizationFailed", "Doc gen failed"));
+			Current->Task->NotifySetText(
+				Current->DocGen->HasWriteFailure()
+					? LOCTEXT("DocFinalizationWriteFailed", "Doc gen failed - Could not write intermediate files")
+					: LOCTEXT("DocFinalizationFailed", "Doc gen failed"));
 			Current->Task->NotifySetCompletionState(SNotificationItem::CS_Fail);
 			Current->Task->NotifyExpireFadeOut();
 			// GEditor->PlayEditorSound(CompileSuccessSound);
@@ -202,7 +260,20 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 	EnqueueEnumeratorsResult.Get();
 
 	// Initialize the doc generator
-	Current->DocGen = MakeUnique<FNodeDocsGenerator>(Current->Task->Settings.OutputFormats);
+	TSharedPtr<FDocGenOutputManifest> OutputManifest;
+	if (Current->Task->Settings.bSkipUnchangedFiles)
+	{
+		OutputManifest = FDocGenOutputManifest::Load(IntermediateDir / FDocGenOutputManifest::ManifestFileName);
+	}
+	// Unchanged files are only skipped if the previous run's files are still there to compare against, and the
+	// directory has to be cleaned before GT_Init creates anything in it. The previous run's files are deleted in the
+	// background while generation runs.
+	bool const bCleanIntermediate = !OutputManifest;
+	if (bCleanIntermediate)
+	{
+		FDocGenDirectoryCleaner::Delete(IntermediateDir);
+	}
+	Current->DocGen = MakeUnique<FNodeDocsGenerator>(Current->Task->Settings, OutputManifest);
 
 	auto InitDocGenResult = Async(
 		EAsyncExecution::TaskGraphMainThread, [GameThread_InitDocGen, Current = this->Current, IntermediateDir]() {
@@ -215,12 +286,6 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 
-	bool const bCleanIntermediate = true;
-	if (bCleanIntermediate)
-	{
-		IFileManager::Get().DeleteDirectory(*IntermediateDir, false, true);
-	}
-
 	for (auto const& Name : Current->Task->Settings.ExcludedClasses)
 	{
 		Current->Excluded.Add(Name);
@@ -291,6 +356,7 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 		return;
 	}
 	UE_LOG(LogKantanDocGen, Log, TEXT("Created %i nodes to document!"), SuccessfulNodeCount)
+	Current->DocGen->LogMetaDataReport();
 
 	// Game thread: DocGen.GT_Finalize()
 	auto FinalizeResult = Async(EAsyncExecution::TaskGraphMainThread, [GameThread_FinalizeDocs, IntermediateDir]() {
@@ -306,28 +372,128 @@ void FDocGenTaskProcessor::ProcessTask(TSharedPtr<FDocGenTask> InTask)
 
 	if (Current->Task->Settings.bCleanOutputDirectory)
 	{
-		TArray<FString> OutputDirectoryContents;
-		IFileManager::Get().FindFilesRecursive(OutputDirectoryContents, *Current->Task->Settings.OutputDirectory.Path,
-											   TEXT("*"), true, true, true);
-		for (const FString& DirectoryMember : OutputDirectoryContents)
-		{
-			IFileManager::Get().Delete(*DirectoryMember, false, true);
-		}
+		// Failures are logged, whatever is left is overwritten by the formats
+		FDocGenDirectoryCleaner::Clean(Current->Task->Settings.OutputDirectory.Path);
 	}
 
 	EIntermediateProcessingResult TransformationResult = Success;
+	// Shared so that formats reading the same intermediates parse each of them only once. Formats run on threads of
+	// their own, so that's only possible where json documents can be shared between threads.
+	TSharedPtr<FDocGenParsedDocumentCache> DocumentCache =
+		DocGenThreads::bThreadSafeJson ? MakeShared<FDocGenParsedDocumentCache>() : nullptr;
+	// Built by the first format that renders from consolidated.json and shared with the rest
+	TSharedPtr<FDocGenConsolidator> Consolidator;
+	EIntermediateProcessingResult ConsolidationResult = Success;
+	TSharedPtr<FDocGenProcessLimiter> ProcessLimiter = MakeShared<FDocGenProcessLimiter>(
+		Current->Task->Settings.MaxConcurrentProcesses, Current->Task->Settings.ProcessTimeoutSeconds);
+
+	struct FFormatRun
+	{
+		TSharedPtr<IDocGenOutputProcessor> Processor;
+		FString FormatIdentifier;
+		FString OutputDir;
+		TFuture<EIntermediateProcessingResult> Result;
+	};
+	TArray<FFormatRun> FormatRuns;
 	for (const auto& OutputFormatFactory : Current->Task->Settings.OutputFormats)
 	{
 		auto IntermediateProcessor = OutputFormatFactory->CreateIntermediateDocProcessor();
-		EIntermediateProcessingResult Result = IntermediateProcessor->ProcessIntermediateDocs(
-			IntermediateDir, Current->Task->Settings.OutputDirectory.Path, Current->Task->Settings.DocumentationTitle,
-			Current->Task->Settings.bCleanOutputDirectory);
+		IntermediateProcessor->SetDocModel(Current->DocGen->GetDocModel());
+		IntermediateProcessor->SetDocumentCache(DocumentCache);
+		IntermediateProcessor->SetProcessLimiter(ProcessLimiter);
+		if (IntermediateProcessor->UsesConsolidatedOutput())
+		{
+			if (!Consolidator)
+			{
+				Consolidator = MakeShared<FDocGenConsolidator>(IntermediateDir,
+															   Current->Task->Settings.OutputDirectory.Path,
+															   OutputManifest, Current->DocGen->GetDocModel(),
+															   DocumentCache);
+				Consolidator->SetCompactOutput(Current->Task->Settings.bCompactConsolidatedJson);
+				Consolidator->SetStringTable(Current->Task->Settings.bConsolidatedStringTable);
+				ConsolidationResult = Consolidator->Consolidate();
+			}
+			if (ConsolidationResult != EIntermediateProcessingResult::Success)
+			{
+				TransformationResult = ConsolidationResult;
+				continue;
+			}
+			IntermediateProcessor->SetConsolidator(Consolidator);
+		}
+		FormatRuns.Add({IntermediateProcessor, OutputFormatFactory->GetFormatIdentifier(),
+						Current->Task->Settings.OutputDirectory.Path});
+	}
+
+	// Every format writes into the output directory, some of them clean or replace whole trees in it. When several
+	// run at once each gets a staging directory of its own, merged into the output in format order afterwards so the
+	// result is the same as running them one after the other. Staged output is checked against the manifest while
+	// merging instead, so it's recorded under the output paths and unchanged files keep their timestamps.
+	const bool bStageFormatOutput = FormatRuns.Num() > 1;
+	for (int32 RunIndex = 0; RunIndex < FormatRuns.Num(); ++RunIndex)
+	{
+		FFormatRun& Run = FormatRuns[RunIndex];
+		Run.Processor->SetOutputManifest(bStageFormatOutput ? TSharedPtr<FDocGenOutputManifest>() : OutputManifest);
+		if (bStageFormatOutput)
+		{
+			Run.OutputDir = IntermediateDir / TEXT("staging") /
+							FString::Printf(TEXT("%d_%s"), RunIndex, *Run.FormatIdentifier);
+			FDocGenDirectoryCleaner::Clean(Run.OutputDir);
+		}
+		// The processors spend most of their time waiting on child processes, so each gets a thread rather than
+		// tying up task graph workers
+		Run.Result = Async(EAsyncExecution::Thread,
+						   [Processor = Run.Processor, IntermediateDir, OutputDir = Run.OutputDir,
+							DocTitle = Current->Task->Settings.DocumentationTitle,
+							bCleanOutput = Current->Task->Settings.bCleanOutputDirectory]() {
+							   return Processor->ProcessIntermediateDocs(IntermediateDir, OutputDir, DocTitle,
+																		 bCleanOutput);
+						   });
+	}
 
+	for (FFormatRun& Run : FormatRuns)
+	{
+		// Stopping the processor terminates the tools still running rather than waiting them out
+		while (!Run.Result.WaitFor(FTimespan::FromMilliseconds(100)))
+		{
+			if (bTerminationRequest)
+			{
+				ProcessLimiter->RequestCancel();
+			}
+		}
+		EIntermediateProcessingResult Result = Run.Result.Get();
 		if (Result != EIntermediateProcessingResult::Success)
 		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Processing %s output failed"), *Run.FormatIdentifier);
 			TransformationResult = Result;
 		}
 		// Don't abort after performing one transformation, as others may succeed
+		if (bStageFormatOutput &&
+			!MergeStagedOutput(Run.OutputDir, Current->Task->Settings.OutputDirectory.Path, OutputManifest.Get()) &&
+			Result == EIntermediateProcessingResult::Success)
+		{
+			TransformationResult = EIntermediateProcessingResult::DiskWriteFailure;
+		}
+	}
+	if (bStageFormatOutput)
+	{
+		FDocGenDirectoryCleaner::Delete(IntermediateDir / TEXT("staging"));
+	}
+
+	if (OutputManifest)
+	{
+		UE_LOG(LogKantanDocGen, Log, TEXT("Wrote %d files, skipped %d unchanged files"),
+			   OutputManifest->GetWrittenCount(), OutputManifest->GetSkippedCount());
+		// A failed run may not have reached every file, so only a complete run can tell which ones are stale
+		if (TransformationResult == EIntermediateProcessingResult::Success)
+		{
+			OutputManifest->RemoveStaleFiles();
+		}
+		OutputManifest->Save();
+	}
+	if (DocumentCache)
+	{
+		UE_LOG(LogKantanDocGen, Log, TEXT("Intermediate document cache: %d hits, %d misses"),
+			   DocumentCache->GetHitCount(), DocumentCache->GetMissCount());
 	}
 
 	if (TransformationResult != EIntermediateProcessingResult::Success)
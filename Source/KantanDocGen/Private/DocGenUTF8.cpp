@@ -0,0 +1,316 @@
+#include "DocGenUTF8.h"
+#include "KantanDocGenLog.h"
+#include "Misc/EngineVersionComparison.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <emmintrin.h>
+	#define DOCGEN_UTF8_SSE2 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_64BITS
+	#include <arm_neon.h>
+	#define DOCGEN_UTF8_NEON 1
+#endif
+#ifndef DOCGEN_UTF8_SSE2
+	#define DOCGEN_UTF8_SSE2 0
+#endif
+#ifndef DOCGEN_UTF8_NEON
+	#define DOCGEN_UTF8_NEON 0
+#endif
+
+namespace
+{
+	constexpr uint32 ReplacementCharacter = 0xFFFD;
+
+	// Buffers are sized for the worst case up front and only trimmed to what was written
+#if UE_VERSION_OLDER_THAN(5, 5, 0)
+	constexpr bool NoShrinking = false;
+#else
+	constexpr EAllowShrinking NoShrinking = EAllowShrinking::No;
+#endif
+
+	/// @brief Copies the ASCII characters at the start of Text to Dest as bytes
+	/// @return how many characters were copied
+	int32 EncodeAsciiRun(const TCHAR* Text, int32 Len, uint8*& Dest)
+	{
+		int32 Count = 0;
+		// The vector paths narrow 16 bit code units, TCHAR is wider on some platforms
+		if (sizeof(TCHAR) == 2)
+		{
+#if DOCGEN_UTF8_SSE2
+			const __m128i NonAsciiBits = _mm_set1_epi16(static_cast<int16>(0xFF80));
+			for (; Len - Count >= 8; Count += 8, Dest += 8)
+			{
+				const __m128i Units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Text + Count));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(Units, NonAsciiBits), _mm_setzero_si128())) !=
+					0xFFFF)
+				{
+					break;
+				}
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(Dest), _mm_packus_epi16(Units, Units));
+			}
+#elif DOCGEN_UTF8_NEON
+			for (; Len - Count >= 8; Count += 8, Dest += 8)
+			{
+				const uint16x8_t Units = vld1q_u16(reinterpret_cast<const uint16*>(Text + Count));
+				if (vmaxvq_u16(Units) >= 0x80)
+				{
+					break;
+				}
+				vst1_u8(Dest, vmovn_u16(Units));
+			}
+#endif
+		}
+		for (; Count < Len && static_cast<uint32>(Text[Count]) < 0x80; ++Count)
+		{
+			*Dest++ = static_cast<uint8>(Text[Count]);
+		}
+		return Count;
+	}
+
+	void EncodeCodePoint(uint32 CodePoint, uint8*& Dest)
+	{
+		if (CodePoint < 0x80)
+		{
+			*Dest++ = static_cast<uint8>(CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			*Dest++ = static_cast<uint8>(0xC0 | (CodePoint >> 6));
+			*Dest++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			*Dest++ = static_cast<uint8>(0xE0 | (CodePoint >> 12));
+			*Dest++ = static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F));
+			*Dest++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+		}
+		else
+		{
+			*Dest++ = static_cast<uint8>(0xF0 | (CodePoint >> 18));
+			*Dest++ = static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F));
+			*Dest++ = static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F));
+			*Dest++ = static_cast<uint8>(0x80 | (CodePoint & 0x3F));
+		}
+	}
+
+	/// @brief Copies the ASCII bytes at the start of [Current, End) to Dest as characters
+	void DecodeAsciiRun(const uint8*& Current, const uint8* End, TCHAR*& Dest)
+	{
+		if (sizeof(TCHAR) == 2)
+		{
+#if DOCGEN_UTF8_SSE2
+			const __m128i Zero = _mm_setzero_si128();
+			for (; End - Current >= 16; Current += 16, Dest += 16)
+			{
+				const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Current));
+				if (_mm_movemask_epi8(Bytes) != 0)
+				{
+					break;
+				}
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest), _mm_unpacklo_epi8(Bytes, Zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + 8), _mm_unpackhi_epi8(Bytes, Zero));
+			}
+#elif DOCGEN_UTF8_NEON
+			for (; End - Current >= 16; Current += 16, Dest += 16)
+			{
+				const uint8x16_t Bytes = vld1q_u8(Current);
+				if (vmaxvq_u8(Bytes) >= 0x80)
+				{
+					break;
+				}
+				vst1q_u16(reinterpret_cast<uint16*>(Dest), vmovl_u8(vget_low_u8(Bytes)));
+				vst1q_u16(reinterpret_cast<uint16*>(Dest + 8), vmovl_u8(vget_high_u8(Bytes)));
+			}
+#endif
+		}
+		while (Current < End && *Current < 0x80)
+		{
+			*Dest++ = static_cast<TCHAR>(*Current++);
+		}
+	}
+
+	/// @brief Decodes the code point starting at Current, which must be before End, and moves past it. A malformed
+	/// sequence decodes to the replacement character and only its lead byte is consumed.
+	uint32 DecodeCodePoint(const uint8*& Current, const uint8* End)
+	{
+		const uint8 Lead = *Current++;
+		uint32 CodePoint = 0;
+		uint32 MinCodePoint = 0;
+		int32 NumContinuationBytes = 0;
+		if (Lead < 0x80)
+		{
+			return Lead;
+		}
+		else if ((Lead & 0xE0) == 0xC0)
+		{
+			CodePoint = Lead & 0x1F;
+			MinCodePoint = 0x80;
+			NumContinuationBytes = 1;
+		}
+		else if ((Lead & 0xF0) == 0xE0)
+		{
+			CodePoint = Lead & 0x0F;
+			MinCodePoint = 0x800;
+			NumContinuationBytes = 2;
+		}
+		else if ((Lead & 0xF8) == 0xF0)
+		{
+			CodePoint = Lead & 0x07;
+			MinCodePoint = 0x10000;
+			NumContinuationBytes = 3;
+		}
+		else
+		{
+			return ReplacementCharacter;
+		}
+		const uint8* Continuation = Current;
+		for (int32 Index = 0; Index < NumContinuationBytes; ++Index, ++Continuation)
+		{
+			if (Continuation == End || (*Continuation & 0xC0) != 0x80)
+			{
+				return ReplacementCharacter;
+			}
+			CodePoint = (CodePoint << 6) | (*Continuation & 0x3F);
+		}
+		// Overlong encodings, surrogates and anything past the last code point
+		if (CodePoint < MinCodePoint || (CodePoint >= 0xD800 && CodePoint <= 0xDFFF) || CodePoint > 0x10FFFF)
+		{
+			return ReplacementCharacter;
+		}
+		Current = Continuation;
+		return CodePoint;
+	}
+} // namespace
+
+void DocGenUTF8::Append(TArray<uint8>& Out, const TCHAR* Text, int32 Len)
+{
+	if (Len <= 0)
+	{
+		return;
+	}
+	// A UTF-16 code unit encodes to at most 3 bytes, a surrogate pair to 4 for its 2 units
+	const int32 Start = Out.Num();
+	Out.AddUninitialized(Len * (sizeof(TCHAR) == 2 ? 3 : 4));
+	uint8* const DestStart = Out.GetData() + Start;
+	uint8* Dest = DestStart;
+	int32 Index = 0;
+	while (true)
+	{
+		Index += EncodeAsciiRun(Text + Index, Len - Index, Dest);
+		if (Index == Len)
+		{
+			break;
+		}
+		uint32 CodePoint = static_cast<uint32>(Text[Index++]);
+		if (CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+		{
+			const uint32 LowSurrogate = Index < Len ? static_cast<uint32>(Text[Index]) : 0;
+			if (sizeof(TCHAR) == 2 && CodePoint <= 0xDBFF && LowSurrogate >= 0xDC00 && LowSurrogate <= 0xDFFF)
+			{
+				CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+				++Index;
+			}
+			else
+			{
+				CodePoint = ReplacementCharacter;
+			}
+		}
+		else if (CodePoint > 0x10FFFF)
+		{
+			CodePoint = ReplacementCharacter;
+		}
+		EncodeCodePoint(CodePoint, Dest);
+	}
+	Out.SetNum(Start + static_cast<int32>(Dest - DestStart), NoShrinking);
+}
+
+int64 DocGenUTF8::EncodedLength(const TCHAR* Text, int32 Len)
+{
+	int64 Length = 0;
+	for (int32 Index = 0; Index < Len; ++Index)
+	{
+		const uint32 CodeUnit = static_cast<uint32>(Text[Index]);
+		if (CodeUnit < 0x80)
+		{
+			Length += 1;
+		}
+		else if (CodeUnit < 0x800)
+		{
+			Length += 2;
+		}
+		else if (sizeof(TCHAR) == 2 && CodeUnit >= 0xD800 && CodeUnit <= 0xDBFF && Index + 1 < Len &&
+				 static_cast<uint32>(Text[Index + 1]) >= 0xDC00 && static_cast<uint32>(Text[Index + 1]) <= 0xDFFF)
+		{
+			Length += 4;
+			++Index;
+		}
+		else if (CodeUnit < 0x10000 || CodeUnit > 0x10FFFF)
+		{
+			// Lone surrogates and values past the last code point are written as the replacement character
+			Length += 3;
+		}
+		else
+		{
+			Length += 4;
+		}
+	}
+	return Length;
+}
+
+TArray<uint8> DocGenUTF8::FromString(const FString& Text)
+{
+	TArray<uint8> Bytes;
+	Append(Bytes, Text);
+	return Bytes;
+}
+
+FString DocGenUTF8::ToString(const uint8* Data, int64 Len)
+{
+	if (Len <= 0)
+	{
+		return FString();
+	}
+	if (Len >= MAX_int32)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Can't decode %lld bytes of text into a single string"), Len);
+		return FString();
+	}
+	FString Result;
+	TArray<TCHAR>& Chars = Result.GetCharArray();
+	// No sequence decodes to more code units than it has bytes, plus the terminator
+	Chars.SetNumUninitialized(static_cast<int32>(Len) + 1);
+	TCHAR* const DestStart = Chars.GetData();
+	TCHAR* Dest = DestStart;
+	const uint8* Current = Data;
+	const uint8* const End = Data + Len;
+	while (true)
+	{
+		DecodeAsciiRun(Current, End, Dest);
+		if (Current == End)
+		{
+			break;
+		}
+		const uint32 CodePoint = DecodeCodePoint(Current, End);
+		if (sizeof(TCHAR) == 2 && CodePoint >= 0x10000)
+		{
+			*Dest++ = static_cast<TCHAR>(0xD800 + ((CodePoint - 0x10000) >> 10));
+			*Dest++ = static_cast<TCHAR>(0xDC00 + ((CodePoint - 0x10000) & 0x3FF));
+		}
+		else
+		{
+			*Dest++ = static_cast<TCHAR>(CodePoint);
+		}
+	}
+	*Dest = TEXT('\0');
+	Chars.SetNum(static_cast<int32>(Dest - DestStart) + 1, NoShrinking);
+	return Result;
+}
+
+FString DocGenUTF8::BufferToString(const uint8* Data, int64 Len)
+{
+	if (Len >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Data += 3;
+		Len -= 3;
+	}
+	return ToString(Data, Len);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+
+/// @brief Conversion between TCHAR strings and the UTF-8 every generated file is written in. Runs of ASCII, which is
+/// nearly all documentation text, are converted 8 or 16 characters at a time with SSE2 or NEON, only the remaining
+/// characters go through the per code point path. Lone surrogates and malformed UTF-8 become U+FFFD rather than
+/// failing the conversion.
+namespace DocGenUTF8
+{
+	/// @brief Appends Len characters of Text encoded as UTF-8, without a terminator
+	void Append(TArray<uint8>& Out, const TCHAR* Text, int32 Len);
+
+	inline void Append(TArray<uint8>& Out, const FString& Text)
+	{
+		Append(Out, *Text, Text.Len());
+	}
+
+	/// @return how many bytes Append would add for Len characters of Text
+	int64 EncodedLength(const TCHAR* Text, int32 Len);
+
+	inline int64 EncodedLength(const FString& Text)
+	{
+		return EncodedLength(*Text, Text.Len());
+	}
+
+	/// @return Text encoded as UTF-8, without a terminator
+	TArray<uint8> FromString(const FString& Text);
+
+	/// @brief Decodes Len bytes of UTF-8
+	FString ToString(const uint8* Data, int64 Len);
+
+	/// @brief Decodes the contents of a UTF-8 file, skipping a byte order mark if it starts with one
+	FString BufferToString(const uint8* Data, int64 Len);
+} // namespace DocGenUTF8
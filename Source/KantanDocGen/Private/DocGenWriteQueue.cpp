@@ -0,0 +1,226 @@
+#include "DocGenWriteQueue.h"
+#include "DocGenDirectoryRegistry.h"
+#include "DocGenOutputManifest.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+FDocGenWriteQueue::FDocGenWriteQueue(int32 NumThreads, int64 MaxPendingBytes) : MaxPendingBytes(MaxPendingBytes)
+{
+	WorkAvailableEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	CapacityEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	IdleEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	IdleEvent->Trigger();
+
+	if (NumThreads <= 0)
+	{
+		// Writes are mostly waiting on the disk, a couple of threads is enough to keep it busy
+		NumThreads = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads() / 4, 1, 4);
+	}
+	for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+	{
+		TUniquePtr<FWorker>& Worker = Workers.Add_GetRef(MakeUnique<FWorker>(*this));
+		Threads.Emplace(FRunnableThread::Create(Worker.Get(),
+												*FString::Printf(TEXT("DocGenWriteQueue%d"), ThreadIndex), 0,
+												TPri_BelowNormal));
+	}
+}
+
+FDocGenWriteQueue::~FDocGenWriteQueue()
+{
+	Flush();
+
+	bStopping = true;
+	WorkAvailableEvent->Trigger();
+	for (TUniquePtr<FRunnableThread>& Thread : Threads)
+	{
+		if (Thread)
+		{
+			Thread->WaitForCompletion();
+		}
+	}
+	Threads.Empty();
+	Workers.Empty();
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkAvailableEvent);
+	FPlatformProcess::ReturnSynchEventToPool(CapacityEvent);
+	FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+}
+
+void FDocGenWriteQueue::EnqueueWrite(const FString& FilePath, TArray<uint8>&& Bytes)
+{
+	const int64 CostBytes = Bytes.Num();
+	EnqueueTask(FilePath, CostBytes,
+				[FilePath, Bytes = MoveTemp(Bytes), Manifest = Manifest, Directories = Directories]() {
+					auto SaveBytes = [&]() {
+						return Directories ? Directories->SaveArrayToFile(Bytes, FilePath)
+										   : FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+					};
+					if (!Manifest)
+					{
+						return SaveBytes();
+					}
+					const uint64 ContentHash = FDocGenOutputManifest::HashBytes(Bytes.GetData(), Bytes.Num());
+					if (Manifest->IsUnchanged(FilePath, ContentHash))
+					{
+						return true;
+					}
+					if (!SaveBytes())
+					{
+						return false;
+					}
+					Manifest->RecordWrite(FilePath, ContentHash);
+					return true;
+				});
+}
+
+void FDocGenWriteQueue::EnqueueCopy(const FString& DestinationPath, const FString& SourcePath, bool bFailureIsError)
+{
+	EnqueueTask(DestinationPath, 0, [DestinationPath, SourcePath, bFailureIsError, Manifest = Manifest]() {
+		bool bCopied = false;
+		if (!Manifest)
+		{
+			bCopied = IFileManager::Get().Copy(*DestinationPath, *SourcePath, true) == COPY_OK;
+		}
+		else
+		{
+			// The source has to be read to hash it, so write those bytes rather than copying
+			TArray<uint8> Bytes;
+			if (FFileHelper::LoadFileToArray(Bytes, *SourcePath))
+			{
+				const uint64 ContentHash = FDocGenOutputManifest::HashBytes(Bytes.GetData(), Bytes.Num());
+				if (Manifest->IsUnchanged(DestinationPath, ContentHash))
+				{
+					return true;
+				}
+				bCopied = FFileHelper::SaveArrayToFile(Bytes, *DestinationPath);
+				if (bCopied)
+				{
+					Manifest->RecordWrite(DestinationPath, ContentHash);
+				}
+			}
+		}
+		if (bCopied)
+		{
+			return true;
+		}
+		if (!bFailureIsError)
+		{
+			UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to copy %s to %s"), *SourcePath, *DestinationPath);
+		}
+		return !bFailureIsError;
+	});
+}
+
+void FDocGenWriteQueue::EnqueueTaskIfChanged(const FString& FilePath, uint64 ContentHash, int64 CostBytes,
+											  TUniqueFunction<bool()>&& Operation, bool bFailureIsError,
+											  TUniqueFunction<void(bool)>&& OnCompleted)
+{
+	EnqueueTask(FilePath, CostBytes,
+				[FilePath, ContentHash, Operation = MoveTemp(Operation), bFailureIsError,
+				 OnCompleted = MoveTemp(OnCompleted), Manifest = Manifest]() {
+					bool bUpToDate = Manifest && Manifest->IsUnchanged(FilePath, ContentHash);
+					if (!bUpToDate)
+					{
+						bUpToDate = Operation();
+						if (!bUpToDate && !bFailureIsError)
+						{
+							UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to write %s"), *FilePath);
+						}
+						// Failures aren't recorded either way, so the next run tries again
+						if (bUpToDate && Manifest)
+						{
+							Manifest->RecordWrite(FilePath, ContentHash);
+						}
+					}
+					if (OnCompleted)
+					{
+						OnCompleted(bUpToDate);
+					}
+					return bUpToDate || !bFailureIsError;
+				});
+}
+
+void FDocGenWriteQueue::EnqueueTask(const FString& Description, int64 CostBytes, TUniqueFunction<bool()>&& Operation)
+{
+	WaitForCapacity(CostBytes);
+
+	PendingBytes.Add(CostBytes);
+	if (OutstandingOperations.Increment() == 1)
+	{
+		IdleEvent->Reset();
+	}
+	Pending.Enqueue({Description, CostBytes, MoveTemp(Operation)});
+	WorkAvailableEvent->Trigger();
+}
+
+bool FDocGenWriteQueue::Flush()
+{
+	while (OutstandingOperations.GetValue() > 0)
+	{
+		IdleEvent->Wait();
+	}
+	return FailedOperations.Reset() == 0;
+}
+
+void FDocGenWriteQueue::WaitForCapacity(int64 CostBytes)
+{
+	// A single oversized buffer is let through on an empty queue rather than blocking forever
+	while (PendingBytes.GetValue() > 0 && PendingBytes.GetValue() + CostBytes > MaxPendingBytes)
+	{
+		// Several producers may be waiting on the auto-reset event, so don't rely on being the one woken
+		CapacityEvent->Wait(10);
+	}
+}
+
+bool FDocGenWriteQueue::DequeueOperation(FPendingOperation& OutOperation)
+{
+	FScopeLock Lock(&DequeueLock);
+	if (!Pending.Dequeue(OutOperation))
+	{
+		return false;
+	}
+	// Triggers coalesce while nobody is waiting, pass the wake up on so idle workers help drain a backlog
+	if (!Pending.IsEmpty())
+	{
+		WorkAvailableEvent->Trigger();
+	}
+	return true;
+}
+
+uint32 FDocGenWriteQueue::FWorker::Run()
+{
+	while (true)
+	{
+		FPendingOperation Operation;
+		if (!Owner.DequeueOperation(Operation))
+		{
+			if (Owner.bStopping)
+			{
+				// Wake the next worker so it sees the stop request too
+				Owner.WorkAvailableEvent->Trigger();
+				break;
+			}
+			Owner.WorkAvailableEvent->Wait();
+			continue;
+		}
+
+		if (!Operation.Operation())
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s"), *Operation.Description);
+			Owner.FailedOperations.Increment();
+		}
+
+		Owner.PendingBytes.Subtract(Operation.CostBytes);
+		Owner.CapacityEvent->Trigger();
+		if (Owner.OutstandingOperations.Decrement() == 0)
+		{
+			Owner.IdleEvent->Trigger();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Queue.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Templates/Function.h"
+
+/// @brief Write-behind queue for generated files. Producers hand off finished buffers (or whole write operations such
+/// as image encodes and copies) and carry on, a small pool of I/O threads performs the writes. Callers that need the
+/// files on disk call Flush, which also reports whether anything failed.
+class FDocGenWriteQueue
+{
+public:
+	/// @param NumThreads number of I/O threads, 0 picks a default based on the core count
+	/// @param MaxPendingBytes producers block once this many bytes are waiting to be written
+	explicit FDocGenWriteQueue(int32 NumThreads = 0, int64 MaxPendingBytes = 64 * 1024 * 1024);
+	~FDocGenWriteQueue();
+
+	/// @brief Queues a buffer to be written to FilePath, creating any missing directories
+	void EnqueueWrite(const FString& FilePath, TArray<uint8>&& Bytes);
+
+	/// @brief Queues a file copy
+	/// @param bFailureIsError whether a failed copy should make the next Flush fail, or only be logged
+	void EnqueueCopy(const FString& DestinationPath, const FString& SourcePath, bool bFailureIsError = true);
+
+	/// @brief Queues an arbitrary write operation
+	/// @param Description used when logging a failure
+	/// @param CostBytes approximate memory held by the operation, counted against MaxPendingBytes
+	/// @param Operation runs on an I/O thread, returns false on failure
+	void EnqueueTask(const FString& Description, int64 CostBytes, TUniqueFunction<bool()>&& Operation);
+
+	/// @brief Queues an operation producing FilePath, skipped if the manifest shows the file already holds content
+	/// with the given hash
+	/// @param bFailureIsError whether a failed operation should make the next Flush fail, or only be logged
+	/// @param OnCompleted runs on an I/O thread once the operation has run or been skipped, given whether the file now
+	/// holds the content, so callers can act on a single file without flushing the whole queue
+	void EnqueueTaskIfChanged(const FString& FilePath, uint64 ContentHash, int64 CostBytes,
+							  TUniqueFunction<bool()>&& Operation, bool bFailureIsError = true,
+							  TUniqueFunction<void(bool)>&& OnCompleted = nullptr);
+
+	/// @brief Once set, writes and copies whose content matches what the manifest recorded for the destination are
+	/// skipped, and everything written is recorded in it
+	void SetManifest(TSharedPtr<class FDocGenOutputManifest> InManifest)
+	{
+		Manifest = InManifest;
+	}
+
+	/// @brief Once set, buffers are written with directories created through the registry, rather than every write
+	/// checking each of its parent directories
+	void SetDirectoryRegistry(TSharedPtr<class FDocGenDirectoryRegistry> InDirectories)
+	{
+		Directories = InDirectories;
+	}
+
+	/// @brief Blocks until every queued operation has completed
+	/// @return false if any operation queued since the previous flush failed
+	bool Flush();
+
+private:
+	struct FPendingOperation
+	{
+		FString Description;
+		int64 CostBytes = 0;
+		TUniqueFunction<bool()> Operation;
+	};
+
+	class FWorker : public FRunnable
+	{
+	public:
+		FWorker(FDocGenWriteQueue& InOwner) : Owner(InOwner) {}
+		virtual uint32 Run() override;
+
+	private:
+		FDocGenWriteQueue& Owner;
+	};
+
+	void WaitForCapacity(int64 CostBytes);
+	bool DequeueOperation(FPendingOperation& OutOperation);
+
+	TQueue<FPendingOperation, EQueueMode::Mpsc> Pending;
+	// Pending is single consumer, workers take turns dequeuing
+	FCriticalSection DequeueLock;
+
+	FEvent* WorkAvailableEvent = nullptr;
+	FEvent* CapacityEvent = nullptr;
+	FEvent* IdleEvent = nullptr;
+
+	FThreadSafeCounter OutstandingOperations;
+	FThreadSafeCounter64 PendingBytes;
+	FThreadSafeCounter FailedOperations;
+	FThreadSafeBool bStopping;
+	int64 MaxPendingBytes;
+
+	TSharedPtr<FDocGenOutputManifest> Manifest;
+	TSharedPtr<FDocGenDirectoryRegistry> Directories;
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	TArray<TUniquePtr<class FRunnableThread>> Threads;
+};
@@ -6,10 +6,12 @@
 #include "Templates/SharedPointer.h"
 #include "VariantWrapper.h"
 
-class DocTreeNode : public TSharedFromThis<DocTreeNode>
+// Reference counted thread safely on every engine version, output formats serialize the same tree at once and
+// processors read it from threads of their own
+class DocTreeNode : public TSharedFromThis<DocTreeNode, ESPMode::ThreadSafe>
 {
 public:
-	using Object = TMultiMap<FString, TSharedPtr<DocTreeNode>>;
+	using Object = TMultiMap<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>;
 
 private:
 	struct NullValue
@@ -52,21 +54,21 @@ public:
 		return *StringPtr;
 	}
 
-	TSharedPtr<DocTreeNode> FindChildByName(const FString& ChildName)
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FindChildByName(const FString& ChildName)
 	{
 		Object* ObjPtr = Value.TryGet<Object>();
 		check(ObjPtr);
-		TSharedPtr<DocTreeNode>* FoundChild = ObjPtr->Find(ChildName);
+		TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>* FoundChild = ObjPtr->Find(ChildName);
 		if (FoundChild != nullptr)
 		{
 			return *FoundChild;
 		}
 		else
 		{
-			return TSharedPtr<DocTreeNode>();
+			return TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>();
 		}
 	}
-	TSharedPtr<DocTreeNode> AppendChild(const FString& ChildName)
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> AppendChild(const FString& ChildName)
 	{
 		if (CurrentDataType == InternalDataType::Null)
 		{
@@ -75,54 +77,125 @@ public:
 		}
 		auto ObjPtr = Value.TryGet<Object>();
 		check(ObjPtr);
-		TSharedPtr<DocTreeNode> NewChild = MakeShared<DocTreeNode>();
+		TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> NewChild = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 		ObjPtr->Add(ChildName, NewChild);
 		return NewChild;
 	}
 
-	TSharedPtr<DocTreeNode> AppendChildWithValue(const FString& ChildName, const FString& NewValue)
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> AppendChildWithValue(const FString& ChildName, const FString& NewValue)
 	{
-		TSharedPtr<DocTreeNode> NewChild = AppendChild(ChildName);
+		TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> NewChild = AppendChild(ChildName);
 		NewChild->SetValue(NewValue);
 		return NewChild;
 	}
 
-	TSharedPtr<DocTreeNode> AppendChildWithValueEscaped(const FString& ChildName, const FString& NewValue)
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> AppendChildWithValueEscaped(const FString& ChildName,
+																			 const FString& NewValue)
 	{
-		TSharedPtr<DocTreeNode> NewChild = AppendChild(ChildName);
+		TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> NewChild = AppendChild(ChildName);
 		NewChild->SetValue(NewValue, true);
 		return NewChild;
 	}
 
+	/// @brief The order documents are sorted in by id. Case only breaks ties, so the order reads naturally but is
+	/// still total.
+	static bool SortKeyLess(const FString& A, const FString& B)
+	{
+		const int32 Order = A.Compare(B, ESearchCase::IgnoreCase);
+		return Order != 0 ? Order < 0 : A.Compare(B, ESearchCase::CaseSensitive) < 0;
+	}
+
+	/// @brief Reorders the children named ChildName by the value of their own KeyName child, so that output doesn't
+	/// depend on the order they were appended in. Children with other names keep their positions.
+	void SortChildrenByKey(const FString& ChildName, const FString& KeyName)
+	{
+		if (CurrentDataType != InternalDataType::Object)
+		{
+			return;
+		}
+		Object& Children = Value.Get<Object>();
+
+		TArray<TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>> SortedChildren;
+		for (const auto& Child : Children)
+		{
+			if (Child.Key == ChildName)
+			{
+				TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> KeyNode;
+				if (Child.Value->CurrentDataType == InternalDataType::Object)
+				{
+					KeyNode = Child.Value->FindChildByName(KeyName);
+				}
+				SortedChildren.Emplace(KeyNode ? KeyNode->GetValue() : FString(), Child.Value);
+			}
+		}
+		if (SortedChildren.Num() < 2)
+		{
+			return;
+		}
+		SortedChildren.StableSort([](const TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>& A,
+									 const TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>& B) {
+			return SortKeyLess(A.Key, B.Key);
+		});
+
+		// Rebuilt rather than edited in place, as a multimap's iteration order only follows insertion order while
+		// nothing has been removed from it
+		Object ReorderedChildren;
+		ReorderedChildren.Reserve(Children.Num());
+		int32 NextSortedChild = 0;
+		for (const auto& Child : Children)
+		{
+			ReorderedChildren.Add(Child.Key,
+								  Child.Key == ChildName ? SortedChildren[NextSortedChild++].Value : Child.Value);
+		}
+		Value.Set<Object>(MoveTemp(ReorderedChildren));
+	}
+
 	struct IDocTreeSerializer
 	{
 		virtual FString EscapeString(const FString& InString) = 0;
 		virtual FString GetFileExtension() = 0;
 		virtual void SerializeObject(const Object& Object) = 0;
 		virtual void SerializeString(const FString& InString) = 0;
+		/// @brief Serializes a value that was flagged as requiring escaping. Serializers that can escape while writing
+		/// should override this rather than building the escaped string up front.
+		virtual void SerializeEscapedString(const FString& InString)
+		{
+			SerializeString(EscapeString(InString));
+		}
 		virtual void SerializeNull() = 0;
 		virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName) = 0;
+		/// @brief Writes the serialized document into a buffer with the same bytes SaveToFile would produce
+		/// @return false if this serializer can only write to disk
+		virtual bool SaveToBuffer(TArray<uint8>& OutBuffer)
+		{
+			return false;
+		}
 		virtual ~IDocTreeSerializer() {};
 	};
 
 	void SerializeWith(TSharedPtr<IDocTreeSerializer> Serializer)
+	{
+		SerializeWith(*Serializer);
+	}
+
+	void SerializeWith(IDocTreeSerializer& Serializer)
 	{
 		switch (CurrentDataType)
 		{
 			case InternalDataType::Null:
-				Serializer->SerializeNull();
+				Serializer.SerializeNull();
 				break;
 			case InternalDataType::Object:
-				Serializer->SerializeObject(Value.Get<Object>());
+				Serializer.SerializeObject(Value.Get<Object>());
 				break;
 			case InternalDataType::String:
 				if (bValueRequiresEscaping)
 				{
-					Serializer->SerializeString(Serializer->EscapeString(Value.Get<FString>()));
+					Serializer.SerializeEscapedString(Value.Get<FString>());
 				}
 				else
 				{
-					Serializer->SerializeString(Value.Get<FString>());
+					Serializer.SerializeString(Value.Get<FString>());
 				}
 		}
 	}
@@ -8,6 +8,7 @@
 
 #include "AnimGraphNode_Base.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Blueprint/UserWidget.h"
 #include "BlueprintActionDatabase.h"
 #include "BlueprintBoundNodeSpawner.h"
@@ -17,6 +18,13 @@
 #include "BlueprintNodeSpawner.h"
 #include "Components/TextBlock.h"
 #include "Components/Widget.h"
+#include "DocGenDirectoryRegistry.h"
+#include "DocGenDocModel.h"
+#include "DocGenImageManifest.h"
+#include "DocGenOutputManifest.h"
+#include "DocGenSettings.h"
+#include "DocGenUTF8.h"
+#include "DocGenWriteQueue.h"
 #include "DocTreeNode.h"
 #include "DoxygenParserHelpers.h"
 #include "EdGraphSchema_K2.h"
@@ -29,7 +37,10 @@
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Kismet2/KismetEditorUtilities.h"
 #include "Misc/EngineVersionComparison.h"
+#include "Misc/ScopeLock.h"
 #include "NodeFactory.h"
+#include "OutputFormats/DocGenBinaryFormat.h"
+#include "OutputFormats/DocGenIntermediateArchive.h"
 #include "OutputFormats/DocGenOutputFormatFactoryBase.h"
 #include "Runtime/ImageWriteQueue/Public/ImageWriteTask.h"
 #include "SGraphNode.h"
@@ -91,9 +102,41 @@ bool GetClassDisplayName(UClass* TargetClass, FText& DisplayName)
 	return FText::FindText(Namespace, Key, /*OUT*/ DisplayName, &NativeDisplayName);
 #endif
 }
+FNodeDocsGenerator::FNodeDocsGenerator(const FKantanDocGenSettings& Settings,
+									   TSharedPtr<FDocGenOutputManifest> OutputManifest)
+	: Renderer(false),
+	  OutputFormats(Settings.OutputFormats),
+	  bBinaryIntermediates(Settings.bBinaryIntermediates),
+	  bPackIntermediateFiles(Settings.bPackIntermediateFiles),
+	  bCompressIntermediatePack(Settings.bCompressIntermediatePack),
+	  WriteQueue(MakeUnique<FDocGenWriteQueue>()),
+	  Directories(MakeShared<FDocGenDirectoryRegistry>()),
+	  MetaDataIncludePatterns(Settings.MetaDataIncludePatterns),
+	  MetaDataExcludePatterns(Settings.MetaDataExcludePatterns)
+{
+	WriteQueue->SetManifest(OutputManifest);
+	WriteQueue->SetDirectoryRegistry(Directories);
+
+	TSet<FString> IntermediateFormats;
+	for (UDocGenOutputFormatFactoryBase* FactoryObject : OutputFormats)
+	{
+		bool bAlreadySerialized = false;
+		IntermediateFormats.Add(FactoryObject->GetIntermediateFormatIdentifier(), &bAlreadySerialized);
+		if (!bAlreadySerialized)
+		{
+			SerializationFormats.Add(FactoryObject);
+		}
+	}
+	if (IntermediateFormats.Contains(TEXT("json")))
+	{
+		DocModel = MakeShared<FDocGenDocModel>();
+	}
+}
+
 FNodeDocsGenerator::~FNodeDocsGenerator()
 {
 	CleanUp();
+	WriteQueue.Reset();
 }
 
 bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOutputDir, UClass* BlueprintContextClass)
@@ -122,6 +165,17 @@ bool FNodeDocsGenerator::GT_Init(FString const& InDocsTitle, FString const& InOu
 
 	ClassDocTreeMap.Empty();
 	OutputDir = InOutputDir;
+	ImageManifest = MakeShared<FDocGenImageManifest>();
+
+	if (bPackIntermediateFiles)
+	{
+		IntermediatePack = FDocGenIntermediateArchiveWriter::Create(
+			OutputDir / DocGenIntermediateArchive::PackFileName, bCompressIntermediatePack);
+		if (!IntermediatePack)
+		{
+			return false;
+		}
+	}
 
 	return true;
 }
@@ -164,6 +218,18 @@ UK2Node* FNodeDocsGenerator::GT_InitializeForSpawner(UBlueprintNodeSpawner* Spaw
 
 bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
 {
+	// The only point generation waits for the write queue, every image has to be done with before the node documents
+	// still waiting on one can be saved
+	if (!WriteQueue->Flush())
+	{
+		// The flush only reports failures once, the final one still has to fail for them
+		bWriteFailed = true;
+	}
+	if (!SavePendingNodeDocs())
+	{
+		return false;
+	}
+	SortDocTrees();
 	if (!SaveClassDocFile(OutputPath))
 	{
 		return false;
@@ -184,6 +250,56 @@ bool FNodeDocsGenerator::GT_Finalize(FString OutputPath)
 	{
 		return false;
 	}
+	// A failure may already have been reported by the flush before saving node documents
+	if (!WriteQueue->Flush() || bWriteFailed ||
+		!ImageManifest->Save(OutputPath / FDocGenImageManifest::ManifestFileName))
+	{
+		bWriteFailed = true;
+		return false;
+	}
+	if (IntermediatePack)
+	{
+		// Processors can only read the pack once its index has been written
+		const bool bPackFinalized = IntermediatePack->Finalize();
+		IntermediatePack.Reset();
+		if (!bPackFinalized)
+		{
+			bWriteFailed = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FNodeDocsGenerator::SavePendingNodeDocs()
+{
+	// Generation order is kept, the pack appends documents in the order they're saved
+	TArray<bool> ImagesWritten;
+	{
+		FScopeLock Lock(&FinishedImagesLock);
+		for (const FPendingNodeDoc& NodeDoc : PendingNodeDocs)
+		{
+			const bool* bImageWritten = FinishedImages.Find(NodeDoc.ImagePath);
+			if (!bImageWritten)
+			{
+				break;
+			}
+			ImagesWritten.Add(*bImageWritten);
+		}
+	}
+	for (int32 Index = 0; Index < ImagesWritten.Num(); ++Index)
+	{
+		const FPendingNodeDoc& NodeDoc = PendingNodeDocs[Index];
+		if (!ImagesWritten[Index])
+		{
+			NodeDoc.Document->FindChildByName(TEXT("imgpath"))->SetValue(FString());
+		}
+		if (!SaveAllFormats(NodeDoc.OutDir, NodeDoc.FileName, NodeDoc.Document))
+		{
+			return false;
+		}
+	}
+	PendingNodeDocs.RemoveAt(0, ImagesWritten.Num());
 	return true;
 }
 
@@ -206,6 +322,18 @@ void FNodeDocsGenerator::CleanUp()
 	}
 }
 
+// Processors hard link images into their output where they can, so a changed image replaces the file rather than
+// writing into it, which would change the linked copies too
+static bool WriteImage(FImageWriteTask& ImageTask, FDocGenDirectoryRegistry& Directories)
+{
+	if (!Directories.EnsureDirectory(FPaths::GetPath(ImageTask.Filename)))
+	{
+		return false;
+	}
+	IFileManager::Get().Delete(*ImageTask.Filename, false, true, true);
+	return ImageTask.RunTask();
+}
+
 bool FNodeDocsGenerator::GenerateWidgetImage(UObject* ClassObject)
 {
 	UClass* AsClass = Cast<UClass>(ClassObject);
@@ -375,13 +503,13 @@ bool FNodeDocsGenerator::GenerateWidgetImage(UObject* ClassObject)
 	}
 
 	FString ImageBasePath = OutputDir / ClassName / TEXT("img"); // State.RelImageBasePath;
-	if (!IFileManager::Get().DirectoryExists(*ImageBasePath))
-	{
-		IFileManager::Get().MakeDirectory(*ImageBasePath, true);
-	}
 	FString ImgFilename = FString::Printf(TEXT("class_img_%s.png"), *ClassName);
 	FString ScreenshotSaveName = ImageBasePath / ImgFilename;
 
+	const int64 ImageBytes = PixelData->Pixels.Num() * sizeof(FColor);
+	// Identical pixels encode to an identical png, so the encode itself can be skipped when nothing changed
+	const uint64 PixelHash =
+		FDocGenOutputManifest::HashBytes(reinterpret_cast<const uint8*>(PixelData->Pixels.GetData()), ImageBytes);
 	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
 	ImageTask->PixelData = MoveTemp(PixelData);
 	ImageTask->Filename = ScreenshotSaveName;
@@ -405,15 +533,13 @@ bool FNodeDocsGenerator::GenerateWidgetImage(UObject* ClassObject)
 		}
 	});
 
-	if (ImageTask->RunTask())
-	{
-		// Success!
-		bSuccess = true;
-	}
-	else
-	{
-		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save screenshot image for node: %s"), *ClassName);
-	}
+	// Encoding and writing happen on the write queue, a failure only loses the image
+	ImageManifest->Add(ScreenshotSaveName, PixelHash);
+	WriteQueue->EnqueueTaskIfChanged(
+		ScreenshotSaveName, PixelHash, ImageBytes,
+		[ImageTask = MoveTemp(ImageTask), Directories = Directories]() { return WriteImage(*ImageTask, *Directories); },
+		false);
+	bSuccess = true;
 
 	return bSuccess;
 }
@@ -484,13 +610,13 @@ bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingSt
 
 	State.RelImageBasePath = TEXT("../img");
 	FString ImageBasePath = State.ClassDocsPath / TEXT("img"); // State.RelImageBasePath;
-	if (!IFileManager::Get().DirectoryExists(*ImageBasePath))
-	{
-		IFileManager::Get().MakeDirectory(*ImageBasePath, true);
-	}
 	FString ImgFilename = FString::Printf(TEXT("nd_img_%s_%s.png"), *State.NodeClassId, *NodeName);
 	FString ScreenshotSaveName = ImageBasePath / ImgFilename;
 
+	const int64 ImageBytes = PixelData->Pixels.Num() * sizeof(FColor);
+	// Identical pixels encode to an identical png, so the encode itself can be skipped when nothing changed
+	const uint64 PixelHash =
+		FDocGenOutputManifest::HashBytes(reinterpret_cast<const uint8*>(PixelData->Pixels.GetData()), ImageBytes);
 	TUniquePtr<FImageWriteTask> ImageTask = MakeUnique<FImageWriteTask>();
 	ImageTask->PixelData = MoveTemp(PixelData);
 	ImageTask->Filename = ScreenshotSaveName;
@@ -514,16 +640,18 @@ bool FNodeDocsGenerator::GenerateNodeImage(UEdGraphNode* Node, FNodeProcessingSt
 		}
 	});
 
-	if (ImageTask->RunTask())
-	{
-		// Success!
-		bSuccess = true;
-		State.ImageFilename = ImgFilename;
-	}
-	else
-	{
-		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to save screenshot image for node: %s"), *NodeName);
-	}
+	// A failure only loses the image, the node's document is saved without one once the image is done with
+	ImageManifest->Add(ScreenshotSaveName, PixelHash);
+	WriteQueue->EnqueueTaskIfChanged(
+		ScreenshotSaveName, PixelHash, ImageBytes,
+		[ImageTask = MoveTemp(ImageTask), Directories = Directories]() { return WriteImage(*ImageTask, *Directories); },
+		false,
+		[this, ScreenshotSaveName](bool bWritten) {
+			FScopeLock Lock(&FinishedImagesLock);
+			FinishedImages.Add(ScreenshotSaveName, bWritten);
+		});
+	bSuccess = true;
+	State.ImageFilename = ImgFilename;
 
 	return bSuccess;
 }
@@ -571,9 +699,9 @@ bool ExtractPinInformation(UEdGraphPin* Pin, FString& OutName, FString& OutType,
 	return true;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitIndexDocTree(FString const& IndexTitle)
+TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FNodeDocsGenerator::InitIndexDocTree(FString const& IndexTitle)
 {
-	TSharedPtr<DocTreeNode> IndexDocTree = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> IndexDocTree = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	IndexDocTree->AppendChildWithValueEscaped(TEXT("display_name"), IndexTitle);
 	IndexDocTree->AppendChild(TEXT("classes"));
 	IndexDocTree->AppendChild(TEXT("structs"));
@@ -582,9 +710,9 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitIndexDocTree(FString const& Inde
 	return IndexDocTree;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitClassDocTree(UClass* Class)
+TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FNodeDocsGenerator::InitClassDocTree(UClass* Class)
 {
-	TSharedPtr<DocTreeNode> ClassDoc = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> ClassDoc = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	ClassDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
 	ClassDoc->AppendChildWithValueEscaped(TEXT("id"), GetClassDocId(Class));
 	FText DisplayName = FText::FromString(GetClassDocId(Class));
@@ -648,9 +776,9 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitClassDocTree(UClass* Class)
 	return ClassDoc;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitStructDocTree(UScriptStruct* Struct)
+TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FNodeDocsGenerator::InitStructDocTree(UScriptStruct* Struct)
 {
-	TSharedPtr<DocTreeNode> StructDoc = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> StructDoc = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	StructDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
 	StructDoc->AppendChildWithValueEscaped(TEXT("id"), Struct->GetName());
 	if (Struct->HasMetaData(TEXT("DisplayName")))
@@ -698,9 +826,9 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitStructDocTree(UScriptStruct* Str
 	return StructDoc;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitEnumDocTree(UEnum* Enum)
+TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FNodeDocsGenerator::InitEnumDocTree(UEnum* Enum)
 {
-	TSharedPtr<DocTreeNode> EnumDoc = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> EnumDoc = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	EnumDoc->AppendChildWithValueEscaped(TEXT("docs_name"), DocsTitle);
 	EnumDoc->AppendChildWithValueEscaped(TEXT("id"), Enum->GetName());
 	if (Enum->HasMetaData(TEXT("DisplayName")))
@@ -719,28 +847,81 @@ TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitEnumDocTree(UEnum* Enum)
 	return EnumDoc;
 }
 
-TSharedPtr<DocTreeNode> FNodeDocsGenerator::InitDelegateDocTree(UFunction* SignatureFunction)
+TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> FNodeDocsGenerator::InitDelegateDocTree(UFunction* SignatureFunction)
 {
-	TSharedPtr<DocTreeNode> DelegateDoc = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DelegateDoc = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	DelegateDoc->AppendChildWithValueEscaped(TEXT("id"), GetDelegateDocId(SignatureFunction));
 	DelegateDoc->AppendChildWithValue("context_string", ContextString);
 
 	return DelegateDoc;
 }
 
-void FNodeDocsGenerator::AddMetaDataMapToNode(TSharedPtr<DocTreeNode> Node, const TMap<FName, FString>* MetaDataMap)
+void FNodeDocsGenerator::AddMetaDataMapToNode(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Node,
+											  const TMap<FName, FString>* MetaDataMap)
 {
 	if (MetaDataMap)
 	{
 		auto MetaDataNode = Node->AppendChild("meta");
-		for (const auto& Entry : *MetaDataMap)
+		// Filtered before sorting, so entries that are left out never get as far as a node
+		TArray<FName> MetaDataKeys;
+		MetaDataKeys.Reserve(MetaDataMap->Num());
+		for (const TPair<FName, FString>& Entry : *MetaDataMap)
 		{
-			MetaDataNode->AppendChildWithValueEscaped(Entry.Key.ToString(), Entry.Value);
+			FMetaDataKeyStats* Stats = MetaDataKeyStats.Find(Entry.Key);
+			if (!Stats)
+			{
+				Stats = &MetaDataKeyStats.Add(Entry.Key);
+				Stats->bDocumented = ShouldDocumentMetaDataKey(Entry.Key.ToString(), MetaDataIncludePatterns,
+															   MetaDataExcludePatterns);
+			}
+			++Stats->EntryCount;
+			Stats->ByteCount += DocGenUTF8::EncodedLength(Entry.Value);
+			if (Stats->bDocumented)
+			{
+				MetaDataKeys.Add(Entry.Key);
+			}
 		}
+		// Metadata map order follows FName creation order, which varies between editor sessions
+		MetaDataKeys.Sort(FNameLexicalLess());
+		for (const FName& Key : MetaDataKeys)
+		{
+			MetaDataNode->AppendChildWithValueEscaped(Key.ToString(), MetaDataMap->FindChecked(Key));
+		}
+	}
+}
+
+bool FNodeDocsGenerator::ShouldDocumentMetaDataKey(const FString& Key, const TArray<FString>& IncludePatterns,
+												   const TArray<FString>& ExcludePatterns)
+{
+	auto MatchesAny = [&Key](const TArray<FString>& Patterns) {
+		return Patterns.ContainsByPredicate(
+			[&Key](const FString& Pattern) { return Key.MatchesWildcard(Pattern, ESearchCase::IgnoreCase); });
+	};
+	return (IncludePatterns.Num() == 0 || MatchesAny(IncludePatterns)) && !MatchesAny(ExcludePatterns);
+}
+
+void FNodeDocsGenerator::LogMetaDataReport() const
+{
+	TArray<FName> Keys;
+	MetaDataKeyStats.GetKeys(Keys);
+	// Largest first, those are the keys worth excluding
+	Keys.Sort([this](const FName& A, const FName& B) {
+		return MetaDataKeyStats[A].ByteCount > MetaDataKeyStats[B].ByteCount;
+	});
+	int64 DocumentedBytes = 0;
+	int64 ExcludedBytes = 0;
+	for (const FName& Key : Keys)
+	{
+		const FMetaDataKeyStats& Stats = MetaDataKeyStats[Key];
+		(Stats.bDocumented ? DocumentedBytes : ExcludedBytes) += Stats.ByteCount;
+		UE_LOG(LogKantanDocGen, Log, TEXT("Metadata %s: %d entries, %lld bytes%s"), *Key.ToString(), Stats.EntryCount,
+			   Stats.ByteCount, Stats.bDocumented ? TEXT("") : TEXT(", excluded"));
 	}
+	UE_LOG(LogKantanDocGen, Log, TEXT("Documented %lld bytes of metadata values, excluded %lld bytes"), DocumentedBytes,
+		   ExcludedBytes);
 }
 
-bool FNodeDocsGenerator::UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, UClass* Class)
+bool FNodeDocsGenerator::UpdateIndexDocWithClass(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UClass* Class)
 {
 	auto DocTreeClassesElement = DocTree->FindChildByName("classes");
 	auto DocTreeClass = DocTreeClassesElement->AppendChild("class");
@@ -750,7 +931,7 @@ bool FNodeDocsGenerator::UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree
 	return true;
 }
 
-bool FNodeDocsGenerator::UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, UStruct* Struct)
+bool FNodeDocsGenerator::UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UStruct* Struct)
 {
 	auto DocTreeStructsElement = DocTree->FindChildByName("structs");
 	auto DocTreeStruct = DocTreeStructsElement->AppendChild("struct");
@@ -767,7 +948,7 @@ bool FNodeDocsGenerator::UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTre
 	return true;
 }
 
-bool FNodeDocsGenerator::UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum)
+bool FNodeDocsGenerator::UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UEnum* Enum)
 {
 	auto DocTreeEnumsElement = DocTree->FindChildByName("enums");
 	auto DocTreeEnum = DocTreeEnumsElement->AppendChild("enum");
@@ -784,15 +965,17 @@ bool FNodeDocsGenerator::UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree,
 	return true;
 }
 
-bool FNodeDocsGenerator::UpdateIndexDocWithDelegate(TSharedPtr<DocTreeNode> DocTree, UFunction* SignatureFunction)
+bool FNodeDocsGenerator::UpdateIndexDocWithDelegate(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree,
+													UFunction* SignatureFunction)
 {
-	TSharedPtr<DocTreeNode> DocTreeDelegatesElement = DocTree->FindChildByName("delegates");
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTreeDelegatesElement = DocTree->FindChildByName("delegates");
 	auto DocTreeDelegate = DocTreeDelegatesElement->AppendChild("delegate");
 	DocTreeDelegate->AppendChildWithValueEscaped(TEXT("id"), GetDelegateDocId(SignatureFunction));
 	return true;
 }
 
-bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node)
+bool FNodeDocsGenerator::UpdateClassDocWithNode(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree,
+												UEdGraphNode* Node)
 {
 	auto DocTreeNodesElement = DocTree->FindChildByName("nodes");
 	auto DocTreeNode = DocTreeNodesElement->AppendChild("node");
@@ -817,7 +1000,7 @@ bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState
 
 	auto NodeDocsPath = State.ClassDocsPath / TEXT("nodes");
 
-	TSharedPtr<DocTreeNode> NodeDocFile = MakeShared<DocTreeNode>();
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> NodeDocFile = MakeShared<DocTreeNode, ESPMode::ThreadSafe>();
 	NodeDocFile->AppendChildWithValueEscaped("docs_name", DocsTitle);
 	NodeDocFile->AppendChildWithValueEscaped("class_id", State.ClassDocTree->FindChildByName("id")->GetValue());
 	NodeDocFile->AppendChildWithValueEscaped("class_name",
@@ -993,12 +1176,13 @@ bool FNodeDocsGenerator::GenerateNodeDocTree(UK2Node* Node, FNodeProcessingState
 			}
 		}
 	}
-	// Serialize the node document immediately, rather than queueing like for types
-	for (const auto& FactoryObject : OutputFormats)
+	// Saved once the node's image is on disk, which it may not be yet. Images the queue is still working on are
+	// bounded by its capacity, and so are the documents waiting on them.
+	PendingNodeDocs.Add({NodeDocsPath, GetNodeDocId(Node), NodeDocFile,
+						 State.ClassDocsPath / TEXT("img") / State.ImageFilename});
+	if (!SavePendingNodeDocs())
 	{
-		auto Serializer = FactoryObject->CreateSerializer();
-		NodeDocFile->SerializeWith(Serializer);
-		Serializer->SaveToFile(NodeDocsPath, GetNodeDocId(Node));
+		return false;
 	}
 
 	if (!UpdateClassDocWithNode(State.ClassDocTree, Node))
@@ -1077,8 +1261,8 @@ bool FNodeDocsGenerator::GenerateTypeMembers(UObject* Type)
 					return true;
 				}
 			}
-			TSharedPtr<DocTreeNode>* FoundClassDocTree = ClassDocTreeMap.Find(ClassInstance);
-			TSharedPtr<DocTreeNode> ClassDocTree;
+			TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>* FoundClassDocTree = ClassDocTreeMap.Find(ClassInstance);
+			TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> ClassDocTree;
 			if (!FoundClassDocTree)
 			{
 				ClassDocTree = InitClassDocTree(ClassInstance);
@@ -1445,31 +1629,54 @@ bool FNodeDocsGenerator::GenerateTypeMembers(UObject* Type)
 
 bool FNodeDocsGenerator::SaveIndexFile(FString const& OutDir)
 {
-	for (const auto& FactoryObject : OutputFormats)
+	return SaveAllFormats(OutDir, "index", IndexTree);
+}
+
+// Doc trees are saved in id order rather than map order, so intermediates are written (and packed) in the same order
+// on every run, and in the same order as the index lists them
+template<typename KeyType, typename GetIdType>
+static TArray<TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>> SortDocTreeMapById(
+	const TMap<KeyType, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>& DocTreeMap, GetIdType GetId)
+{
+	TArray<TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>> SortedDocTrees;
+	SortedDocTrees.Reserve(DocTreeMap.Num());
+	for (const auto& Entry : DocTreeMap)
 	{
-		auto Serializer = FactoryObject->CreateSerializer();
-		IndexTree->SerializeWith(Serializer);
-		Serializer->SaveToFile(OutDir, "index");
+		SortedDocTrees.Emplace(GetId(Entry.Key), Entry.Value);
 	}
-	return true;
+	SortedDocTrees.Sort([](const TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>& A,
+						   const TPair<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>>& B) {
+		return DocTreeNode::SortKeyLess(A.Key, B.Key);
+	});
+	return SortedDocTrees;
 }
 
-bool FNodeDocsGenerator::SaveClassDocFile(FString const& OutDir)
+void FNodeDocsGenerator::SortDocTrees()
 {
+	IndexTree->FindChildByName(TEXT("classes"))->SortChildrenByKey(TEXT("class"), TEXT("id"));
+	IndexTree->FindChildByName(TEXT("structs"))->SortChildrenByKey(TEXT("struct"), TEXT("id"));
+	IndexTree->FindChildByName(TEXT("enums"))->SortChildrenByKey(TEXT("enum"), TEXT("id"));
+	IndexTree->FindChildByName(TEXT("delegates"))->SortChildrenByKey(TEXT("delegate"), TEXT("id"));
 	for (const auto& Entry : ClassDocTreeMap)
 	{
-		auto ClassId = GetClassDocId(Entry.Key.Get());
-		auto Path = OutDir / ClassId;
-		auto DummyImagePath = OutDir / ClassId / "img";
-		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
+		if (TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Nodes = Entry.Value->FindChildByName(TEXT("nodes")))
 		{
-			IFileManager::Get().MakeDirectory(*DummyImagePath);
+			Nodes->SortChildrenByKey(TEXT("node"), TEXT("id"));
 		}
-		for (const auto& FactoryObject : OutputFormats)
+	}
+}
+
+bool FNodeDocsGenerator::SaveClassDocFile(FString const& OutDir)
+{
+	const auto SortedDocTrees = SortDocTreeMapById(
+		ClassDocTreeMap, [](const TWeakObjectPtr<UClass>& Class) { return GetClassDocId(Class.Get()); });
+	for (const auto& Entry : SortedDocTrees)
+	{
+		const FString& ClassId = Entry.Key;
+		auto Path = OutDir / ClassId;
+		if (!SaveAllFormats(Path, ClassId, Entry.Value))
 		{
-			auto Serializer = FactoryObject->CreateSerializer();
-			Entry.Value->SerializeWith(Serializer);
-			Serializer->SaveToFile(Path, ClassId);
+			return false;
 		}
 	}
 	return true;
@@ -1477,20 +1684,15 @@ bool FNodeDocsGenerator::SaveClassDocFile(FString const& OutDir)
 
 bool FNodeDocsGenerator::SaveEnumDocFile(FString const& OutDir)
 {
-	for (const auto& Entry : EnumDocTreeMap)
+	const auto SortedDocTrees =
+		SortDocTreeMapById(EnumDocTreeMap, [](const TWeakObjectPtr<UEnum>& Enum) { return Enum.Get()->GetName(); });
+	for (const auto& Entry : SortedDocTrees)
 	{
-		auto EnumId = Entry.Key.Get()->GetName();
+		const FString& EnumId = Entry.Key;
 		auto Path = OutDir / EnumId;
-		auto DummyImagePath = OutDir / EnumId / "img";
-		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
+		if (!SaveAllFormats(Path, EnumId, Entry.Value))
 		{
-			IFileManager::Get().MakeDirectory(*DummyImagePath, true);
-		}
-		for (const auto& FactoryObject : OutputFormats)
-		{
-			auto Serializer = FactoryObject->CreateSerializer();
-			Entry.Value->SerializeWith(Serializer);
-			Serializer->SaveToFile(Path, EnumId);
+			return false;
 		}
 	}
 	return true;
@@ -1498,21 +1700,15 @@ bool FNodeDocsGenerator::SaveEnumDocFile(FString const& OutDir)
 
 bool FNodeDocsGenerator::SaveStructDocFile(FString const& OutDir)
 {
-	for (const auto& Entry : StructDocTreeMap)
+	const auto SortedDocTrees = SortDocTreeMapById(
+		StructDocTreeMap, [](const TWeakObjectPtr<UStruct>& Struct) { return Struct.Get()->GetName(); });
+	for (const auto& Entry : SortedDocTrees)
 	{
-		auto StructId = Entry.Key.Get()->GetName();
+		const FString& StructId = Entry.Key;
 		auto Path = OutDir / StructId;
-		auto DummyImagePath = OutDir / StructId / "img";
-		if (!IFileManager::Get().DirectoryExists(*DummyImagePath))
-		{
-			IFileManager::Get().MakeDirectory(*DummyImagePath, true);
-		}
-
-		for (const auto& FactoryObject : OutputFormats)
+		if (!SaveAllFormats(Path, StructId, Entry.Value))
 		{
-			auto Serializer = FactoryObject->CreateSerializer();
-			Entry.Value->SerializeWith(Serializer);
-			Serializer->SaveToFile(Path, StructId);
+			return false;
 		}
 	}
 	return true;
@@ -1520,21 +1716,73 @@ bool FNodeDocsGenerator::SaveStructDocFile(FString const& OutDir)
 
 bool FNodeDocsGenerator::SaveDelegateDocFile(FString const& OutDir)
 {
-	for (const auto& Entry : DelegateDocTreeMap)
+	const auto SortedDocTrees =
+		SortDocTreeMapById(DelegateDocTreeMap, [](const FString& DelegateId) { return DelegateId; });
+	for (const auto& Entry : SortedDocTrees)
 	{
-		auto DelegateId = Entry.Key;
+		const FString& DelegateId = Entry.Key;
 		auto Path = OutDir / DelegateId;
-		if (!IFileManager::Get().DirectoryExists(*Path))
+		if (!SaveAllFormats(Path, DelegateId, Entry.Value))
 		{
-			IFileManager::Get().MakeDirectory(*Path, true);
+			return false;
 		}
+	}
+	return true;
+}
 
-		for (const auto& FactoryObject : OutputFormats)
-		{
-			auto Serializer = FactoryObject->CreateSerializer();
-			Entry.Value->SerializeWith(Serializer);
-			Serializer->SaveToFile(Path, DelegateId);
-		}
+bool FNodeDocsGenerator::SaveAllFormats(FString const& OutDir, FString const& FileName,
+										TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document)
+{
+	// Serializers only read from the doc tree, so every distinct format can walk it concurrently
+	TArray<bool> SaveResults;
+	SaveResults.SetNumZeroed(SerializationFormats.Num());
+	ParallelFor(
+		SerializationFormats.Num(),
+		[this, &OutDir, &FileName, &Document, &SaveResults](int32 FormatIndex) {
+			UDocGenOutputFormatFactoryBase* Format = SerializationFormats[FormatIndex];
+			// Binary and packed intermediates are only understood by processors reading json intermediates
+			const bool bJsonIntermediate = Format->GetIntermediateFormatIdentifier() == TEXT("json");
+			TSharedPtr<DocTreeNode::IDocTreeSerializer> Serializer;
+			if (bBinaryIntermediates && bJsonIntermediate)
+			{
+				Serializer = MakeShared<DocGenBinarySerializer>();
+			}
+			else
+			{
+				Serializer = Format->CreateSerializer();
+			}
+			Document->SerializeWith(*Serializer);
+
+			TArray<uint8> SerializedDocument;
+			if (!Serializer->SaveToBuffer(SerializedDocument))
+			{
+				// Serializer can only write to disk itself
+				SaveResults[FormatIndex] =
+					Directories->EnsureDirectory(OutDir) && Serializer->SaveToFile(OutDir, FileName);
+			}
+			else if (IntermediatePack && bJsonIntermediate)
+			{
+				const FString EntryPath = DocGenIntermediateArchive::MakeEntryPath(
+					OutputDir, OutDir / FileName + Serializer->GetFileExtension());
+				SaveResults[FormatIndex] = IntermediatePack->Append(EntryPath, SerializedDocument);
+			}
+			else
+			{
+				WriteQueue->EnqueueWrite(OutDir / FileName + Serializer->GetFileExtension(),
+										 MoveTemp(SerializedDocument));
+				SaveResults[FormatIndex] = true;
+			}
+		},
+		SerializationFormats.Num() < 2);
+
+	if (SaveResults.Contains(false))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to save %s to %s"), *FileName, *OutDir);
+		return false;
+	}
+	if (DocModel)
+	{
+		DocModel->AddDocument(OutDir / FileName + TEXT(".json"), Document);
 	}
 	return true;
 }
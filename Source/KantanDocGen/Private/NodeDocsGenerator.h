@@ -8,6 +8,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "HAL/CriticalSection.h"
 #include "Modules/ModuleManager.h"
 #include "Slate/WidgetRenderer.h"
 
@@ -22,16 +23,15 @@ class FXmlFile;
 class FNodeDocsGenerator
 {
 public:
-	FNodeDocsGenerator(const TArray<class UDocGenOutputFormatFactoryBase*>& OutputFormats)
-		: Renderer(false),
-		  OutputFormats(OutputFormats)
-	{}
+	/// @param OutputManifest when set, files whose content is unchanged since the previous run are not rewritten
+	FNodeDocsGenerator(const struct FKantanDocGenSettings& Settings,
+					   TSharedPtr<class FDocGenOutputManifest> OutputManifest = nullptr);
 	~FNodeDocsGenerator();
 
 public:
 	struct FNodeProcessingState
 	{
-		TSharedPtr<class DocTreeNode> ClassDocTree;
+		TSharedPtr<class DocTreeNode, ESPMode::ThreadSafe> ClassDocTree;
 		FString ClassDocsPath;
 		FString RelImageBasePath;
 		FString ImageFilename;
@@ -46,6 +46,23 @@ public:
 	UK2Node* GT_InitializeForSpawner(UBlueprintNodeSpawner* Spawner, UObject* SourceObject,
 									 FNodeProcessingState& OutState);
 	bool GT_Finalize(FString OutputPath);
+	/** Whether GT_Finalize failed because generated files couldn't be written */
+	bool HasWriteFailure() const
+	{
+		return bWriteFailed;
+	}
+	/** Logs how many metadata entries and bytes each key contributed, and which keys the patterns left out */
+	void LogMetaDataReport() const;
+	/// @return whether metadata entries with Key are documented. Every key is when IncludePatterns is empty, and
+	/// matching an exclude pattern overrides matching an include one. Patterns are wildcards matched ignoring case,
+	/// the same as metadata keys are compared.
+	static bool ShouldDocumentMetaDataKey(const FString& Key, const TArray<FString>& IncludePatterns,
+										  const TArray<FString>& ExcludePatterns);
+	/** Documents generated so far, null if no output format reads json intermediates */
+	TSharedPtr<class FDocGenDocModel> GetDocModel() const
+	{
+		return DocModel;
+	}
 	/**/
 
 	/** Callable from background thread */
@@ -59,25 +76,33 @@ public:
 
 protected:
 	void CleanUp();
+	/// @brief Puts every list built up during generation into id order, so output is identical across runs regardless
+	/// of the order types and nodes were enumerated in
+	void SortDocTrees();
+	/// @brief Saves the node documents waiting on images that are done with, in the order they were generated and up
+	/// to the first one whose image is still being written. Documents whose image couldn't be written are saved
+	/// without an imgpath.
+	bool SavePendingNodeDocs();
 	bool SaveIndexFile(FString const& OutDir);
 	bool SaveClassDocFile(FString const& OutDir);
 	bool SaveEnumDocFile(FString const& OutDir);
 	bool SaveStructDocFile(FString const& OutDir);
 	bool SaveDelegateDocFile(FString const& OutDir);
 
-	TSharedPtr<DocTreeNode> InitIndexDocTree(FString const& IndexTitle);
-	TSharedPtr<DocTreeNode> InitClassDocTree(UClass* Class);
-	TSharedPtr<DocTreeNode> InitStructDocTree(UScriptStruct* Struct);
-	TSharedPtr<DocTreeNode> InitEnumDocTree(UEnum* Enum);
-	TSharedPtr<DocTreeNode> InitDelegateDocTree(UFunction* SignatureFunction);
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> InitIndexDocTree(FString const& IndexTitle);
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> InitClassDocTree(UClass* Class);
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> InitStructDocTree(UScriptStruct* Struct);
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> InitEnumDocTree(UEnum* Enum);
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> InitDelegateDocTree(UFunction* SignatureFunction);
 
-	void AddMetaDataMapToNode(TSharedPtr<DocTreeNode> Node, const TMap<FName, FString>* MetaDataMap);
+	void AddMetaDataMapToNode(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Node,
+							  const TMap<FName, FString>* MetaDataMap);
 	FString GenerateFunctionSignatureString(UFunction* Func, bool bUseFuncPtrStyle = false);
-	bool UpdateIndexDocWithClass(TSharedPtr<DocTreeNode> DocTree, UClass* Class);
-	bool UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode> DocTree, UStruct* Struct);
-	bool UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode> DocTree, UEnum* Enum);
-	bool UpdateIndexDocWithDelegate(TSharedPtr<DocTreeNode> DocTree, UFunction* SignatureFunction);
-	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode> DocTree, UEdGraphNode* Node);
+	bool UpdateIndexDocWithClass(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UClass* Class);
+	bool UpdateIndexDocWithStruct(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UStruct* Struct);
+	bool UpdateIndexDocWithEnum(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UEnum* Enum);
+	bool UpdateIndexDocWithDelegate(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UFunction* SignatureFunction);
+	bool UpdateClassDocWithNode(TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> DocTree, UEdGraphNode* Node);
 
 	static void AdjustNodeForSnapshot(UEdGraphNode* Node);
 	static FString GetClassDocId(UClass* Class);
@@ -93,17 +118,55 @@ protected:
 	FWidgetRenderer Renderer;
 
 	FString DocsTitle;
-	TSharedPtr<DocTreeNode> IndexTree;
-	TMap<TWeakObjectPtr<UClass>, TSharedPtr<DocTreeNode>> ClassDocTreeMap;
-	TMap<TWeakObjectPtr<UStruct>, TSharedPtr<DocTreeNode>> StructDocTreeMap;
-	TMap<TWeakObjectPtr<UEnum>, TSharedPtr<DocTreeNode>> EnumDocTreeMap;
-	TMap<FString, TSharedPtr<DocTreeNode>> DelegateDocTreeMap;
+	TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> IndexTree;
+	TMap<TWeakObjectPtr<UClass>, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ClassDocTreeMap;
+	TMap<TWeakObjectPtr<UStruct>, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> StructDocTreeMap;
+	TMap<TWeakObjectPtr<UEnum>, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> EnumDocTreeMap;
+	TMap<FString, TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> DelegateDocTreeMap;
 	TArray<UDocGenOutputFormatFactoryBase*> OutputFormats;
+	// One factory per distinct intermediate format, formats producing identical bytes share a single serialization
+	TArray<UDocGenOutputFormatFactoryBase*> SerializationFormats;
+	bool bBinaryIntermediates = false;
+	bool bPackIntermediateFiles = false;
+	bool bCompressIntermediatePack = false;
+	// Destination for json intermediates while bPackIntermediateFiles is set, created in GT_Init
+	TSharedPtr<class FDocGenIntermediateArchiveWriter> IntermediatePack;
+	// Every loose file and image is written through here, GT_Finalize waits for it to drain
+	TUniquePtr<class FDocGenWriteQueue> WriteQueue;
+	// Directories are created by the first file written into them rather than up front for every node and type
+	TSharedPtr<class FDocGenDirectoryRegistry> Directories;
+	bool bWriteFailed = false;
+	// Documents handed to processors in memory, only kept when an output format reads json intermediates
+	TSharedPtr<class FDocGenDocModel> DocModel;
+	struct FPendingNodeDoc
+	{
+		FString OutDir;
+		FString FileName;
+		TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document;
+		// Where the node's image is being written
+		FString ImagePath;
+	};
+	// Node documents are held back until their image has been written, so none of them refers to a missing image
+	TArray<FPendingNodeDoc> PendingNodeDocs;
+	// Whether each image that's done with was written, added to from the write queue's threads
+	FCriticalSection FinishedImagesLock;
+	TMap<FString, bool> FinishedImages;
+	// Every image written, saved next to the intermediate docs for processors to place images from
+	TSharedPtr<class FDocGenImageManifest> ImageManifest;
 	FString OutputDir;
-	bool SaveAllFormats(FString const& OutDir, TSharedPtr<DocTreeNode> Document)
+	// Wildcard patterns for metadata keys, every key is documented when there are no include patterns
+	TArray<FString> MetaDataIncludePatterns;
+	TArray<FString> MetaDataExcludePatterns;
+	struct FMetaDataKeyStats
 	{
-		return false;
+		bool bDocumented = false;
+		int32 EntryCount = 0;
+		int64 ByteCount = 0;
 	};
+	// Every metadata key seen, so each one is matched against the patterns once rather than for every entry
+	TMap<FName, FMetaDataKeyStats> MetaDataKeyStats;
+	bool SaveAllFormats(FString const& OutDir, FString const& FileName,
+						TSharedPtr<DocTreeNode, ESPMode::ThreadSafe> Document);
 
 public:
 	//
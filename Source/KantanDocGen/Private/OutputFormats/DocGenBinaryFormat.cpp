@@ -0,0 +1,351 @@
+#include "OutputFormats/DocGenBinaryFormat.h"
+#include "Async/MappedFileHandle.h"
+#include "DocGenUTF8.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+const TCHAR* DocGenBinarySerializer::FileExtension = TEXT(".kdgb");
+
+FString DocGenBinarySerializer::EscapeString(const FString& InString)
+{
+	return InString;
+}
+
+FString DocGenBinarySerializer::GetFileExtension()
+{
+	return FileExtension;
+}
+
+void DocGenBinarySerializer::SerializeObject(const DocTreeNode::Object& Obj)
+{
+	Buffer.Add(static_cast<uint8>(DocGenBinaryFormat::ENodeTag::Object));
+	WriteUInt32(Obj.Num());
+	const int32 SizeOffset = Buffer.Num();
+	WriteUInt32(0);
+	const int32 MembersStart = Buffer.Num();
+	for (auto& Member : Obj)
+	{
+		WriteUInt32(InternString(Member.Key));
+		Member.Value->SerializeWith(*this);
+	}
+	PatchUInt32(SizeOffset, Buffer.Num() - MembersStart);
+}
+
+void DocGenBinarySerializer::SerializeString(const FString& InString)
+{
+	Buffer.Add(static_cast<uint8>(DocGenBinaryFormat::ENodeTag::String));
+	WriteUInt32(InternString(InString));
+}
+
+void DocGenBinarySerializer::SerializeEscapedString(const FString& InString)
+{
+	// Same as json, escaping is a no-op so skip the copy
+	SerializeString(InString);
+}
+
+void DocGenBinarySerializer::SerializeNull()
+{
+	Buffer.Add(static_cast<uint8>(DocGenBinaryFormat::ENodeTag::Null));
+}
+
+uint32 DocGenBinarySerializer::InternString(const FString& InString)
+{
+	if (const uint32* ExistingIndex = StringIndices.Find(InString))
+	{
+		return *ExistingIndex;
+	}
+	const uint32 NewIndex = Strings.Add(InString);
+	StringIndices.Add(InString, NewIndex);
+	return NewIndex;
+}
+
+void DocGenBinarySerializer::WriteUInt32(uint32 Value)
+{
+	const int32 Offset = Buffer.AddUninitialized(sizeof(uint32));
+	PatchUInt32(Offset, Value);
+}
+
+void DocGenBinarySerializer::PatchUInt32(int32 Offset, uint32 Value)
+{
+	Buffer[Offset] = Value & 0xFF;
+	Buffer[Offset + 1] = (Value >> 8) & 0xFF;
+	Buffer[Offset + 2] = (Value >> 16) & 0xFF;
+	Buffer[Offset + 3] = (Value >> 24) & 0xFF;
+}
+
+DocGenBinarySerializer::DocGenBinarySerializer()
+{
+	Buffer.Reserve(4096);
+	Buffer.AddZeroed(DocGenBinaryFormat::HeaderSize);
+}
+
+bool DocGenBinarySerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	TArray<uint8> Result;
+	if (!SaveToBuffer(Result))
+	{
+		return false;
+	}
+	return FFileHelper::SaveArrayToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()));
+}
+
+bool DocGenBinarySerializer::SaveToBuffer(TArray<uint8>& OutBuffer)
+{
+	if (Buffer.Num() < int32(DocGenBinaryFormat::HeaderSize))
+	{
+		// Already handed off by a previous save
+		return false;
+	}
+
+	// Header fields depend on the string table, so it is filled in last
+	const uint32 StringTableOffset = Buffer.Num();
+	int32 OffsetTableStart = Buffer.AddUninitialized(Strings.Num() * sizeof(uint32));
+	for (const FString& String : Strings)
+	{
+		PatchUInt32(OffsetTableStart, Buffer.Num());
+		OffsetTableStart += sizeof(uint32);
+
+		const int32 LengthOffset = Buffer.Num();
+		WriteUInt32(0);
+		DocGenUTF8::Append(Buffer, String);
+		PatchUInt32(LengthOffset, Buffer.Num() - LengthOffset - sizeof(uint32));
+	}
+
+	PatchUInt32(0, DocGenBinaryFormat::Magic);
+	Buffer[4] = DocGenBinaryFormat::Version & 0xFF;
+	Buffer[5] = (DocGenBinaryFormat::Version >> 8) & 0xFF;
+	PatchUInt32(8, StringTableOffset);
+	PatchUInt32(12, Strings.Num());
+
+	OutBuffer = MoveTemp(Buffer);
+	return true;
+}
+
+FDocGenBinaryDocument::~FDocGenBinaryDocument()
+{
+	// Region must be released before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TSharedPtr<FDocGenBinaryDocument> FDocGenBinaryDocument::Open(const FString& FilePath)
+{
+	TSharedPtr<FDocGenBinaryDocument> Document = MakeShareable(new FDocGenBinaryDocument());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	Document->MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (Document->MappedFile)
+	{
+		Document->MappedRegion.Reset(Document->MappedFile->MapRegion(0, Document->MappedFile->GetFileSize()));
+	}
+	if (Document->MappedRegion)
+	{
+		Document->Data = Document->MappedRegion->GetMappedPtr();
+		Document->DataSize = Document->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platform doesn't support mapping this file, fall back to reading it
+		Document->MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Document->OwnedData, *FilePath))
+		{
+			return nullptr;
+		}
+		Document->Data = Document->OwnedData.GetData();
+		Document->DataSize = Document->OwnedData.Num();
+	}
+
+	if (!Document->Validate(FilePath))
+	{
+		return nullptr;
+	}
+	return Document;
+}
+
+TSharedPtr<FDocGenBinaryDocument> FDocGenBinaryDocument::FromBuffer(TArray<uint8>&& Bytes, const FString& DebugName)
+{
+	TSharedPtr<FDocGenBinaryDocument> Document = MakeShareable(new FDocGenBinaryDocument());
+	Document->OwnedData = MoveTemp(Bytes);
+	Document->Data = Document->OwnedData.GetData();
+	Document->DataSize = Document->OwnedData.Num();
+	if (!Document->Validate(DebugName))
+	{
+		return nullptr;
+	}
+	return Document;
+}
+
+TSharedPtr<FDocGenBinaryDocument> FDocGenBinaryDocument::OpenSibling(const FString& JsonFilePath)
+{
+	const FString BinaryFilePath = FPaths::ChangeExtension(JsonFilePath, DocGenBinarySerializer::FileExtension);
+	if (!IFileManager::Get().FileExists(*BinaryFilePath))
+	{
+		return nullptr;
+	}
+	return Open(BinaryFilePath);
+}
+
+uint64 FDocGenBinaryDocument::GetContentHash() const
+{
+	return CityHash64(reinterpret_cast<const char*>(Data), static_cast<uint32>(DataSize));
+}
+
+TSharedPtr<FJsonObject> FDocGenBinaryDocument::ToJsonObject() const
+{
+	int64 Offset = DocGenBinaryFormat::HeaderSize;
+	TSharedPtr<FJsonValue> Root = ReadJsonValue(Offset);
+	const TSharedPtr<FJsonObject>* RootObject = nullptr;
+	if (!Root || !Root->TryGetObject(RootObject))
+	{
+		return nullptr;
+	}
+	return *RootObject;
+}
+
+bool FDocGenBinaryDocument::Validate(const FString& FilePath)
+{
+	uint32 FileMagic = 0;
+	int64 Offset = 0;
+	if (DataSize < DocGenBinaryFormat::HeaderSize || !ReadUInt32(Offset, FileMagic) ||
+		FileMagic != DocGenBinaryFormat::Magic)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("%s is not a binary intermediate document"), *FilePath);
+		return false;
+	}
+
+	const uint16 FileVersion = Data[4] | (Data[5] << 8);
+	if (FileVersion != DocGenBinaryFormat::Version)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("%s has binary intermediate version %u, expected %u"), *FilePath,
+			   FileVersion, DocGenBinaryFormat::Version);
+		return false;
+	}
+
+	Offset = 8;
+	if (!ReadUInt32(Offset, StringTableOffset) || !ReadUInt32(Offset, StringCount) ||
+		StringTableOffset + int64(StringCount) * sizeof(uint32) > DataSize)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("%s is truncated"), *FilePath);
+		return false;
+	}
+	return true;
+}
+
+bool FDocGenBinaryDocument::ReadUInt32(int64& Offset, uint32& OutValue) const
+{
+	if (Offset + int64(sizeof(uint32)) > DataSize)
+	{
+		return false;
+	}
+	OutValue = Data[Offset] | (Data[Offset + 1] << 8) | (Data[Offset + 2] << 16) | (uint32(Data[Offset + 3]) << 24);
+	Offset += sizeof(uint32);
+	return true;
+}
+
+bool FDocGenBinaryDocument::ReadString(uint32 Index, FString& OutString) const
+{
+	if (Index >= StringCount)
+	{
+		return false;
+	}
+	int64 OffsetEntry = StringTableOffset + int64(Index) * sizeof(uint32);
+	uint32 StringOffset = 0;
+	uint32 ByteLength = 0;
+	if (!ReadUInt32(OffsetEntry, StringOffset))
+	{
+		return false;
+	}
+	int64 StringStart = StringOffset;
+	if (!ReadUInt32(StringStart, ByteLength) || StringStart + ByteLength > DataSize)
+	{
+		return false;
+	}
+	OutString = DocGenUTF8::ToString(Data + StringStart, ByteLength);
+	return true;
+}
+
+TSharedPtr<FJsonValue> FDocGenBinaryDocument::ReadJsonValue(int64& Offset) const
+{
+	if (Offset >= DataSize)
+	{
+		return nullptr;
+	}
+	const DocGenBinaryFormat::ENodeTag Tag = static_cast<DocGenBinaryFormat::ENodeTag>(Data[Offset++]);
+	switch (Tag)
+	{
+		case DocGenBinaryFormat::ENodeTag::Null:
+			return MakeShared<FJsonValueNull>();
+		case DocGenBinaryFormat::ENodeTag::String:
+		{
+			uint32 StringIndex = 0;
+			FString Value;
+			if (!ReadUInt32(Offset, StringIndex) || !ReadString(StringIndex, Value))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueString>(Value);
+		}
+		case DocGenBinaryFormat::ENodeTag::Object:
+		{
+			uint32 MemberCount = 0;
+			uint32 MembersByteSize = 0;
+			if (!ReadUInt32(Offset, MemberCount) || !ReadUInt32(Offset, MembersByteSize))
+			{
+				return nullptr;
+			}
+
+			// Group repeated keys the way DocGenJsonSerializer does, keys keep the order they first appeared in
+			TArray<FString> Keys;
+			TMap<FString, TArray<TSharedPtr<FJsonValue>>> ValuesByKey;
+			for (uint32 MemberIndex = 0; MemberIndex < MemberCount; ++MemberIndex)
+			{
+				uint32 KeyIndex = 0;
+				FString Key;
+				if (!ReadUInt32(Offset, KeyIndex) || !ReadString(KeyIndex, Key))
+				{
+					return nullptr;
+				}
+				TSharedPtr<FJsonValue> MemberValue = ReadJsonValue(Offset);
+				if (!MemberValue)
+				{
+					return nullptr;
+				}
+				TArray<TSharedPtr<FJsonValue>>* ExistingValues = ValuesByKey.Find(Key);
+				if (!ExistingValues)
+				{
+					Keys.Add(Key);
+					ExistingValues = &ValuesByKey.Add(Key);
+				}
+				ExistingValues->Add(MemberValue);
+			}
+
+			// A single key with multiple values means the whole node is an array
+			if (Keys.Num() == 1 && ValuesByKey[Keys[0]].Num() > 1)
+			{
+				return MakeShared<FJsonValueArray>(ValuesByKey[Keys[0]]);
+			}
+
+			TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+			for (const FString& Key : Keys)
+			{
+				TArray<TSharedPtr<FJsonValue>>& Values = ValuesByKey[Key];
+				if (Values.Num() > 1)
+				{
+					Object->SetField(Key, MakeShared<FJsonValueArray>(Values));
+				}
+				else
+				{
+					Object->SetField(Key, Values[0]);
+				}
+			}
+			return MakeShared<FJsonValueObject>(Object);
+		}
+		default:
+			return nullptr;
+	}
+}
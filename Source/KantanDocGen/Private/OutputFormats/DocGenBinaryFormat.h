@@ -0,0 +1,127 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "DocTreeNode.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/UniquePtr.h"
+
+/*
+Compact binary encoding of a doc tree, written in place of the json intermediate files when
+FKantanDocGenSettings::bBinaryIntermediates is set.
+
+All integers are little-endian.
+	Header		uint32 Magic ('KDGB'), uint16 Version, uint16 Reserved, uint32 StringTableOffset, uint32 StringCount
+	Node		uint8 Tag, followed by
+					Null: nothing
+					String: uint32 StringIndex
+					Object: uint32 MemberCount, uint32 MembersByteSize, then MemberCount x (uint32 KeyIndex, Node)
+	StringTable	uint32 Offset[StringCount] (absolute), each pointing at uint32 ByteLength + UTF-8 bytes
+
+Every key and value is interned into the string table, so readers never copy or unescape strings they don't use,
+and MembersByteSize lets a reader skip an entire subtree without visiting it.
+*/
+namespace DocGenBinaryFormat
+{
+	static constexpr uint32 Magic = 0x4247444B;
+	// Bump whenever the layout above changes, readers reject any other version
+	static constexpr uint16 Version = 1;
+	static constexpr uint32 HeaderSize = 16;
+
+	enum class ENodeTag : uint8
+	{
+		Null = 0,
+		String = 1,
+		Object = 2
+	};
+
+	/// @brief Key funcs for interning, FString maps compare case-insensitively by default
+	template<typename ValueType>
+	struct TCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, ValueType, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+} // namespace DocGenBinaryFormat
+
+class DocGenBinarySerializer : public DocTreeNode::IDocTreeSerializer
+{
+	TArray<uint8> Buffer;
+	TArray<FString> Strings;
+	TMap<FString, uint32, FDefaultSetAllocator, DocGenBinaryFormat::TCaseSensitiveKeyFuncs<uint32>> StringIndices;
+
+	virtual FString EscapeString(const FString& InString) override;
+	virtual FString GetFileExtension() override;
+	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
+	virtual void SerializeString(const FString& InString) override;
+	virtual void SerializeEscapedString(const FString& InString) override;
+	virtual void SerializeNull() override;
+
+	uint32 InternString(const FString& InString);
+	void WriteUInt32(uint32 Value);
+	void PatchUInt32(int32 Offset, uint32 Value);
+
+public:
+	static const TCHAR* FileExtension;
+
+	DocGenBinarySerializer();
+	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName) override;
+	/// @brief Appends the string table and hands the finished document off, the serializer can't be saved again
+	virtual bool SaveToBuffer(TArray<uint8>& OutBuffer) override;
+};
+
+/// @brief Read-only view over a binary encoded doc tree. Files are memory-mapped where the platform supports it, and
+/// strings are only decoded when a value is actually requested.
+class FDocGenBinaryDocument
+{
+public:
+	~FDocGenBinaryDocument();
+
+	/// @brief Opens and validates a binary document
+	/// @return the document, or nullptr if the file is missing, truncated or was written by another version
+	static TSharedPtr<FDocGenBinaryDocument> Open(const FString& FilePath);
+
+	/// @brief Takes ownership of an in-memory copy of a binary document and validates it
+	/// @param DebugName name used when logging validation errors
+	/// @return the document, or nullptr if the bytes aren't a valid document of this version
+	static TSharedPtr<FDocGenBinaryDocument> FromBuffer(TArray<uint8>&& Bytes, const FString& DebugName);
+
+	/// @brief Opens the binary sibling of a json intermediate file if the generator wrote one
+	/// @param JsonFilePath path to the json intermediate document
+	/// @return the document, or nullptr if there was no valid binary sibling
+	static TSharedPtr<FDocGenBinaryDocument> OpenSibling(const FString& JsonFilePath);
+
+	/// @brief Hash of the encoded document, computed without materializing it
+	uint64 GetContentHash() const;
+
+	int64 GetSize() const
+	{
+		return DataSize;
+	}
+
+	/// @brief Materializes the document using the same object/array conventions as DocGenJsonSerializer
+	TSharedPtr<class FJsonObject> ToJsonObject() const;
+
+private:
+	FDocGenBinaryDocument() = default;
+	bool Validate(const FString& FilePath);
+	bool ReadUInt32(int64& Offset, uint32& OutValue) const;
+	bool ReadString(uint32 Index, FString& OutString) const;
+	TSharedPtr<class FJsonValue> ReadJsonValue(int64& Offset) const;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+	uint32 StringTableOffset = 0;
+	uint32 StringCount = 0;
+
+	TArray<uint8> OwnedData;
+	TUniquePtr<class IMappedFileHandle> MappedFile;
+	TUniquePtr<class IMappedFileRegion> MappedRegion;
+};
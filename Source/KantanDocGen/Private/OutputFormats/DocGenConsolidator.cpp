@@ -0,0 +1,732 @@
+#include "OutputFormats/DocGenConsolidator.h"
+#include "Async/ParallelFor.h"
+#include "DocGenImageManifest.h"
+#include "DocGenOutputManifest.h"
+#include "DocGenWriteQueue.h"
+#include "HAL/FileManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Misc/ScopeLock.h"
+#include "OutputFormats/DocGenIntermediateReader.h"
+#include "OutputFormats/DocGenJsonIndex.h"
+#include "OutputFormats/DocGenJsonStreamWriter.h"
+#include "ThreadingHelpers.h"
+
+const TCHAR* const FDocGenConsolidator::ConsolidatedFileName = TEXT("consolidated.json");
+const TCHAR* const FDocGenConsolidator::StandaloneFileName = TEXT("consolidated.standalone.json");
+
+namespace
+{
+	// Documents parsed ahead of being written, enough to keep every core busy without holding the whole set
+	constexpr int32 ConsolidationBatchSize = 128;
+
+	// Members of each kind of intermediate document that are copied into the consolidated document, text json is only
+	// parsed for these
+	const TArray<FString>& GetNodeMembers()
+	{
+		static const TArray<FString> NodeMembers = {
+			TEXT("inputs"), TEXT("outputs"), TEXT("rawsignature"), TEXT("class_id"), TEXT("doxygen"),
+			TEXT("imgpath"), TEXT("shorttitle"), TEXT("fulltitle"), TEXT("static"), TEXT("autocast"),
+			TEXT("funcname"), TEXT("access_specifier"), TEXT("meta")};
+		return NodeMembers;
+	}
+
+	// Of class and struct documents, other than the id which is renamed to class_id
+	const TArray<FString>& GetClassMembers()
+	{
+		static const TArray<FString> ClassMembers = {
+			TEXT("doxygen"), TEXT("display_name"), TEXT("fields"), TEXT("parent_class"), TEXT("meta"),
+			TEXT("blueprint_generated"), TEXT("widget_blueprint"), TEXT("class_path"), TEXT("context_string")};
+		return ClassMembers;
+	}
+
+	// Of class documents read for both the class and the list of its nodes
+	const TArray<FString>& GetClassAndNodeListMembers()
+	{
+		static const TArray<FString> Members = [] {
+			TArray<FString> ClassMembers = GetClassMembers();
+			ClassMembers.Add(TEXT("id"));
+			ClassMembers.Add(TEXT("nodes"));
+			return ClassMembers;
+		}();
+		return Members;
+	}
+
+	const TArray<FString>& GetEnumMembers()
+	{
+		static const TArray<FString> EnumMembers = {TEXT("id"), TEXT("doxygen"), TEXT("display_name"), TEXT("values"),
+													TEXT("meta")};
+		return EnumMembers;
+	}
+} // namespace
+
+FDocGenConsolidator::FDocGenConsolidator(const FString& IntermediateDir, const FString& OutputDir,
+										 TSharedPtr<FDocGenOutputManifest> OutputManifest,
+										 TSharedPtr<FDocGenDocModel> DocModel,
+										 TSharedPtr<FDocGenParsedDocumentCache> DocumentCache)
+	: IntermediateDir(IntermediateDir),
+	  OutputDir(OutputDir),
+	  OutputManifest(OutputManifest),
+	  DocModel(DocModel),
+	  DocumentCache(DocumentCache)
+{}
+
+EIntermediateProcessingResult FDocGenConsolidator::Consolidate()
+{
+	// Documents are loaded on worker threads, cached ones would be shared with whichever threads loaded them before
+	IntermediateReader = MakeShared<FDocGenIntermediateReader>(
+		IntermediateDir, DocModel, DocGenThreads::bThreadSafeJson ? DocumentCache : nullptr);
+	WriteQueue = MakeShared<FDocGenWriteQueue>();
+	WriteQueue->SetManifest(OutputManifest);
+	ImageManifest = FDocGenImageManifest::Load(IntermediateDir / FDocGenImageManifest::ManifestFileName);
+	if (!ImageManifest)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("No image manifest in %s, node images won't be copied"),
+			   *IntermediateDir);
+	}
+	TSharedPtr<FJsonObject> ParsedIndex = LoadFileToJson(IntermediateDir / TEXT("index.json"));
+	if (!ParsedIndex)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to load index.json from %s"), *IntermediateDir);
+		return EIntermediateProcessingResult::UnknownError;
+	}
+
+	// Written next to the real file and moved over it once complete, so a failed run never leaves a truncated
+	// consolidated.json behind and an unchanged one keeps its timestamp
+	const FString ConsolidatedPath = IntermediateDir / ConsolidatedFileName;
+	const FString StagingPath = ConsolidatedPath + TEXT(".tmp");
+	TUniquePtr<FArchive> StagingFile(IFileManager::Get().CreateFileWriter(*StagingPath));
+	if (!StagingFile)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create %s"), *StagingPath);
+		return EIntermediateProcessingResult::DiskWriteFailure;
+	}
+
+	StringTable = bUseStringTable ? MakeShared<FDocGenJsonStringTable>() : nullptr;
+	DocGenJsonStreamWriter Writer(*StagingFile, !bCompactOutput);
+	Writer.SetStringTable(StringTable);
+	EIntermediateProcessingResult Result = WriteConsolidatedDocument(ParsedIndex, Writer);
+	if (Result == EIntermediateProcessingResult::Success && !Writer.Close())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s"), *StagingPath);
+		Result = EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	StagingFile.Reset();
+
+	if (Result == EIntermediateProcessingResult::Success)
+	{
+		const uint64 ContentHash = Writer.GetContentHash();
+		if (OutputManifest && OutputManifest->IsUnchanged(ConsolidatedPath, ContentHash))
+		{
+			IFileManager::Get().Delete(*StagingPath, false, true, true);
+		}
+		else if (IFileManager::Get().Move(*ConsolidatedPath, *StagingPath, true, true))
+		{
+			if (OutputManifest)
+			{
+				OutputManifest->RecordWrite(ConsolidatedPath, ContentHash);
+			}
+		}
+		else
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to move %s to %s"), *StagingPath, *ConsolidatedPath);
+			Result = EIntermediateProcessingResult::DiskWriteFailure;
+		}
+	}
+	else
+	{
+		IFileManager::Get().Delete(*StagingPath, false, true, true);
+	}
+
+	// The conversion tools read consolidated.json and the copied images, everything has to be on disk first
+	if (!WriteQueue->Flush() && Result == EIntermediateProcessingResult::Success)
+	{
+		Result = EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	return Result;
+}
+
+EIntermediateProcessingResult FDocGenConsolidator::WriteConsolidatedDocument(TSharedPtr<FJsonObject> ParsedIndex,
+																			DocGenJsonStreamWriter& Writer)
+{
+	Writer.BeginObject();
+	if (TSharedPtr<FJsonValue> DisplayName = ParsedIndex->TryGetField(TEXT("display_name")))
+	{
+		Writer.WriteKey(TEXT("display_name"));
+		Writer.WriteJsonValue(DisplayName);
+	}
+
+	EIntermediateProcessingResult ClassResult = ConsolidateClasses(ParsedIndex, Writer);
+	if (ClassResult != EIntermediateProcessingResult::Success)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate classes"));
+		return ClassResult;
+	}
+
+	EIntermediateProcessingResult StructResult = ConsolidateStructs(ParsedIndex, Writer);
+	if (StructResult != EIntermediateProcessingResult::Success)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate structs"));
+		return StructResult;
+	}
+
+	EIntermediateProcessingResult EnumResult = ConsolidateEnums(ParsedIndex, Writer);
+	if (EnumResult != EIntermediateProcessingResult::Success)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate Enums"));
+		return EnumResult;
+	}
+	if (StringTable)
+	{
+		Writer.WriteStringTable();
+		UE_LOG(LogKantanDocGen, Log, TEXT("Consolidated document refers to %d shared strings"),
+			   StringTable->GetStrings().Num());
+		StringTable.Reset();
+	}
+	Writer.EndObject();
+	return EIntermediateProcessingResult::Success;
+}
+
+TOptional<FString> FDocGenConsolidator::GetObjectStringField(const TSharedPtr<FJsonObject> Obj,
+															 const FString& FieldName)
+{
+	FString FieldValue;
+	if (!Obj->TryGetStringField(FieldName, FieldValue))
+	{
+		return {};
+	}
+	else
+	{
+		return FieldValue;
+	}
+}
+
+TOptional<FString> FDocGenConsolidator::GetObjectStringField(const TSharedPtr<FJsonValue> Obj,
+															 const FString& FieldName)
+{
+	const TSharedPtr<FJsonObject>* UnderlyingObject = nullptr;
+	if (!Obj->TryGetObject(UnderlyingObject))
+	{
+		return {};
+	}
+	else
+	{
+		return GetObjectStringField(*UnderlyingObject, FieldName);
+	}
+}
+
+TOptional<TArray<FString>> FDocGenConsolidator::GetNamesFromDocument(const FString& NameType,
+																	 TSharedPtr<FJsonObject> ParsedDocument)
+{
+	if (ParsedDocument->HasTypedField<EJson::Array>(NameType))
+	{
+		TArray<FString> NodeNames;
+		for (const auto& Value : ParsedDocument->GetArrayField(NameType))
+		{
+			TOptional<FString> FuncID = GetObjectStringField(Value, "id");
+			if (FuncID.IsSet())
+			{
+				NodeNames.Add(FuncID.GetValue());
+			}
+		}
+		return NodeNames;
+	}
+	else if (ParsedDocument->HasTypedField<EJson::Object>(NameType))
+	{
+		TArray<FString> NodeNames;
+		for (const auto& Node : ParsedDocument->GetObjectField(NameType)->Values)
+		{
+			TOptional<FString> Name = GetObjectStringField(Node.Value, "id");
+			if (Name.IsSet())
+			{
+				NodeNames.Add(Name.GetValue());
+			}
+		}
+		return NodeNames;
+	}
+	else if (ParsedDocument->HasTypedField<EJson::Null>(NameType))
+	{
+		return TArray<FString>();
+	}
+	return {};
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ParseNodeFile(const FString& NodeFilePath)
+{
+	TSharedPtr<FJsonObject> ParsedNode = LoadFileToJson(NodeFilePath, GetNodeMembers());
+	if (!ParsedNode)
+	{
+		return {};
+	}
+
+	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+	for (const FString& Member : GetNodeMembers())
+	{
+		CopyJsonField(Member, ParsedNode, OutNode);
+	}
+	return OutNode;
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ParseClassFile(const FString& ClassFilePath)
+{
+	TArray<FString> Members = GetClassMembers();
+	Members.Add(TEXT("id"));
+	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFilePath, Members);
+	if (!ParsedClass)
+	{
+		return {};
+	}
+
+	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+	// Reusing the class template for now so renaming id to class_id to be consistent
+	if (TSharedPtr<FJsonValue> Field = ParsedClass->TryGetField(TEXT("id")))
+	{
+		OutNode->SetField("class_id", Field);
+	}
+
+	for (const FString& Member : GetClassMembers())
+	{
+		CopyJsonField(Member, ParsedClass, OutNode);
+	}
+	return OutNode;
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ParseStructFile(const FString& StructFilePath)
+{
+	TArray<FString> Members = GetClassMembers();
+	Members.Add(TEXT("id"));
+	TSharedPtr<FJsonObject> ParsedStruct = LoadFileToJson(StructFilePath, Members);
+	if (!ParsedStruct)
+	{
+		return {};
+	}
+	return ConvertStructDocument(ParsedStruct);
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ConvertStructDocument(TSharedPtr<FJsonObject> ParsedStruct)
+{
+	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+	// Reusing the class template for now so renaming id to class_id to be consistent
+	if (TSharedPtr<FJsonValue> Field = ParsedStruct->TryGetField(TEXT("id")))
+	{
+		OutNode->SetField(TEXT("class_id"), Field);
+	}
+
+	for (const FString& Member : GetClassMembers())
+	{
+		CopyJsonField(Member, ParsedStruct, OutNode);
+	}
+	return OutNode;
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ParseEnumFile(const FString& EnumFilePath)
+{
+	TSharedPtr<FJsonObject> ParsedEnum = LoadFileToJson(EnumFilePath, GetEnumMembers());
+	if (!ParsedEnum)
+	{
+		return {};
+	}
+
+	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
+	for (const FString& Member : GetEnumMembers())
+	{
+		CopyJsonField(Member, ParsedEnum, OutNode);
+	}
+	return OutNode;
+}
+
+void FDocGenConsolidator::CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode,
+										TSharedPtr<FJsonObject> OutNode)
+{
+	if (TSharedPtr<FJsonValue> Field = ParsedNode->TryGetField(FieldName))
+	{
+		OutNode->SetField(FieldName, Field);
+	}
+}
+
+TOptional<TArray<FString>> FDocGenConsolidator::GetNamesFromIndexFile(const FString& NameType,
+																	  const FString& ChildNameType,
+																	  TSharedPtr<FJsonObject> ParsedIndex)
+{
+	if (!ParsedIndex)
+	{
+		return {};
+	}
+	TArray<FString> ClassJsonFiles;
+	TArray<TSharedPtr<FJsonValue>> Entries;
+
+	const TArray<TSharedPtr<FJsonValue>>* ArrayEntries = nullptr;
+	if (ParsedIndex->TryGetArrayField(NameType, ArrayEntries))
+	{
+		Entries = *ArrayEntries;
+	}
+	// If there was only a single entry, it won't be added as an array and our code generator will fail later on.
+	else
+	{
+		const TSharedPtr<FJsonObject>* ArrayObjectEntry = nullptr;
+		if (ParsedIndex->TryGetObjectField(NameType, ArrayObjectEntry))
+		{
+			const TSharedPtr<FJsonObject>* ObjectEntry = nullptr;
+			// This is a special case where we're only storing a single object in the index
+			if ((*ArrayObjectEntry)->TryGetObjectField(ChildNameType, ObjectEntry))
+			{
+				// Wrap the object in a JsonValue for uniform processing
+				Entries.Add(MakeShared<FJsonValueObject>(*ObjectEntry));
+			}
+		}
+	}
+
+	for (const auto& Entry : Entries)
+	{
+		TOptional<FString> EnumID = GetObjectStringField(Entry, TEXT("id"));
+		if (EnumID.IsSet())
+		{
+			UE_LOG(LogKantanDocGen, Log, TEXT("Processing entry: %s"), *EnumID.GetValue());
+			ClassJsonFiles.Add(EnumID.GetValue());
+		}
+		else
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Entry missing 'id' field: %s"), *Entry->AsString());
+		}
+	}
+
+	if (ClassJsonFiles.Num())
+	{
+		return ClassJsonFiles;
+	}
+	else
+	{
+		return {};
+	}
+}
+
+EIntermediateProcessingResult FDocGenConsolidator::ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
+																	 DocGenJsonStreamWriter& Writer)
+{
+	TOptional<TArray<FString>> ClassNames = GetNamesFromIndexFile(TEXT("classes"), TEXT("class"), ParsedIndex);
+	if (!ClassNames.IsSet())
+	{
+		return EIntermediateProcessingResult::UnknownError;
+	}
+	const TArray<FString>& ClassNameList = ClassNames.GetValue();
+
+	// Static functions are listed separately from the classes they belong to but only known once a class has been
+	// parsed, so they're streamed to a fragment file and spliced in after the classes
+	const FString FunctionsFragmentPath = IntermediateDir / ConsolidatedFileName + TEXT(".functions.tmp");
+	TUniquePtr<FArchive> FunctionsFragment(IFileManager::Get().CreateFileWriter(*FunctionsFragmentPath));
+	if (!FunctionsFragment)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create %s"), *FunctionsFragmentPath);
+		return EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	ON_SCOPE_EXIT
+	{
+		FunctionsFragment.Reset();
+		IFileManager::Get().Delete(*FunctionsFragmentPath, false, true, true);
+	};
+	// The functions array sits directly in the top level object
+	DocGenJsonStreamWriter FunctionsWriter(*FunctionsFragment, !bCompactOutput, 2);
+	FunctionsWriter.SetStringTable(StringTable);
+
+	Writer.WriteKey(TEXT("classes"));
+	Writer.BeginObject();
+
+	// Files are loaded and parsed in parallel into per-entry slots, then written serially in index order so the
+	// consolidated output doesn't depend on which thread finished first. Going a batch of classes at a time keeps
+	// only that batch in memory.
+	struct FClassSlot
+	{
+		TSharedPtr<FJsonObject> ParsedClass;
+		TArray<FString> NodeNames;
+		int32 FirstNodeSlot = 0;
+	};
+	TArray<FClassSlot> ClassSlots;
+	TArray<int32> NodeClassIndices;
+	TArray<TSharedPtr<FJsonObject>> NodeSlots;
+	for (int32 BatchStart = 0; BatchStart < ClassNameList.Num(); BatchStart += ConsolidationBatchSize)
+	{
+		const int32 BatchSize = FMath::Min(ConsolidationBatchSize, ClassNameList.Num() - BatchStart);
+		ClassSlots.Reset();
+		ClassSlots.SetNum(BatchSize);
+		ParallelFor(BatchSize, [this, &ClassNameList, &ClassSlots, BatchStart](int32 SlotIndex) {
+			const FString& ClassName = ClassNameList[BatchStart + SlotIndex];
+			// Parsed once for both the node list and the class's own members
+			TSharedPtr<FJsonObject> ParsedClass =
+				LoadFileToJson(IntermediateDir / ClassName / ClassName + TEXT(".json"), GetClassAndNodeListMembers());
+			if (!ParsedClass)
+			{
+				return;
+			}
+			TOptional<TArray<FString>> NodeNames = GetNamesFromDocument(TEXT("nodes"), ParsedClass);
+			if (NodeNames.IsSet())
+			{
+				ClassSlots[SlotIndex].NodeNames = MoveTemp(NodeNames.GetValue());
+				ClassSlots[SlotIndex].ParsedClass = ConvertStructDocument(ParsedClass);
+			}
+		});
+
+		// Nodes of all classes in the batch share one pass, so a class with hundreds of nodes doesn't end up on a
+		// single thread
+		NodeClassIndices.Reset();
+		for (int32 SlotIndex = 0; SlotIndex < ClassSlots.Num(); ++SlotIndex)
+		{
+			FClassSlot& ClassSlot = ClassSlots[SlotIndex];
+			if (!ClassSlot.ParsedClass)
+			{
+				return EIntermediateProcessingResult::UnknownError;
+			}
+			ClassSlot.FirstNodeSlot = NodeClassIndices.Num();
+			NodeClassIndices.AddUninitialized(ClassSlot.NodeNames.Num());
+			for (int32 NodeSlot = ClassSlot.FirstNodeSlot; NodeSlot < NodeClassIndices.Num(); ++NodeSlot)
+			{
+				NodeClassIndices[NodeSlot] = SlotIndex;
+			}
+		}
+
+		NodeSlots.Reset();
+		NodeSlots.SetNum(NodeClassIndices.Num());
+		ParallelFor(NodeSlots.Num(),
+					[this, &ClassNameList, &ClassSlots, &NodeClassIndices, &NodeSlots, BatchStart](int32 NodeSlot) {
+						const FClassSlot& ClassSlot = ClassSlots[NodeClassIndices[NodeSlot]];
+						const FString& ClassName = ClassNameList[BatchStart + NodeClassIndices[NodeSlot]];
+						const FString& NodeName = ClassSlot.NodeNames[NodeSlot - ClassSlot.FirstNodeSlot];
+						const FString NodeDir = IntermediateDir / ClassName / TEXT("nodes");
+
+						TSharedPtr<FJsonObject> NodeJson = ParseNodeFile(NodeDir / NodeName + TEXT(".json"));
+						if (!NodeJson)
+						{
+							return;
+						}
+						FString RelImagePath;
+						if (ImageManifest && NodeJson->TryGetStringField(TEXT("imgpath"), RelImagePath))
+						{
+							PlaceNodeImage(FPaths::GetCleanFilename(RelImagePath));
+						}
+						NodeSlots[NodeSlot] = NodeJson;
+					});
+		if (NodeSlots.Contains(nullptr))
+		{
+			return EIntermediateProcessingResult::UnknownError;
+		}
+
+		for (int32 SlotIndex = 0; SlotIndex < ClassSlots.Num(); ++SlotIndex)
+		{
+			const FString& ClassName = ClassNameList[BatchStart + SlotIndex];
+			const FClassSlot& ClassSlot = ClassSlots[SlotIndex];
+			const TSharedPtr<FJsonObject>& ParsedClass = ClassSlot.ParsedClass;
+
+			Writer.WriteKey(ClassName);
+			Writer.BeginObject();
+			Writer.WriteKey(TEXT("functions"));
+			Writer.BeginArray();
+			for (int32 NodeSlot = ClassSlot.FirstNodeSlot;
+				 NodeSlot < ClassSlot.FirstNodeSlot + ClassSlot.NodeNames.Num(); ++NodeSlot)
+			{
+				const TSharedPtr<FJsonObject>& NodeJson = NodeSlots[NodeSlot];
+				bool FunctionIsStatic = false;
+				NodeJson->TryGetBoolField(TEXT("static"), FunctionIsStatic);
+
+				if (FunctionIsStatic)
+				{
+					FunctionsWriter.WriteJsonObject(NodeJson);
+				}
+				else
+				{
+					Writer.WriteJsonObject(NodeJson);
+				}
+			}
+			Writer.EndArray();
+			Writer.WriteKey(TEXT("class_id"));
+			Writer.WriteString(ClassName);
+			Writer.WriteKey(TEXT("display_name"));
+			Writer.WriteString(ParsedClass->GetStringField(TEXT("display_name")));
+			Writer.WriteKey(TEXT("meta"));
+			Writer.WriteJsonObject(ParsedClass->GetObjectField(TEXT("meta")));
+			Writer.WriteKey(TEXT("parent_class"));
+			Writer.WriteJsonObject(ParsedClass->GetObjectField(TEXT("parent_class")));
+			const TSharedPtr<FJsonObject>* DoxygenBlock;
+			if (ParsedClass->TryGetObjectField(TEXT("doxygen"), DoxygenBlock))
+			{
+				Writer.WriteKey(TEXT("doxygen"));
+				Writer.WriteJsonObject(*DoxygenBlock);
+			}
+			Writer.WriteKey(TEXT("fields"));
+			Writer.BeginArray();
+			const TArray<TSharedPtr<FJsonValue>>* FieldArray;
+			if (ParsedClass->TryGetArrayField(TEXT("fields"), FieldArray))
+			{
+				for (const TSharedPtr<FJsonValue>& Field : *FieldArray)
+				{
+					Writer.WriteJsonValue(Field);
+				}
+			}
+			Writer.EndArray();
+			Writer.EndObject();
+		}
+	}
+	Writer.EndObject();
+
+	if (!FunctionsWriter.Close())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s"), *FunctionsFragmentPath);
+		return EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	FunctionsFragment.Reset();
+	TUniquePtr<FArchive> FunctionsReader(IFileManager::Get().CreateFileReader(*FunctionsFragmentPath));
+	if (!FunctionsReader)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to read back %s"), *FunctionsFragmentPath);
+		return EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	Writer.WriteKey(TEXT("functions"));
+	Writer.BeginArray();
+	Writer.AppendArrayFragment(*FunctionsReader, FunctionsWriter.HasRootElements());
+	Writer.EndArray();
+	return EIntermediateProcessingResult::Success;
+}
+
+EIntermediateProcessingResult FDocGenConsolidator::ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
+																	 DocGenJsonStreamWriter& Writer)
+{
+	TOptional<TArray<FString>> StructNames = GetNamesFromIndexFile(TEXT("structs"), TEXT("struct"), ParsedIndex);
+	if (!StructNames.IsSet())
+	{
+		return EIntermediateProcessingResult::UnknownError;
+	}
+
+	Writer.WriteKey(TEXT("structs"));
+	WriteDocumentList(Writer, StructNames.GetValue(), [this](const FString& StructName) {
+		return ParseStructFile(IntermediateDir / StructName / StructName + TEXT(".json"));
+	});
+	return EIntermediateProcessingResult::Success;
+}
+
+EIntermediateProcessingResult FDocGenConsolidator::ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex,
+																   DocGenJsonStreamWriter& Writer)
+{
+	TOptional<TArray<FString>> EnumNames = GetNamesFromIndexFile(TEXT("enums"), TEXT("enum"), ParsedIndex);
+	if (!EnumNames.IsSet())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to get enum names from index file"));
+		return EIntermediateProcessingResult::UnknownError;
+	}
+
+	Writer.WriteKey(TEXT("enums"));
+	WriteDocumentList(Writer, EnumNames.GetValue(), [this](const FString& EnumName) {
+		UE_LOG(LogKantanDocGen, Log, TEXT("Processing enum: %s"), *EnumName);
+		return ParseEnumFile(IntermediateDir / EnumName / EnumName + TEXT(".json"));
+	});
+	return EIntermediateProcessingResult::Success;
+}
+
+void FDocGenConsolidator::WriteDocumentList(DocGenJsonStreamWriter& Writer, const TArray<FString>& Names,
+											TFunctionRef<TSharedPtr<FJsonObject>(const FString& Name)> ParseDocument)
+{
+	Writer.BeginArray();
+	TArray<TSharedPtr<FJsonObject>> Slots;
+	for (int32 BatchStart = 0; BatchStart < Names.Num(); BatchStart += ConsolidationBatchSize)
+	{
+		const int32 BatchSize = FMath::Min(ConsolidationBatchSize, Names.Num() - BatchStart);
+		Slots.Reset();
+		Slots.SetNum(BatchSize);
+		ParallelFor(BatchSize, [&Names, &Slots, &ParseDocument, BatchStart](int32 SlotIndex) {
+			Slots[SlotIndex] = ParseDocument(Names[BatchStart + SlotIndex]);
+		});
+		for (const TSharedPtr<FJsonObject>& Document : Slots)
+		{
+			Writer.WriteJsonObject(Document);
+		}
+	}
+	Writer.EndArray();
+}
+
+void FDocGenConsolidator::PlaceNodeImage(const FString& ImageId)
+{
+	const FDocGenImageManifest::FImage* Image = ImageManifest->Find(ImageId);
+	if (!Image)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Image %s is missing from the image manifest"), *ImageId);
+		return;
+	}
+	FDocGenImageManifest::EnqueuePlacement(*WriteQueue, OutputDir / TEXT("img") / ImageId, *Image, false);
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::LoadConsolidatedDocument()
+{
+	// Formats asking for it run on threads of their own
+	if (!DocGenThreads::bThreadSafeJson)
+	{
+		return ParseConsolidatedDocument();
+	}
+	FScopeLock Lock(&ConsolidatedDocumentLock);
+	if (bConsolidatedDocumentLoaded)
+	{
+		return ConsolidatedDocument;
+	}
+	// A failed load isn't retried either, every format would fail the same way
+	bConsolidatedDocumentLoaded = true;
+	ConsolidatedDocument = ParseConsolidatedDocument();
+	return ConsolidatedDocument;
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::ParseConsolidatedDocument() const
+{
+	const FString ConsolidatedPath = IntermediateDir / ConsolidatedFileName;
+	TSharedPtr<FDocGenJsonIndex> ConsolidatedFile = FDocGenJsonIndex::Open(ConsolidatedPath);
+	if (!ConsolidatedFile)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to read %s"), *ConsolidatedPath);
+		return nullptr;
+	}
+	// Failures are logged by the parse
+	return ConsolidatedFile->ParseResolvingStrings();
+}
+
+FString FDocGenConsolidator::GetStandaloneDocumentPath()
+{
+	if (!bUseStringTable)
+	{
+		return IntermediateDir / ConsolidatedFileName;
+	}
+	FScopeLock Lock(&StandaloneDocumentLock);
+	if (bStandaloneDocumentWritten)
+	{
+		return StandaloneDocumentPath;
+	}
+	bStandaloneDocumentWritten = true;
+
+	TSharedPtr<FJsonObject> Document = LoadConsolidatedDocument();
+	if (!Document)
+	{
+		return FString();
+	}
+	const FString Path = IntermediateDir / StandaloneFileName;
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*Path));
+	if (!File)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create %s"), *Path);
+		return FString();
+	}
+	DocGenJsonStreamWriter Writer(*File, !bCompactOutput);
+	Writer.WriteJsonObject(Document);
+	if (!Writer.Close())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s"), *Path);
+		return FString();
+	}
+	StandaloneDocumentPath = Path;
+	return StandaloneDocumentPath;
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::LoadFileToJson(FString const& FilePath)
+{
+	return IntermediateReader->LoadJson(FilePath);
+}
+
+TSharedPtr<FJsonObject> FDocGenConsolidator::LoadFileToJson(FString const& FilePath,
+															const TArray<FString>& MemberNames)
+{
+	return IntermediateReader->LoadJsonMembers(FilePath, MemberNames);
+}
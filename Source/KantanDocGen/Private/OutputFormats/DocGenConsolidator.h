@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+#include "OutputFormats/DocGenOutputProcessor.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+
+class DocGenJsonStreamWriter;
+
+/// @brief Merges the json intermediate documents of a run into the single consolidated document that the json based
+/// output formats render from. A task runs it once and shares the result between every format that needs it.
+class FDocGenConsolidator
+{
+public:
+	static const TCHAR* const ConsolidatedFileName;
+	// Copy of the consolidated document without a string table, see GetStandaloneDocumentPath
+	static const TCHAR* const StandaloneFileName;
+
+	/// @param IntermediateDir directory holding the intermediate documents, consolidated.json is written here too
+	/// @param OutputDir node images referenced by the documents are copied to its img subdirectory
+	/// @param OutputManifest lets unchanged consolidated.json and images be skipped, see FDocGenWriteQueue
+	/// @param DocModel, DocumentCache passed on to the FDocGenIntermediateReader loading the documents
+	FDocGenConsolidator(const FString& IntermediateDir, const FString& OutputDir,
+						TSharedPtr<class FDocGenOutputManifest> OutputManifest = nullptr,
+						TSharedPtr<class FDocGenDocModel> DocModel = nullptr,
+						TSharedPtr<class FDocGenParsedDocumentCache> DocumentCache = nullptr);
+
+	/// @brief Merges every document listed in the index, streaming the result to consolidated.json, and copies the
+	/// node images. Returns once all of it is on disk.
+	EIntermediateProcessingResult Consolidate();
+
+	/// @brief Writes consolidated.json without indentation or line breaks, for when only tools read it
+	void SetCompactOutput(bool bInCompactOutput)
+	{
+		bCompactOutput = bInCompactOutput;
+	}
+
+	/// @brief Stores long strings in consolidated.json once, in a string table the document refers to them by. See
+	/// FDocGenJsonStringTable, LoadConsolidatedDocument resolves the references.
+	void SetStringTable(bool bInUseStringTable)
+	{
+		bUseStringTable = bInUseStringTable;
+	}
+
+	const FString& GetIntermediateDir() const
+	{
+		return IntermediateDir;
+	}
+
+	/// @brief Parses consolidated.json the first time it's asked for, formats rendering from it in process share that
+	/// parse. The document must not be modified. Where json documents can't be shared between threads each call
+	/// parses it again.
+	/// @return the consolidated document, or nullptr if it couldn't be read or parsed
+	TSharedPtr<FJsonObject> LoadConsolidatedDocument();
+
+	/// @brief Path of the consolidated document for tools that read it themselves. With a string table, which they
+	/// can't resolve, that's a copy with every string in full written the first time it's asked for.
+	/// @return the path, or an empty string if the copy couldn't be written
+	FString GetStandaloneDocumentPath();
+
+private:
+	TOptional<FString> GetObjectStringField(const TSharedPtr<class FJsonValue> Obj, const FString& FieldName);
+	TOptional<FString> GetObjectStringField(const TSharedPtr<FJsonObject> Obj, const FString& FieldName);
+	/// @return the ids in the NameType member of ParsedDocument, unset if it has no such member
+	TOptional<TArray<FString>> GetNamesFromDocument(const FString& NameType, TSharedPtr<FJsonObject> ParsedDocument);
+	TOptional<TArray<FString>> GetNamesFromIndexFile(const FString& NameType, const FString& ChildNameType,
+													 TSharedPtr<FJsonObject> ParsedIndex);
+
+	TSharedPtr<FJsonObject> ParseNodeFile(const FString& NodeFilePath);
+	TSharedPtr<FJsonObject> ParseClassFile(const FString& ClassFilePath);
+	TSharedPtr<FJsonObject> ParseStructFile(const FString& StructFilePath);
+	/// @brief Picks the consolidated members out of an already parsed class or struct document
+	TSharedPtr<FJsonObject> ConvertStructDocument(TSharedPtr<FJsonObject> ParsedStruct);
+	TSharedPtr<FJsonObject> ParseEnumFile(const FString& EnumFilePath);
+	void CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode, TSharedPtr<FJsonObject> OutNode);
+
+	/// @brief Writes the whole consolidated document, leaves it unfinished on failure
+	EIntermediateProcessingResult WriteConsolidatedDocument(TSharedPtr<FJsonObject> ParsedIndex,
+															DocGenJsonStreamWriter& Writer);
+	EIntermediateProcessingResult ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
+													 DocGenJsonStreamWriter& Writer);
+	EIntermediateProcessingResult ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
+													 DocGenJsonStreamWriter& Writer);
+	EIntermediateProcessingResult ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex, DocGenJsonStreamWriter& Writer);
+	/// @brief Parses the documents in batches and writes each batch out before parsing the next one
+	void WriteDocumentList(DocGenJsonStreamWriter& Writer, const TArray<FString>& Names,
+						   TFunctionRef<TSharedPtr<FJsonObject>(const FString& Name)> ParseDocument);
+
+	TSharedPtr<FJsonObject> LoadFileToJson(FString const& FilePath);
+	/// @brief Loads only the top level members the caller is going to read, where the format allows it
+	TSharedPtr<FJsonObject> LoadFileToJson(FString const& FilePath, const TArray<FString>& MemberNames);
+	/// @brief Queues placing a node image in the img directory of the output
+	void PlaceNodeImage(const FString& ImageId);
+	TSharedPtr<FJsonObject> ParseConsolidatedDocument() const;
+
+	FString IntermediateDir;
+	FString OutputDir;
+	TSharedPtr<class FDocGenIntermediateReader> IntermediateReader;
+	TSharedPtr<class FDocGenWriteQueue> WriteQueue;
+	TSharedPtr<class FDocGenImageManifest> ImageManifest;
+	TSharedPtr<FDocGenOutputManifest> OutputManifest;
+	TSharedPtr<FDocGenDocModel> DocModel;
+	TSharedPtr<FDocGenParsedDocumentCache> DocumentCache;
+	bool bCompactOutput = false;
+	bool bUseStringTable = false;
+	TSharedPtr<class FDocGenJsonStringTable> StringTable;
+
+	FCriticalSection ConsolidatedDocumentLock;
+	TSharedPtr<FJsonObject> ConsolidatedDocument;
+	bool bConsolidatedDocumentLoaded = false;
+
+	FCriticalSection StandaloneDocumentLock;
+	FString StandaloneDocumentPath;
+	bool bStandaloneDocumentWritten = false;
+};
@@ -0,0 +1,350 @@
+#include "OutputFormats/DocGenHTMLRenderer.h"
+#include "Algo/StableSort.h"
+#include "DocGenUTF8.h"
+#include "OutputFormats/DocGenXMLReader.h"
+#include "Templates/Function.h"
+
+namespace
+{
+	/// @brief Builds a page one line at a time, indenting block elements with tabs
+	class FHTMLPageBuilder
+	{
+	public:
+		/// @brief Writes everything up to and including the opening tag of the content container
+		FHTMLPageBuilder(const FString& Title, const TCHAR* StylesheetPath)
+		{
+			Page.Reserve(4096);
+			Page += TEXT("<html>");
+			++Depth;
+			Open(TEXT("<head>"));
+			Line(TEXT("<meta http-equiv=\"Content-Type\" content=\"text/html; charset=UTF-8\">"));
+			Line(TEXT("<title>"));
+			AppendText(Title);
+			Append(TEXT("</title>"));
+			Line(TEXT("<link rel=\"stylesheet\" type=\"text/css\""));
+			AppendAttribute(TEXT("href"), StylesheetPath);
+			Append(TEXT(">"));
+			Close(TEXT("</head>"));
+			Open(TEXT("<body>"));
+			Open(TEXT("<div id=\"content_container\">"));
+		}
+
+		/// @brief Starts a new line at the current depth and writes Markup to it
+		void Line(const TCHAR* Markup)
+		{
+			Page += LINE_TERMINATOR;
+			for (int32 Level = 0; Level < Depth; ++Level)
+			{
+				Page += TEXT('\t');
+			}
+			Page += Markup;
+		}
+
+		/// @brief Writes the opening tag of a block element on a line of its own, its content goes one level deeper
+		void Open(const TCHAR* Markup)
+		{
+			Line(Markup);
+			++Depth;
+		}
+
+		void Close(const TCHAR* Markup)
+		{
+			--Depth;
+			Line(Markup);
+		}
+
+		void Append(const TCHAR* Markup)
+		{
+			Page += Markup;
+		}
+
+		void AppendText(const FString& Text)
+		{
+			AppendText(*Text, Text.Len());
+		}
+
+		void AppendText(const TCHAR* Text, int32 Len)
+		{
+			const TCHAR* Start = Text;
+			const TCHAR* const End = Text + Len;
+			for (const TCHAR* Current = Text; Current < End; ++Current)
+			{
+				const TCHAR* Entity = nullptr;
+				switch (*Current)
+				{
+					case TEXT('&'):
+						Entity = TEXT("&amp;");
+						break;
+					case TEXT('<'):
+						Entity = TEXT("&lt;");
+						break;
+					case TEXT('>'):
+						Entity = TEXT("&gt;");
+						break;
+					case TEXT('"'):
+						Entity = TEXT("&quot;");
+						break;
+					default:
+						break;
+				}
+				if (Entity)
+				{
+					Page.AppendChars(Start, Current - Start);
+					Page += Entity;
+					Start = Current + 1;
+				}
+			}
+			Page.AppendChars(Start, End - Start);
+		}
+
+		/// @brief Writes a space separated attribute into a start tag that is still open
+		void AppendAttribute(const TCHAR* Name, const FString& Value)
+		{
+			Page += TEXT(' ');
+			Page += Name;
+			Page += TEXT("=\"");
+			AppendText(Value);
+			Page += TEXT('"');
+		}
+
+		/// @brief Closes the content container and the document
+		/// @return the page encoded as UTF-8
+		TArray<uint8> Finish()
+		{
+			Close(TEXT("</div>"));
+			Close(TEXT("</body>"));
+			Close(TEXT("</html>"));
+			Page += LINE_TERMINATOR;
+
+			return DocGenUTF8::FromString(Page);
+		}
+
+	private:
+		FString Page;
+		int32 Depth = 0;
+	};
+
+	void AppendNavbarItem(FHTMLPageBuilder& Builder, const FString& Text, const FString& Href = FString())
+	{
+		Builder.Line(TEXT("<a class=\"navbar_style\""));
+		if (!Href.IsEmpty())
+		{
+			Builder.AppendAttribute(TEXT("href"), Href);
+		}
+		Builder.Append(TEXT(">"));
+		Builder.AppendText(Text);
+		Builder.Append(TEXT("</a>"));
+	}
+
+	/// @brief Writes a table listing links to the given children of Parent, ordered by the text of their SortKey
+	/// child like xsl:sort orders them
+	void AppendLinkTable(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Parent, const TCHAR* ChildName,
+						 const TCHAR* SortKey, TFunctionRef<FString(const FString& Id)> MakeHref)
+	{
+		TArray<const FDocGenXMLElement*> Entries;
+		for (const FDocGenXMLElement& Child : Parent.Children)
+		{
+			if (Child.Name == ChildName)
+			{
+				Entries.Add(&Child);
+			}
+		}
+		Algo::StableSort(Entries, [SortKey](const FDocGenXMLElement* A, const FDocGenXMLElement* B) {
+			return A->GetChildText(SortKey).Compare(B->GetChildText(SortKey), ESearchCase::CaseSensitive) < 0;
+		});
+
+		Builder.Open(TEXT("<table>"));
+		Builder.Open(TEXT("<tbody>"));
+		for (const FDocGenXMLElement* Entry : Entries)
+		{
+			Builder.Open(TEXT("<tr>"));
+			Builder.Open(TEXT("<td>"));
+			Builder.Line(TEXT("<a"));
+			Builder.AppendAttribute(TEXT("href"), MakeHref(Entry->GetChildText(TEXT("id"))));
+			Builder.Append(TEXT(">"));
+			Builder.AppendText(Entry->GetChildText(SortKey));
+			Builder.Append(TEXT("</a>"));
+			Builder.Close(TEXT("</td>"));
+			Builder.Close(TEXT("</tr>"));
+		}
+		Builder.Close(TEXT("</tbody>"));
+		Builder.Close(TEXT("</table>"));
+	}
+
+	/// @brief The text() template of node_docs_xform.xsl: whitespace-only text is dropped, anything else is trimmed
+	/// and gets a line break wherever it had a newline
+	void AppendNodeDocText(FHTMLPageBuilder& Builder, const FString& Text)
+	{
+		const FString Trimmed = Text.TrimStartAndEnd();
+		const TCHAR* LineStart = *Trimmed;
+		const TCHAR* Current = LineStart;
+		for (; *Current; ++Current)
+		{
+			if (*Current == TEXT('\n'))
+			{
+				Builder.AppendText(LineStart, Current - LineStart);
+				Builder.Append(TEXT("<br>"));
+				LineStart = Current + 1;
+			}
+		}
+		Builder.AppendText(LineStart, Current - LineStart);
+	}
+
+	void RenderNodeDocElement(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Element);
+
+	/// @brief xsl:apply-templates on the content of Element
+	void ApplyNodeDocTemplates(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Element)
+	{
+		if (Element.Children.Num() == 0)
+		{
+			AppendNodeDocText(Builder, Element.Text);
+			return;
+		}
+		for (const FDocGenXMLElement& Child : Element.Children)
+		{
+			RenderNodeDocElement(Builder, Child);
+		}
+	}
+
+	void RenderNodeDocParam(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Param)
+	{
+		Builder.Open(TEXT("<tr>"));
+		Builder.Open(TEXT("<td>"));
+		Builder.Line(TEXT("<div class=\"param_name title_style\">"));
+		if (const FDocGenXMLElement* Name = Param.FindChild(TEXT("name")))
+		{
+			ApplyNodeDocTemplates(Builder, *Name);
+		}
+		Builder.Append(TEXT("</div>"));
+		Builder.Line(TEXT("<div class=\"param_type\">"));
+		if (const FDocGenXMLElement* Type = Param.FindChild(TEXT("type")))
+		{
+			ApplyNodeDocTemplates(Builder, *Type);
+		}
+		Builder.Append(TEXT("</div>"));
+		Builder.Close(TEXT("</td>"));
+		Builder.Open(TEXT("<td>"));
+		if (const FDocGenXMLElement* Description = Param.FindChild(TEXT("description")))
+		{
+			RenderNodeDocElement(Builder, *Description);
+		}
+		Builder.Close(TEXT("</td>"));
+		Builder.Close(TEXT("</tr>"));
+	}
+
+	/// @brief The parameters template shared by the inputs and outputs sections
+	void RenderNodeDocParameters(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Parameters)
+	{
+		Builder.Open(TEXT("<table>"));
+		Builder.Open(TEXT("<colgroup>"));
+		Builder.Line(TEXT("<col width=\"25%\">"));
+		Builder.Line(TEXT("<col width=\"75%\">"));
+		Builder.Close(TEXT("</colgroup>"));
+		Builder.Open(TEXT("<tbody>"));
+		ApplyNodeDocTemplates(Builder, Parameters);
+		Builder.Close(TEXT("</tbody>"));
+		Builder.Close(TEXT("</table>"));
+	}
+
+	/// @brief Dispatches Element to the node_docs_xform.xsl template matching its name. Elements without a template
+	/// of their own fall back to the built-in rule, which outputs their text.
+	void RenderNodeDocElement(FHTMLPageBuilder& Builder, const FDocGenXMLElement& Element)
+	{
+		const FString& Name = Element.Name;
+		if (Name == TEXT("shorttitle"))
+		{
+			Builder.Line(TEXT("<h1 class=\"title_style\">"));
+			ApplyNodeDocTemplates(Builder, Element);
+			Builder.Append(TEXT("</h1>"));
+		}
+		else if (Name == TEXT("description"))
+		{
+			Builder.Line(TEXT("<p>"));
+			ApplyNodeDocTemplates(Builder, Element);
+			Builder.Append(TEXT("</p>"));
+		}
+		else if (Name == TEXT("imgpath"))
+		{
+			Builder.Line(TEXT("<img"));
+			Builder.AppendAttribute(TEXT("src"), Element.Text.TrimStartAndEnd());
+			Builder.Append(TEXT(">"));
+		}
+		else if (Name == TEXT("param"))
+		{
+			RenderNodeDocParam(Builder, Element);
+		}
+		else if (Name == TEXT("inputs") || Name == TEXT("outputs"))
+		{
+			Builder.Line(Name == TEXT("inputs") ? TEXT("<h3 class=\"title_style\">Inputs</h3>")
+												: TEXT("<h3 class=\"title_style\">Outputs</h3>"));
+			RenderNodeDocParameters(Builder, Element);
+		}
+		else if (Name == TEXT("category") || Name == TEXT("fulltitle") || Name == TEXT("docs_name") ||
+				 Name == TEXT("class_id") || Name == TEXT("class_name"))
+		{
+			// Unwanted elements
+		}
+		else if (Element.Children.Num() == 0)
+		{
+			if (!Element.Text.TrimStartAndEnd().IsEmpty())
+			{
+				Builder.Line(TEXT(""));
+				AppendNodeDocText(Builder, Element.Text);
+			}
+		}
+		else
+		{
+			ApplyNodeDocTemplates(Builder, Element);
+		}
+	}
+} // namespace
+
+TArray<uint8> FDocGenHTMLRenderer::RenderIndexPage(const FDocGenXMLElement& Index)
+{
+	const FString& DisplayName = Index.GetChildText(TEXT("display_name"));
+	FHTMLPageBuilder Builder(DisplayName, TEXT("./css/bpdoc.css"));
+	AppendNavbarItem(Builder, DisplayName);
+	Builder.Line(TEXT("<h1 class=\"title_style\">"));
+	Builder.AppendText(DisplayName);
+	Builder.Append(TEXT("</h1>"));
+	if (const FDocGenXMLElement* Classes = Index.FindChild(TEXT("classes")))
+	{
+		Builder.Line(TEXT("<h2 class=\"title_style\">Classes</h2>"));
+		AppendLinkTable(Builder, *Classes, TEXT("class"), TEXT("display_name"),
+						[](const FString& Id) { return TEXT("./") + Id + TEXT("/") + Id + TEXT(".html"); });
+	}
+	return Builder.Finish();
+}
+
+TArray<uint8> FDocGenHTMLRenderer::RenderClassPage(const FDocGenXMLElement& ClassDoc)
+{
+	const FString& DisplayName = ClassDoc.GetChildText(TEXT("display_name"));
+	FHTMLPageBuilder Builder(DisplayName, TEXT("../css/bpdoc.css"));
+	AppendNavbarItem(Builder, ClassDoc.GetChildText(TEXT("docs_name")), TEXT("../index.html"));
+	AppendNavbarItem(Builder, TEXT(">"));
+	AppendNavbarItem(Builder, DisplayName);
+	Builder.Line(TEXT("<h1 class=\"title_style\">"));
+	Builder.AppendText(DisplayName);
+	Builder.Append(TEXT("</h1>"));
+	if (const FDocGenXMLElement* Nodes = ClassDoc.FindChild(TEXT("nodes")))
+	{
+		Builder.Line(TEXT("<h2 class=\"title_style\">Nodes</h2>"));
+		AppendLinkTable(Builder, *Nodes, TEXT("node"), TEXT("shorttitle"),
+						[](const FString& Id) { return TEXT("./nodes/") + Id + TEXT(".html"); });
+	}
+	return Builder.Finish();
+}
+
+TArray<uint8> FDocGenHTMLRenderer::RenderNodePage(const FDocGenXMLElement& NodeDoc)
+{
+	const FString& ShortTitle = NodeDoc.GetChildText(TEXT("shorttitle"));
+	FHTMLPageBuilder Builder(ShortTitle, TEXT("../../css/bpdoc.css"));
+	AppendNavbarItem(Builder, NodeDoc.GetChildText(TEXT("docs_name")), TEXT("../../index.html"));
+	AppendNavbarItem(Builder, TEXT(">"));
+	AppendNavbarItem(Builder, NodeDoc.GetChildText(TEXT("class_name")),
+					 TEXT("../") + NodeDoc.GetChildText(TEXT("class_id")) + TEXT(".html"));
+	AppendNavbarItem(Builder, TEXT(">"));
+	AppendNavbarItem(Builder, ShortTitle);
+	ApplyNodeDocTemplates(Builder, NodeDoc);
+	return Builder.Finish();
+}
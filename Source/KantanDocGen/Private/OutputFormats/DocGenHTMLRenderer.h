@@ -0,0 +1,24 @@
+#pragma once
+#include "Containers/Array.h"
+#include "CoreMinimal.h"
+
+struct FDocGenXMLElement;
+
+/// @brief Renders the html pages of the XML output format from its intermediate documents. Each page mirrors what the
+/// corresponding KantanDocGenTool stylesheet (index_xform.xsl, class_docs_xform.xsl, node_docs_xform.xsl) produces
+/// for the same document. Rendering keeps no state, so any number of pages can be rendered concurrently.
+class FDocGenHTMLRenderer
+{
+public:
+	/// @param Index parsed index.xml
+	/// @return the page as UTF-8, written to index.html at the root of the output directory
+	static TArray<uint8> RenderIndexPage(const FDocGenXMLElement& Index);
+
+	/// @param ClassDoc parsed <class id>/<class id>.xml
+	/// @return the page as UTF-8, written to <class id>/<class id>.html
+	static TArray<uint8> RenderClassPage(const FDocGenXMLElement& ClassDoc);
+
+	/// @param NodeDoc parsed <class id>/nodes/<node id>.xml
+	/// @return the page as UTF-8, written to <class id>/nodes/<node id>.html
+	static TArray<uint8> RenderNodePage(const FDocGenXMLElement& NodeDoc);
+};
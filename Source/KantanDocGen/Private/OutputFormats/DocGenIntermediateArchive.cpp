@@ -0,0 +1,245 @@
+#include "OutputFormats/DocGenIntermediateArchive.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+
+FString DocGenIntermediateArchive::MakeEntryPath(const FString& IntermediateDir, const FString& FilePath)
+{
+	FString RelativePath = FilePath;
+	FPaths::NormalizeFilename(RelativePath);
+	FString NormalizedDir = IntermediateDir;
+	FPaths::NormalizeDirectoryName(NormalizedDir);
+	FPaths::MakePathRelativeTo(RelativePath, *(NormalizedDir + TEXT("/")));
+	return RelativePath;
+}
+
+FDocGenIntermediateArchiveWriter::~FDocGenIntermediateArchiveWriter()
+{
+	if (Writer)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Intermediate pack %s was never finalized"), *FilePath);
+		Writer->Close();
+	}
+}
+
+TSharedPtr<FDocGenIntermediateArchiveWriter> FDocGenIntermediateArchiveWriter::Create(const FString& FilePath,
+																					  bool bCompress)
+{
+	TSharedPtr<FDocGenIntermediateArchiveWriter> Archive = MakeShareable(new FDocGenIntermediateArchiveWriter());
+	Archive->Writer.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Archive->Writer)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Unable to create intermediate pack %s"), *FilePath);
+		return nullptr;
+	}
+	Archive->FilePath = FilePath;
+	Archive->bCompress = bCompress;
+
+	uint32 Magic = DocGenIntermediateArchive::Magic;
+	uint16 Version = DocGenIntermediateArchive::Version;
+	uint16 Reserved = 0;
+	*Archive->Writer << Magic << Version << Reserved;
+	return Archive;
+}
+
+bool FDocGenIntermediateArchiveWriter::Append(const FString& RelativePath, const TArray<uint8>& Bytes)
+{
+	DocGenIntermediateArchive::FEntry Entry;
+	Entry.RelativePath = RelativePath;
+	Entry.RawSize = Bytes.Num();
+
+	TArray<uint8> CompressedBytes;
+	if (bCompress && Bytes.Num())
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Bytes.Num());
+		CompressedBytes.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Zlib, CompressedBytes.GetData(), CompressedSize, Bytes.GetData(),
+										 Bytes.Num()) &&
+			CompressedSize < Bytes.Num())
+		{
+			CompressedBytes.SetNum(CompressedSize);
+			Entry.bCompressed = 1;
+		}
+	}
+	const TArray<uint8>& StoredBytes = Entry.bCompressed ? CompressedBytes : Bytes;
+	Entry.StoredSize = StoredBytes.Num();
+
+	FScopeLock Lock(&WriterLock);
+	if (!Writer)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Tried to add %s to intermediate pack %s after it was finalized"),
+			   *RelativePath, *FilePath);
+		return false;
+	}
+	Entry.Offset = Writer->Tell();
+	Writer->Serialize(const_cast<uint8*>(StoredBytes.GetData()), StoredBytes.Num());
+	if (Writer->IsError())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write %s to intermediate pack %s"), *RelativePath, *FilePath);
+		return false;
+	}
+
+	if (int32* ExistingIndex = EntryIndices.Find(RelativePath))
+	{
+		Entries[*ExistingIndex] = MoveTemp(Entry);
+	}
+	else
+	{
+		EntryIndices.Add(RelativePath, Entries.Add(MoveTemp(Entry)));
+	}
+	return true;
+}
+
+bool FDocGenIntermediateArchiveWriter::Finalize()
+{
+	FScopeLock Lock(&WriterLock);
+	if (!Writer)
+	{
+		return false;
+	}
+
+	// Entries were appended from whichever thread finished first, keep the index in path order
+	Entries.Sort([](const DocGenIntermediateArchive::FEntry& A, const DocGenIntermediateArchive::FEntry& B) {
+		return A.RelativePath.Compare(B.RelativePath, ESearchCase::CaseSensitive) < 0;
+	});
+	EntryIndices.Reset();
+
+	int64 IndexOffset = Writer->Tell();
+	for (DocGenIntermediateArchive::FEntry& Entry : Entries)
+	{
+		*Writer << Entry;
+	}
+	uint32 EntryCount = Entries.Num();
+	uint32 Magic = DocGenIntermediateArchive::Magic;
+	*Writer << IndexOffset << EntryCount << Magic;
+
+	const bool bSucceeded = Writer->Close();
+	Writer.Reset();
+	if (!bSucceeded)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write index of intermediate pack %s"), *FilePath);
+	}
+	return bSucceeded;
+}
+
+TSharedPtr<FDocGenIntermediateArchiveReader> FDocGenIntermediateArchiveReader::Open(const FString& FilePath)
+{
+	TSharedPtr<FDocGenIntermediateArchiveReader> Archive = MakeShareable(new FDocGenIntermediateArchiveReader());
+	Archive->FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+	if (!Archive->FileHandle)
+	{
+		return nullptr;
+	}
+	Archive->FilePath = FilePath;
+
+	const int64 FileSize = Archive->FileHandle->Size();
+	TArray<uint8> Header;
+	Header.SetNumUninitialized(sizeof(uint32) + sizeof(uint16) + sizeof(uint16));
+	TArray<uint8> Footer;
+	Footer.SetNumUninitialized(DocGenIntermediateArchive::FooterSize);
+	if (FileSize < Header.Num() + Footer.Num() || !Archive->FileHandle->Read(Header.GetData(), Header.Num()) ||
+		!Archive->FileHandle->Seek(FileSize - Footer.Num()) ||
+		!Archive->FileHandle->Read(Footer.GetData(), Footer.Num()))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Intermediate pack %s is truncated"), *FilePath);
+		return nullptr;
+	}
+
+	uint32 HeaderMagic = 0;
+	uint16 Version = 0;
+	FMemoryReader HeaderReader(Header);
+	HeaderReader << HeaderMagic << Version;
+
+	int64 IndexOffset = 0;
+	uint32 EntryCount = 0;
+	uint32 FooterMagic = 0;
+	FMemoryReader FooterReader(Footer);
+	FooterReader << IndexOffset << EntryCount << FooterMagic;
+
+	if (HeaderMagic != DocGenIntermediateArchive::Magic || FooterMagic != DocGenIntermediateArchive::Magic ||
+		Version != DocGenIntermediateArchive::Version)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("%s is not a finalized version %u intermediate pack"), *FilePath,
+			   DocGenIntermediateArchive::Version);
+		return nullptr;
+	}
+	const int64 IndexSize = FileSize - Footer.Num() - IndexOffset;
+	if (IndexOffset < Header.Num() || IndexSize < 0 || IndexSize > MAX_int32)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Intermediate pack %s has a corrupt index"), *FilePath);
+		return nullptr;
+	}
+
+	TArray<uint8> Index;
+	Index.SetNumUninitialized(IndexSize);
+	if (!Archive->FileHandle->Seek(IndexOffset) || !Archive->FileHandle->Read(Index.GetData(), Index.Num()))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to read index of intermediate pack %s"), *FilePath);
+		return nullptr;
+	}
+	FMemoryReader IndexReader(Index);
+	Archive->Entries.Reserve(EntryCount);
+	for (uint32 EntryIndex = 0; EntryIndex < EntryCount && !IndexReader.IsError(); ++EntryIndex)
+	{
+		DocGenIntermediateArchive::FEntry Entry;
+		IndexReader << Entry;
+		if (Entry.Offset < Header.Num() || Entry.StoredSize < 0 || Entry.Offset + Entry.StoredSize > IndexOffset)
+		{
+			IndexReader.SetError();
+			break;
+		}
+		Archive->Entries.Add(Entry.RelativePath, MoveTemp(Entry));
+	}
+	if (IndexReader.IsError())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Intermediate pack %s has a corrupt index"), *FilePath);
+		return nullptr;
+	}
+	return Archive;
+}
+
+bool FDocGenIntermediateArchiveReader::Contains(const FString& RelativePath) const
+{
+	return Entries.Contains(RelativePath);
+}
+
+bool FDocGenIntermediateArchiveReader::Read(const FString& RelativePath, TArray<uint8>& OutBytes) const
+{
+	const DocGenIntermediateArchive::FEntry* Entry = Entries.Find(RelativePath);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	TArray<uint8> StoredBytes;
+	StoredBytes.SetNumUninitialized(Entry->StoredSize);
+	{
+		FScopeLock Lock(&ReaderLock);
+		if (!FileHandle->Seek(Entry->Offset) || !FileHandle->Read(StoredBytes.GetData(), StoredBytes.Num()))
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to read %s from intermediate pack %s"), *RelativePath,
+				   *FilePath);
+			return false;
+		}
+	}
+
+	if (!Entry->bCompressed)
+	{
+		OutBytes = MoveTemp(StoredBytes);
+		return true;
+	}
+	OutBytes.SetNumUninitialized(Entry->RawSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, OutBytes.GetData(), OutBytes.Num(), StoredBytes.GetData(),
+										StoredBytes.Num()))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to decompress %s from intermediate pack %s"), *RelativePath,
+			   *FilePath);
+		return false;
+	}
+	return true;
+}
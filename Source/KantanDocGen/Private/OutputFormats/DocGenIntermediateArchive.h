@@ -0,0 +1,104 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/UniquePtr.h"
+
+/*
+Single-file pack holding every json intermediate document, written when FKantanDocGenSettings::bPackIntermediateFiles
+is set so a run no longer creates (and Defender no longer scans) one file per node.
+
+Documents are appended to the pack in whatever order generator threads finish them. Each entry is stored raw or,
+when bCompressIntermediatePack is set and it actually saves space, zlib compressed on its own so entries can be
+read independently. The index is written once, after the last entry.
+	Header		uint32 Magic ('KDGP'), uint16 Version, uint16 Reserved
+	Entries		stored bytes, back to back
+	Index		EntryCount x (FString RelativePath, int64 Offset, int32 StoredSize, int32 RawSize, uint8 bCompressed)
+	Footer		int64 IndexOffset, uint32 EntryCount, uint32 Magic
+Appending the same path twice is allowed, the index points at the latest copy.
+*/
+namespace DocGenIntermediateArchive
+{
+	static constexpr uint32 Magic = 0x5047444B;
+	// Bump whenever the layout above changes, readers reject any other version
+	static constexpr uint16 Version = 1;
+	static constexpr int64 FooterSize = sizeof(int64) + sizeof(uint32) + sizeof(uint32);
+	static const TCHAR* const PackFileName = TEXT("intermediate.kdgpack");
+
+	struct FEntry
+	{
+		FString RelativePath;
+		int64 Offset = 0;
+		int32 StoredSize = 0;
+		int32 RawSize = 0;
+		uint8 bCompressed = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			Ar << Entry.RelativePath << Entry.Offset << Entry.StoredSize << Entry.RawSize << Entry.bCompressed;
+			return Ar;
+		}
+	};
+
+	/// @brief Converts a path below the intermediate directory to the form used as an index key
+	FString MakeEntryPath(const FString& IntermediateDir, const FString& FilePath);
+} // namespace DocGenIntermediateArchive
+
+/// @brief Appends documents to a pack file. Safe to call Append from any number of threads.
+class FDocGenIntermediateArchiveWriter
+{
+public:
+	~FDocGenIntermediateArchiveWriter();
+
+	/// @brief Creates (or truncates) the pack file
+	/// @param FilePath location of the pack
+	/// @param bCompress whether entries should be zlib compressed
+	/// @return the writer, or nullptr if the file couldn't be opened for writing
+	static TSharedPtr<FDocGenIntermediateArchiveWriter> Create(const FString& FilePath, bool bCompress);
+
+	/// @brief Appends a document, compression happens on the calling thread before the pack is locked
+	/// @param RelativePath index key for the document, see DocGenIntermediateArchive::MakeEntryPath
+	/// @param Bytes document contents
+	/// @return false if the write failed or the pack was already finalized
+	bool Append(const FString& RelativePath, const TArray<uint8>& Bytes);
+
+	/// @brief Writes the index and footer and closes the pack. No entries can be appended afterwards.
+	bool Finalize();
+
+private:
+	FDocGenIntermediateArchiveWriter() = default;
+
+	FCriticalSection WriterLock;
+	TUniquePtr<FArchive> Writer;
+	TArray<DocGenIntermediateArchive::FEntry> Entries;
+	TMap<FString, int32> EntryIndices;
+	FString FilePath;
+	bool bCompress = false;
+};
+
+/// @brief Random access to the documents in a finalized pack. Safe to read from any number of threads.
+class FDocGenIntermediateArchiveReader
+{
+public:
+	/// @brief Opens a pack and loads its index
+	/// @return the reader, or nullptr if there is no valid pack at FilePath
+	static TSharedPtr<FDocGenIntermediateArchiveReader> Open(const FString& FilePath);
+
+	/// @brief Returns whether the pack holds a document for the given key
+	bool Contains(const FString& RelativePath) const;
+
+	/// @brief Reads and decompresses a document
+	/// @return false if the document isn't in the pack or couldn't be read
+	bool Read(const FString& RelativePath, TArray<uint8>& OutBytes) const;
+
+private:
+	FDocGenIntermediateArchiveReader() = default;
+
+	mutable FCriticalSection ReaderLock;
+	TUniquePtr<class IFileHandle> FileHandle;
+	TMap<FString, DocGenIntermediateArchive::FEntry> Entries;
+	FString FilePath;
+};
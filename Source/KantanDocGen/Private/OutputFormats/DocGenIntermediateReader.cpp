@@ -0,0 +1,135 @@
+#include "OutputFormats/DocGenIntermediateReader.h"
+#include "DocGenDocModel.h"
+#include "DocGenOutputManifest.h"
+#include "HAL/FileManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenBinaryFormat.h"
+#include "OutputFormats/DocGenIntermediateArchive.h"
+#include "OutputFormats/DocGenJsonIndex.h"
+#include "OutputFormats/DocGenParsedDocumentCache.h"
+
+FDocGenIntermediateReader::FDocGenIntermediateReader(const FString& IntermediateDir,
+													 TSharedPtr<FDocGenDocModel> DocModel,
+													 TSharedPtr<FDocGenParsedDocumentCache> DocumentCache)
+	: IntermediateDir(IntermediateDir),
+	  DocModel(DocModel),
+	  DocumentCache(DocumentCache)
+{
+	const FString PackPath = IntermediateDir / DocGenIntermediateArchive::PackFileName;
+	if (IFileManager::Get().FileExists(*PackPath))
+	{
+		Pack = FDocGenIntermediateArchiveReader::Open(PackPath);
+	}
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::LoadJson(const FString& JsonFilePath) const
+{
+	return LoadDocument(JsonFilePath, nullptr);
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::LoadJsonMembers(const FString& JsonFilePath,
+																   const TArray<FString>& MemberNames) const
+{
+	return LoadDocument(JsonFilePath, &MemberNames);
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::LoadDocument(const FString& JsonFilePath,
+																const TArray<FString>* MemberNames) const
+{
+	if (DocModel)
+	{
+		if (TSharedPtr<FJsonObject> GeneratedDocument = DocModel->LoadJson(JsonFilePath))
+		{
+			return GeneratedDocument;
+		}
+	}
+
+	if (Pack)
+	{
+		if (TSharedPtr<FJsonObject> PackedFile = LoadJsonFromPack(JsonFilePath, MemberNames))
+		{
+			return PackedFile;
+		}
+	}
+
+	// Prefer the binary encoding when the generator wrote one, it skips tokenizing entirely
+	if (TSharedPtr<FDocGenBinaryDocument> BinaryFile = FDocGenBinaryDocument::OpenSibling(JsonFilePath))
+	{
+		return ParseCached(JsonFilePath, BinaryFile->GetContentHash(), BinaryFile->GetSize(),
+						   [&BinaryFile]() { return BinaryFile->ToJsonObject(); });
+	}
+
+	TSharedPtr<FDocGenJsonIndex> TextFile = FDocGenJsonIndex::Open(JsonFilePath);
+	if (!TextFile)
+	{
+		return nullptr;
+	}
+	return ParseText(JsonFilePath, TextFile, MemberNames);
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::LoadJsonFromPack(const FString& JsonFilePath,
+																	const TArray<FString>* MemberNames) const
+{
+	TArray<uint8> Bytes;
+	const FString BinaryEntryPath = DocGenIntermediateArchive::MakeEntryPath(
+		IntermediateDir, FPaths::ChangeExtension(JsonFilePath, DocGenBinarySerializer::FileExtension));
+	if (Pack->Read(BinaryEntryPath, Bytes))
+	{
+		const uint64 ContentHash = FDocGenOutputManifest::HashBytes(Bytes.GetData(), Bytes.Num());
+		const int64 SourceBytes = Bytes.Num();
+		return ParseCached(JsonFilePath, ContentHash, SourceBytes, [&Bytes, &BinaryEntryPath]() {
+			TSharedPtr<FDocGenBinaryDocument> Document =
+				FDocGenBinaryDocument::FromBuffer(MoveTemp(Bytes), BinaryEntryPath);
+			return Document ? Document->ToJsonObject() : nullptr;
+		});
+	}
+
+	const FString JsonEntryPath = DocGenIntermediateArchive::MakeEntryPath(IntermediateDir, JsonFilePath);
+	if (Pack->Read(JsonEntryPath, Bytes))
+	{
+		return ParseText(JsonFilePath, FDocGenJsonIndex::FromBuffer(MoveTemp(Bytes), JsonEntryPath), MemberNames);
+	}
+	return nullptr;
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::ParseText(const FString& JsonFilePath,
+															 TSharedPtr<FDocGenJsonIndex> TextFile,
+															 const TArray<FString>* MemberNames) const
+{
+	if (MemberNames)
+	{
+		// A whole parse cached by an earlier reader has every member asked for
+		if (DocumentCache)
+		{
+			if (TSharedPtr<FJsonObject> CachedDocument = DocumentCache->Find(JsonFilePath, TextFile->GetContentHash()))
+			{
+				return CachedDocument;
+			}
+		}
+		// Whatever wasn't asked for is missing, so the result can't stand in for the document in the cache
+		return TextFile->ParseMembers(*MemberNames);
+	}
+	return ParseCached(JsonFilePath, TextFile->GetContentHash(), TextFile->GetSize(),
+					   [&TextFile]() { return TextFile->Parse(); });
+}
+
+TSharedPtr<FJsonObject> FDocGenIntermediateReader::ParseCached(const FString& JsonFilePath, uint64 ContentHash,
+															   int64 SourceBytes,
+															   TFunctionRef<TSharedPtr<FJsonObject>()> Parse) const
+{
+	if (DocumentCache)
+	{
+		if (TSharedPtr<FJsonObject> CachedDocument = DocumentCache->Find(JsonFilePath, ContentHash))
+		{
+			return CachedDocument;
+		}
+	}
+	TSharedPtr<FJsonObject> ParsedDocument = Parse();
+	if (DocumentCache && ParsedDocument)
+	{
+		DocumentCache->Add(JsonFilePath, ContentHash, ParsedDocument, SourceBytes);
+	}
+	return ParsedDocument;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Loads json intermediate documents regardless of how the generator stored them. Documents generated in this
+/// process are taken from the in-memory doc model, otherwise it looks in the intermediate pack first, then for loose
+/// files, preferring the binary encoding over text json in both cases.
+class FDocGenIntermediateReader
+{
+public:
+	/// @param IntermediateDir directory the generator wrote its intermediate documents to
+	/// @param DocModel documents of the run that produced IntermediateDir, if it happened in this process
+	/// @param DocumentCache parsed documents shared with the other processors of this run
+	explicit FDocGenIntermediateReader(const FString& IntermediateDir,
+									   TSharedPtr<class FDocGenDocModel> DocModel = nullptr,
+									   TSharedPtr<class FDocGenParsedDocumentCache> DocumentCache = nullptr);
+
+	/// @brief Loads a document by the path of its json intermediate file. Documents read from disk may be shared
+	/// with other readers through the document cache, so they must not be modified.
+	/// @return the parsed document, or nullptr if it couldn't be found or parsed
+	TSharedPtr<class FJsonObject> LoadJson(const FString& JsonFilePath) const;
+
+	/// @brief Loads a document for a caller that only reads some of its top level members. Text json is parsed just
+	/// far enough to find those members, documents from the doc model or the binary encoding may have all of them.
+	/// Partially parsed documents aren't added to the document cache, but a whole document already in it is returned.
+	/// @return the document, or nullptr if it couldn't be found or parsed
+	TSharedPtr<FJsonObject> LoadJsonMembers(const FString& JsonFilePath, const TArray<FString>& MemberNames) const;
+
+private:
+	/// @param MemberNames members to parse text json for, nullptr to parse it whole
+	TSharedPtr<FJsonObject> LoadDocument(const FString& JsonFilePath, const TArray<FString>* MemberNames) const;
+	TSharedPtr<FJsonObject> LoadJsonFromPack(const FString& JsonFilePath, const TArray<FString>* MemberNames) const;
+	/// @brief Parses text json, whole through the document cache or only MemberNames without adding to it
+	TSharedPtr<FJsonObject> ParseText(const FString& JsonFilePath, TSharedPtr<class FDocGenJsonIndex> TextFile,
+									  const TArray<FString>* MemberNames) const;
+	/// @brief Returns the cached parse of JsonFilePath if its content hasn't changed, otherwise runs Parse and caches
+	/// the result
+	TSharedPtr<FJsonObject> ParseCached(const FString& JsonFilePath, uint64 ContentHash, int64 SourceBytes,
+										TFunctionRef<TSharedPtr<FJsonObject>()> Parse) const;
+
+	FString IntermediateDir;
+	TSharedPtr<FDocGenDocModel> DocModel;
+	TSharedPtr<FDocGenParsedDocumentCache> DocumentCache;
+	TSharedPtr<class FDocGenIntermediateArchiveReader> Pack;
+};
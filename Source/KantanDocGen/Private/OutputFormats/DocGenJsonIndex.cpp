@@ -0,0 +1,768 @@
+#include "OutputFormats/DocGenJsonIndex.h"
+#include "Async/MappedFileHandle.h"
+#include "DocGenOutputManifest.h"
+#include "DocGenUTF8.h"
+#include "HAL/PlatformFileManager.h"
+#include "Json.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "OutputFormats/DocGenJsonStreamWriter.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <emmintrin.h>
+	#define DOCGEN_JSON_SSE2 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_64BITS
+	#include <arm_neon.h>
+	#define DOCGEN_JSON_NEON 1
+#endif
+#ifndef DOCGEN_JSON_SSE2
+	#define DOCGEN_JSON_SSE2 0
+#endif
+#ifndef DOCGEN_JSON_NEON
+	#define DOCGEN_JSON_NEON 0
+#endif
+
+namespace
+{
+	constexpr int32 BlockSize = 64;
+
+	/// @brief One bit per byte of a block
+	struct FBlockMasks
+	{
+		uint64 Quotes = 0;
+		uint64 Backslashes = 0;
+		// Brackets, colons and commas, whether or not they're inside a string
+		uint64 Structurals = 0;
+	};
+
+	FBlockMasks ClassifyBlock(const uint8* Block)
+	{
+		FBlockMasks Masks;
+#if DOCGEN_JSON_SSE2
+		const __m128i Quote = _mm_set1_epi8('"');
+		const __m128i Backslash = _mm_set1_epi8('\\');
+		const __m128i CaseBit = _mm_set1_epi8(0x20);
+		const __m128i OpenBrace = _mm_set1_epi8('{');
+		const __m128i CloseBrace = _mm_set1_epi8('}');
+		const __m128i Colon = _mm_set1_epi8(':');
+		const __m128i Comma = _mm_set1_epi8(',');
+		for (int32 Lane = 0; Lane < BlockSize / 16; ++Lane)
+		{
+			const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Block + Lane * 16));
+			// Square brackets only differ from braces in the case bit
+			const __m128i Folded = _mm_or_si128(Bytes, CaseBit);
+			const __m128i Structural =
+				_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Folded, OpenBrace), _mm_cmpeq_epi8(Folded, CloseBrace)),
+							 _mm_or_si128(_mm_cmpeq_epi8(Bytes, Colon), _mm_cmpeq_epi8(Bytes, Comma)));
+			const int32 Shift = Lane * 16;
+			Masks.Quotes |= uint64(uint16(_mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, Quote)))) << Shift;
+			Masks.Backslashes |= uint64(uint16(_mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, Backslash)))) << Shift;
+			Masks.Structurals |= uint64(uint16(_mm_movemask_epi8(Structural))) << Shift;
+		}
+#elif DOCGEN_JSON_NEON
+		static const uint8 BitWeights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+		const uint8x16_t Weights = vld1q_u8(BitWeights);
+		// NEON has no movemask, weighting each lane by its bit and summing each half gets the same 16 bits
+		const auto MoveMask = [&Weights](uint8x16_t Matches) {
+			const uint8x16_t Bits = vandq_u8(Matches, Weights);
+			return uint64(vaddv_u8(vget_low_u8(Bits))) | (uint64(vaddv_u8(vget_high_u8(Bits))) << 8);
+		};
+		for (int32 Lane = 0; Lane < BlockSize / 16; ++Lane)
+		{
+			const uint8x16_t Bytes = vld1q_u8(Block + Lane * 16);
+			// Square brackets only differ from braces in the case bit
+			const uint8x16_t Folded = vorrq_u8(Bytes, vdupq_n_u8(0x20));
+			const uint8x16_t Structural =
+				vorrq_u8(vorrq_u8(vceqq_u8(Folded, vdupq_n_u8('{')), vceqq_u8(Folded, vdupq_n_u8('}'))),
+						 vorrq_u8(vceqq_u8(Bytes, vdupq_n_u8(':')), vceqq_u8(Bytes, vdupq_n_u8(','))));
+			const int32 Shift = Lane * 16;
+			Masks.Quotes |= MoveMask(vceqq_u8(Bytes, vdupq_n_u8('"'))) << Shift;
+			Masks.Backslashes |= MoveMask(vceqq_u8(Bytes, vdupq_n_u8('\\'))) << Shift;
+			Masks.Structurals |= MoveMask(Structural) << Shift;
+		}
+#else
+		for (int32 Index = 0; Index < BlockSize; ++Index)
+		{
+			const uint64 Bit = uint64(1) << Index;
+			switch (Block[Index])
+			{
+				case '"':
+					Masks.Quotes |= Bit;
+					break;
+				case '\\':
+					Masks.Backslashes |= Bit;
+					break;
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+				case ':':
+				case ',':
+					Masks.Structurals |= Bit;
+					break;
+				default:
+					break;
+			}
+		}
+#endif
+		return Masks;
+	}
+
+	/// @brief Finds the characters escaped by a backslash, a run of backslashes escapes the character after it when
+	/// the run has an odd length
+	/// @param PrevEscaped in: whether the first character of the block is escaped by the previous block, out: the
+	/// same for the next block
+	uint64 FindEscaped(uint64 Backslashes, uint64& PrevEscaped)
+	{
+		if (!Backslashes)
+		{
+			const uint64 Escaped = PrevEscaped;
+			PrevEscaped = 0;
+			return Escaped;
+		}
+		constexpr uint64 EvenBits = 0x5555555555555555ull;
+		// A backslash that is itself escaped doesn't start a run
+		Backslashes &= ~PrevEscaped;
+		const uint64 FollowsEscape = (Backslashes << 1) | PrevEscaped;
+		const uint64 OddRunStarts = Backslashes & ~EvenBits & ~FollowsEscape;
+		// Adding a run's start to it carries out just past its end, so the parity of where the carry lands tells
+		// whether the run started on an odd or even bit
+		const uint64 RunsStartingOnEvenBits = OddRunStarts + Backslashes;
+		PrevEscaped = RunsStartingOnEvenBits < OddRunStarts ? 1 : 0;
+		const uint64 InvertMask = RunsStartingOnEvenBits << 1;
+		return (EvenBits ^ InvertMask) & FollowsEscape;
+	}
+
+	/// @brief Bit N of the result is the xor of bits 0 to N, which turns quote positions into string interiors
+	uint64 PrefixXor(uint64 Bits)
+	{
+		Bits ^= Bits << 1;
+		Bits ^= Bits << 2;
+		Bits ^= Bits << 4;
+		Bits ^= Bits << 8;
+		Bits ^= Bits << 16;
+		Bits ^= Bits << 32;
+		return Bits;
+	}
+
+	bool IsWhitespace(uint8 Char)
+	{
+		return Char == ' ' || Char == '\n' || Char == '\r' || Char == '\t';
+	}
+
+	bool ParseHex4(const uint8* Digits, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			const uint8 Digit = Digits[Index];
+			uint32 Nibble;
+			if (Digit >= '0' && Digit <= '9')
+			{
+				Nibble = Digit - '0';
+			}
+			else if ((Digit | 0x20) >= 'a' && (Digit | 0x20) <= 'f')
+			{
+				Nibble = (Digit | 0x20) - 'a' + 10;
+			}
+			else
+			{
+				return false;
+			}
+			OutValue = (OutValue << 4) | Nibble;
+		}
+		return true;
+	}
+
+	void AppendCodePoint(TArray<uint8>& Out, uint32 CodePoint)
+	{
+		if (CodePoint >= 0xD800 && CodePoint <= 0xDFFF)
+		{
+			// Lone surrogate
+			CodePoint = 0xFFFD;
+		}
+		if (CodePoint < 0x80)
+		{
+			Out.Add(static_cast<uint8>(CodePoint));
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out.Add(static_cast<uint8>(0xC0 | (CodePoint >> 6)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out.Add(static_cast<uint8>(0xE0 | (CodePoint >> 12)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add(static_cast<uint8>(0xF0 | (CodePoint >> 18)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+} // namespace
+
+FDocGenJsonIndex::~FDocGenJsonIndex()
+{
+	// Region must be released before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TSharedPtr<FDocGenJsonIndex> FDocGenJsonIndex::Open(const FString& FilePath)
+{
+	TSharedPtr<FDocGenJsonIndex> Document = MakeShareable(new FDocGenJsonIndex());
+	Document->DebugName = FilePath;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	Document->MappedFile.Reset(PlatformFile.OpenMapped(*FilePath));
+	if (Document->MappedFile && Document->MappedFile->GetFileSize() > 0)
+	{
+		Document->MappedRegion.Reset(Document->MappedFile->MapRegion(0, Document->MappedFile->GetFileSize()));
+	}
+	if (Document->MappedRegion)
+	{
+		Document->Data = Document->MappedRegion->GetMappedPtr();
+		Document->DataSize = Document->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		// Platform doesn't support mapping this file, fall back to reading it
+		Document->MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Document->OwnedData, *FilePath, FILEREAD_Silent))
+		{
+			return nullptr;
+		}
+		Document->Data = Document->OwnedData.GetData();
+		Document->DataSize = Document->OwnedData.Num();
+	}
+	return Document;
+}
+
+TSharedPtr<FDocGenJsonIndex> FDocGenJsonIndex::FromBuffer(TArray<uint8>&& Bytes, const FString& DebugName)
+{
+	TSharedPtr<FDocGenJsonIndex> Document = MakeShareable(new FDocGenJsonIndex());
+	Document->DebugName = DebugName;
+	Document->OwnedData = MoveTemp(Bytes);
+	Document->Data = Document->OwnedData.GetData();
+	Document->DataSize = Document->OwnedData.Num();
+	return Document;
+}
+
+uint64 FDocGenJsonIndex::GetContentHash() const
+{
+	return FDocGenOutputManifest::HashBytes(Data, DataSize);
+}
+
+TSharedPtr<FJsonObject> FDocGenJsonIndex::Parse()
+{
+	return ParseRoot(nullptr);
+}
+
+TSharedPtr<FJsonObject> FDocGenJsonIndex::ParseMembers(const TArray<FString>& MemberNames)
+{
+	// FString keys compare case-insensitively by default, the same as FJsonObject's
+	const TSet<FString> MemberNameSet(MemberNames);
+	return ParseRoot(&MemberNameSet);
+}
+
+TSharedPtr<FJsonObject> FDocGenJsonIndex::ParseResolvingStrings()
+{
+	// The table is written last, the index gets to it without parsing anything else so references can be resolved
+	// in a single pass over the rest
+	TSharedPtr<FJsonObject> Table = ParseMembers({FDocGenJsonStringTable::TableMemberName});
+	if (!Table)
+	{
+		return nullptr;
+	}
+	const TArray<TSharedPtr<FJsonValue>>* TableStrings = nullptr;
+	if (!Table->TryGetArrayField(FDocGenJsonStringTable::TableMemberName, TableStrings))
+	{
+		return Parse();
+	}
+	for (const TSharedPtr<FJsonValue>& TableString : *TableStrings)
+	{
+		if (TableString->Type != EJson::String)
+		{
+			LogError(TEXT("String table holds something other than strings"), 0);
+			return nullptr;
+		}
+	}
+	ReferencedStrings = *TableStrings;
+	// Even an empty table makes every reference one to a string it doesn't have
+	bResolvingStrings = true;
+	TSharedPtr<FJsonObject> Root = ParseRoot(nullptr, FDocGenJsonStringTable::TableMemberName);
+	bResolvingStrings = false;
+	ReferencedStrings.Empty();
+	return Root;
+}
+
+bool FDocGenJsonIndex::BuildIndex()
+{
+	if (bIndexBuilt)
+	{
+		return bIndexValid;
+	}
+	bIndexBuilt = true;
+	if (DataSize > MAX_uint32)
+	{
+		LogError(TEXT("Document is too large to index"), 0);
+		return false;
+	}
+
+	// Documentation json averages somewhere around one structural character in eight bytes
+	Structurals.Reserve(DataSize / 8);
+	uint64 PrevEscaped = 0;
+	uint64 PrevInString = 0;
+	for (int64 BlockStart = 0; BlockStart < DataSize; BlockStart += BlockSize)
+	{
+		const uint8* Block = Data + BlockStart;
+		uint8 LastBlock[BlockSize];
+		if (DataSize - BlockStart < BlockSize)
+		{
+			// Pad the last block with spaces, which are never structural
+			FMemory::Memset(LastBlock, ' ', BlockSize);
+			FMemory::Memcpy(LastBlock, Block, DataSize - BlockStart);
+			Block = LastBlock;
+		}
+		const FBlockMasks Masks = ClassifyBlock(Block);
+		const uint64 Quotes = Masks.Quotes & ~FindEscaped(Masks.Backslashes, PrevEscaped);
+		// Set from each opening quote up to, not including, its closing quote
+		const uint64 InString = PrefixXor(Quotes) ^ PrevInString;
+		PrevInString = static_cast<uint64>(static_cast<int64>(InString) >> 63);
+		for (uint64 Bits = (Masks.Structurals & ~InString) | Quotes; Bits; Bits &= Bits - 1)
+		{
+			Structurals.Add(static_cast<uint32>(BlockStart + FMath::CountTrailingZeros64(Bits)));
+		}
+	}
+	if (PrevInString)
+	{
+		LogError(TEXT("Unterminated string"), DataSize);
+		return false;
+	}
+
+	Partners.SetNumUninitialized(Structurals.Num());
+	TArray<int32> OpenEntries;
+	for (int32 Entry = 0; Entry < Structurals.Num(); ++Entry)
+	{
+		const uint8 Char = Data[Structurals[Entry]];
+		if (Char == '{' || Char == '[')
+		{
+			OpenEntries.Add(Entry);
+		}
+		else if (Char == '}' || Char == ']')
+		{
+			// Each closing bracket is two characters on from its opening one
+			if (OpenEntries.Num() == 0 || Data[Structurals[OpenEntries.Last()]] + 2 != Char)
+			{
+				LogError(TEXT("Unbalanced bracket"), Structurals[Entry]);
+				return false;
+			}
+			Partners[OpenEntries.Pop()] = Entry;
+		}
+	}
+	if (OpenEntries.Num() > 0)
+	{
+		LogError(TEXT("Unclosed bracket"), Structurals[OpenEntries.Last()]);
+		return false;
+	}
+	bIndexValid = true;
+	return true;
+}
+
+TSharedPtr<FJsonObject> FDocGenJsonIndex::ParseRoot(const TSet<FString>* MemberNames, const TCHAR* ExcludedMember)
+{
+	if (!BuildIndex())
+	{
+		return nullptr;
+	}
+	int64 Start = 0;
+	// Skip a UTF-8 byte order mark
+	if (DataSize >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Start = 3;
+	}
+	Start = SkipWhitespace(Start);
+	if (!IsEntry(0, '{') || Structurals[0] != Start)
+	{
+		LogError(TEXT("Expected the document to be an object"), Start);
+		return nullptr;
+	}
+	int32 Entry = 0;
+	TSharedPtr<FJsonObject> Root = ParseObject(Entry, MemberNames, ExcludedMember);
+	if (!Root)
+	{
+		return nullptr;
+	}
+	if (SkipWhitespace(Structurals[Entry] + 1) != DataSize)
+	{
+		LogError(TEXT("Unexpected characters after the document"), Structurals[Entry] + 1);
+		return nullptr;
+	}
+	return Root;
+}
+
+TSharedPtr<FJsonObject> FDocGenJsonIndex::ParseObject(int32& Entry, const TSet<FString>* MemberNames,
+													  const TCHAR* ExcludedMember) const
+{
+	const int32 CloseEntry = Partners[Entry];
+	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+	if (SkipWhitespace(Structurals[Entry] + 1) == Structurals[CloseEntry])
+	{
+		Entry = CloseEntry;
+		return Object;
+	}
+	for (;;)
+	{
+		const int64 KeyStart = SkipWhitespace(Structurals[Entry] + 1);
+		const int32 KeyEntry = Entry + 1;
+		if (!IsEntry(KeyEntry, '"') || Structurals[KeyEntry] != KeyStart)
+		{
+			LogError(TEXT("Expected a member name"), KeyStart);
+			return nullptr;
+		}
+		// Quotes always come in pairs, so the entry after an opening quote is its closing one
+		if (!IsFollowedByNextEntry(KeyEntry + 1) || !IsEntry(KeyEntry + 2, ':'))
+		{
+			LogError(TEXT("Expected a colon"), Structurals[KeyEntry + 1] + 1);
+			return nullptr;
+		}
+		FString Key;
+		if (!ReadString(KeyEntry, Key))
+		{
+			return nullptr;
+		}
+		Entry = KeyEntry + 2;
+		const bool bParseMember =
+			MemberNames ? MemberNames->Contains(Key)
+						: !ExcludedMember || !Key.Equals(ExcludedMember, ESearchCase::CaseSensitive);
+		if (bParseMember)
+		{
+			TSharedPtr<FJsonValue> Value = ParseValue(Entry);
+			if (!Value)
+			{
+				return nullptr;
+			}
+			Object->SetField(Key, Value);
+		}
+		else if (!SkipValue(Entry))
+		{
+			return nullptr;
+		}
+
+		++Entry;
+		if (IsEntry(Entry, '}') && Entry == CloseEntry)
+		{
+			return Object;
+		}
+		if (!IsEntry(Entry, ','))
+		{
+			LogError(TEXT("Expected a comma or closing brace"),
+					 Entry < Structurals.Num() ? Structurals[Entry] : DataSize);
+			return nullptr;
+		}
+	}
+}
+
+TSharedPtr<FJsonValue> FDocGenJsonIndex::ParseArray(int32& Entry) const
+{
+	const int32 CloseEntry = Partners[Entry];
+	TArray<TSharedPtr<FJsonValue>> Elements;
+	if (SkipWhitespace(Structurals[Entry] + 1) == Structurals[CloseEntry])
+	{
+		Entry = CloseEntry;
+		return MakeShared<FJsonValueArray>(Elements);
+	}
+	for (;;)
+	{
+		TSharedPtr<FJsonValue> Element = ParseValue(Entry);
+		if (!Element)
+		{
+			return nullptr;
+		}
+		Elements.Add(MoveTemp(Element));
+
+		++Entry;
+		if (IsEntry(Entry, ']') && Entry == CloseEntry)
+		{
+			return MakeShared<FJsonValueArray>(Elements);
+		}
+		if (!IsEntry(Entry, ','))
+		{
+			LogError(TEXT("Expected a comma or closing bracket"),
+					 Entry < Structurals.Num() ? Structurals[Entry] : DataSize);
+			return nullptr;
+		}
+	}
+}
+
+TSharedPtr<FJsonValue> FDocGenJsonIndex::ParseValue(int32& Entry) const
+{
+	const int64 Start = SkipWhitespace(Structurals[Entry] + 1);
+	const int32 NextEntry = Entry + 1;
+	if (NextEntry >= Structurals.Num())
+	{
+		LogError(TEXT("Expected a value"), Start);
+		return nullptr;
+	}
+	if (Structurals[NextEntry] != Start)
+	{
+		// Literals and numbers aren't indexed, they run up to the comma or bracket that ends them
+		return ParseScalar(Start, Structurals[NextEntry]);
+	}
+
+	TSharedPtr<FJsonValue> Value;
+	Entry = NextEntry;
+	switch (Data[Start])
+	{
+		case '{':
+		{
+			if (bResolvingStrings && ParseStringRef(Entry, Value))
+			{
+				break;
+			}
+			TSharedPtr<FJsonObject> Object = ParseObject(Entry, nullptr);
+			if (Object)
+			{
+				Value = MakeShared<FJsonValueObject>(Object);
+			}
+			break;
+		}
+		case '[':
+			Value = ParseArray(Entry);
+			break;
+		case '"':
+		{
+			FString String;
+			if (ReadString(Entry, String))
+			{
+				Value = MakeShared<FJsonValueString>(String);
+			}
+			++Entry;
+			break;
+		}
+		default:
+			LogError(TEXT("Expected a value"), Start);
+			return nullptr;
+	}
+	if (!Value)
+	{
+		return nullptr;
+	}
+	if (!IsFollowedByNextEntry(Entry))
+	{
+		LogError(TEXT("Unexpected character"), Structurals[Entry] + 1);
+		return nullptr;
+	}
+	return Value;
+}
+
+bool FDocGenJsonIndex::ParseStringRef(int32& Entry, TSharedPtr<FJsonValue>& OutValue) const
+{
+	// A reference is nothing but its braces, the quotes around its key and a colon
+	const int32 CloseEntry = Partners[Entry];
+	if (CloseEntry != Entry + 4 || !IsEntry(Entry + 1, '"') || !IsEntry(Entry + 3, ':') ||
+		Structurals[Entry + 1] != SkipWhitespace(Structurals[Entry] + 1) || !IsFollowedByNextEntry(Entry + 2))
+	{
+		return false;
+	}
+	const int64 KeyStart = Structurals[Entry + 1] + 1;
+	if (Structurals[Entry + 2] - KeyStart != 4 || FMemory::Memcmp(Data + KeyStart, "$ref", 4) != 0)
+	{
+		return false;
+	}
+
+	const int64 IndexStart = SkipWhitespace(Structurals[Entry + 3] + 1);
+	TSharedPtr<FJsonValue> Index = ParseScalar(IndexStart, Structurals[CloseEntry]);
+	const double Number = Index && Index->Type == EJson::Number ? Index->AsNumber() : -1.0;
+	// Checked before converting, fractions and numbers past the range of an int32 aren't indices either
+	if (Number < 0.0 || Number >= ReferencedStrings.Num() || Number != FMath::FloorToDouble(Number))
+	{
+		LogError(TEXT("Reference to a string the string table doesn't have"), IndexStart);
+		OutValue.Reset();
+		return true;
+	}
+	OutValue = ReferencedStrings[static_cast<int32>(Number)];
+	Entry = CloseEntry;
+	return true;
+}
+
+TSharedPtr<FJsonValue> FDocGenJsonIndex::ParseScalar(int64 Start, int64 End) const
+{
+	while (End > Start && IsWhitespace(Data[End - 1]))
+	{
+		--End;
+	}
+	const int64 Len = End - Start;
+	const uint8* Token = Data + Start;
+	if (Len == 4 && FMemory::Memcmp(Token, "true", 4) == 0)
+	{
+		return MakeShared<FJsonValueBoolean>(true);
+	}
+	if (Len == 5 && FMemory::Memcmp(Token, "false", 5) == 0)
+	{
+		return MakeShared<FJsonValueBoolean>(false);
+	}
+	if (Len == 4 && FMemory::Memcmp(Token, "null", 4) == 0)
+	{
+		return MakeShared<FJsonValueNull>();
+	}
+
+	ANSICHAR Number[64];
+	bool bIsNumber = Len > 0 && Len < UE_ARRAY_COUNT(Number) && (Token[0] == '-' || FChar::IsDigit(Token[0]));
+	for (int64 Index = 0; bIsNumber && Index < Len; ++Index)
+	{
+		const uint8 Char = Token[Index];
+		bIsNumber = FChar::IsDigit(Char) || Char == '-' || Char == '+' || Char == '.' || Char == 'e' || Char == 'E';
+		Number[Index] = Char;
+	}
+	if (!bIsNumber)
+	{
+		LogError(TEXT("Expected a value"), Start);
+		return nullptr;
+	}
+	Number[Len] = '\0';
+	return MakeShared<FJsonValueNumber>(FCStringAnsi::Atod(Number));
+}
+
+bool FDocGenJsonIndex::SkipValue(int32& Entry) const
+{
+	const int64 Start = SkipWhitespace(Structurals[Entry] + 1);
+	const int32 NextEntry = Entry + 1;
+	if (NextEntry >= Structurals.Num())
+	{
+		LogError(TEXT("Expected a value"), Start);
+		return false;
+	}
+	if (Structurals[NextEntry] != Start)
+	{
+		// A literal or number, which is only checked for being there at all
+		return true;
+	}
+	switch (Data[Start])
+	{
+		case '{':
+		case '[':
+			Entry = Partners[NextEntry];
+			break;
+		case '"':
+			Entry = NextEntry + 1;
+			break;
+		default:
+			LogError(TEXT("Expected a value"), Start);
+			return false;
+	}
+	if (!IsFollowedByNextEntry(Entry))
+	{
+		LogError(TEXT("Unexpected character"), Structurals[Entry] + 1);
+		return false;
+	}
+	return true;
+}
+
+int64 FDocGenJsonIndex::SkipWhitespace(int64 Offset) const
+{
+	while (Offset < DataSize && IsWhitespace(Data[Offset]))
+	{
+		++Offset;
+	}
+	return Offset;
+}
+
+bool FDocGenJsonIndex::IsFollowedByNextEntry(int32 Entry) const
+{
+	return Entry + 1 < Structurals.Num() && Structurals[Entry + 1] == SkipWhitespace(Structurals[Entry] + 1);
+}
+
+bool FDocGenJsonIndex::IsEntry(int32 Entry, uint8 Char) const
+{
+	return Entry < Structurals.Num() && Data[Structurals[Entry]] == Char;
+}
+
+bool FDocGenJsonIndex::ReadString(int32 OpenEntry, FString& OutString) const
+{
+	const int64 Start = Structurals[OpenEntry] + 1;
+	const int64 End = Structurals[OpenEntry + 1];
+	int64 Escape = Start;
+	while (Escape < End && Data[Escape] != '\\')
+	{
+		++Escape;
+	}
+	if (Escape == End)
+	{
+		OutString = DocGenUTF8::ToString(Data + Start, End - Start);
+		return true;
+	}
+
+	TArray<uint8> Unescaped;
+	Unescaped.Reserve(End - Start);
+	Unescaped.Append(Data + Start, Escape - Start);
+	for (int64 Offset = Escape; Offset < End; ++Offset)
+	{
+		if (Data[Offset] != '\\')
+		{
+			Unescaped.Add(Data[Offset]);
+			continue;
+		}
+		// The structural pass guarantees the closing quote isn't escaped, so there's always a character after this
+		++Offset;
+		switch (Data[Offset])
+		{
+			case '"':
+			case '\\':
+			case '/':
+				Unescaped.Add(Data[Offset]);
+				break;
+			case 'b':
+				Unescaped.Add('\b');
+				break;
+			case 'f':
+				Unescaped.Add('\f');
+				break;
+			case 'n':
+				Unescaped.Add('\n');
+				break;
+			case 'r':
+				Unescaped.Add('\r');
+				break;
+			case 't':
+				Unescaped.Add('\t');
+				break;
+			case 'u':
+			{
+				uint32 CodePoint = 0;
+				if (End - Offset <= 4 || !ParseHex4(Data + Offset + 1, CodePoint))
+				{
+					LogError(TEXT("Invalid unicode escape"), Offset - 1);
+					return false;
+				}
+				Offset += 4;
+				// Characters outside the basic multilingual plane are escaped as a surrogate pair
+				uint32 LowSurrogate = 0;
+				if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && End - Offset > 6 && Data[Offset + 1] == '\\' &&
+					Data[Offset + 2] == 'u' && ParseHex4(Data + Offset + 3, LowSurrogate) && LowSurrogate >= 0xDC00 &&
+					LowSurrogate <= 0xDFFF)
+				{
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+					Offset += 6;
+				}
+				AppendCodePoint(Unescaped, CodePoint);
+				break;
+			}
+			default:
+				LogError(TEXT("Invalid escape"), Offset - 1);
+				return false;
+		}
+	}
+	OutString = DocGenUTF8::ToString(Unescaped.GetData(), Unescaped.Num());
+	return true;
+}
+
+void FDocGenJsonIndex::LogError(const TCHAR* Error, int64 Offset) const
+{
+	UE_LOG(LogKantanDocGen, Error, TEXT("Failed to parse %s: %s at byte %lld"), *DebugName, Error, Offset);
+}
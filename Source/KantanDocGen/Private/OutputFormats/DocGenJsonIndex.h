@@ -0,0 +1,97 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/Set.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/UniquePtr.h"
+
+/// @brief Read-only view over a text json document that parses only what is asked for. Files are memory-mapped where
+/// the platform supports it. The first parse runs a structural pass over the raw UTF-8, 64 bytes at a time with SSE2 or
+/// NEON where available, recording where every bracket, colon, comma and unescaped quote outside a string is and which
+/// brackets pair up. Members that aren't asked for are then stepped over using the index, without decoding a single
+/// string or number inside them.
+/// Not thread safe, each document is meant to be parsed once by the thread that opened it.
+class FDocGenJsonIndex
+{
+public:
+	~FDocGenJsonIndex();
+
+	/// @return the document, or nullptr if the file doesn't exist or couldn't be read
+	static TSharedPtr<FDocGenJsonIndex> Open(const FString& FilePath);
+
+	/// @brief Takes ownership of an in-memory copy of a json document
+	/// @param DebugName name used when logging parse errors
+	static TSharedPtr<FDocGenJsonIndex> FromBuffer(TArray<uint8>&& Bytes, const FString& DebugName);
+
+	/// @brief Hash of the raw document, the same FDocGenOutputManifest::HashBytes gives for its bytes
+	uint64 GetContentHash() const;
+
+	int64 GetSize() const
+	{
+		return DataSize;
+	}
+
+	/// @brief Parses the whole document, which must be an object
+	/// @return the document, or nullptr if it isn't valid json
+	TSharedPtr<class FJsonObject> Parse();
+
+	/// @brief Parses only the named members of the top level object, compared case-insensitively like FJsonObject
+	/// does. The rest of the document is only checked for being well formed enough to step over.
+	/// @return an object holding whichever of the members the document has, or nullptr if it isn't valid json
+	TSharedPtr<FJsonObject> ParseMembers(const TArray<FString>& MemberNames);
+
+	/// @brief Parses the whole document, which may have been written with a FDocGenJsonStringTable. Its references
+	/// are replaced by the strings they refer to as they're parsed, and the table itself is left out.
+	/// @return the document, or nullptr if it isn't valid json or refers to a string the table doesn't have
+	TSharedPtr<FJsonObject> ParseResolvingStrings();
+
+private:
+	FDocGenJsonIndex() = default;
+	/// @brief Runs the structural pass, once
+	bool BuildIndex();
+	/// @param ExcludedMember top level member that isn't parsed even though MemberNames is nullptr
+	TSharedPtr<FJsonObject> ParseRoot(const TSet<FString>* MemberNames, const TCHAR* ExcludedMember = nullptr);
+	/// @brief Parses the value that starts after the separator at Entry, leaving Entry on the value's last entry
+	TSharedPtr<class FJsonValue> ParseValue(int32& Entry) const;
+	/// @brief Parses the object whose opening brace is at Entry, leaving Entry on its closing brace
+	/// @param MemberNames members to parse, nullptr for all of them but ExcludedMember
+	TSharedPtr<FJsonObject> ParseObject(int32& Entry, const TSet<FString>* MemberNames,
+										const TCHAR* ExcludedMember = nullptr) const;
+	/// @brief Parses the object at Entry if it's a string table reference, leaving Entry on its closing brace
+	/// @return whether it was a reference, OutValue is null if it referred to a string the table doesn't have
+	bool ParseStringRef(int32& Entry, TSharedPtr<class FJsonValue>& OutValue) const;
+	/// @brief Parses the array whose opening bracket is at Entry, leaving Entry on its closing bracket
+	TSharedPtr<FJsonValue> ParseArray(int32& Entry) const;
+	/// @brief Parses the literal or number between the offsets Start and End
+	TSharedPtr<FJsonValue> ParseScalar(int64 Start, int64 End) const;
+	/// @brief Steps over the value that starts after the separator at Entry, leaving Entry on the value's last entry
+	bool SkipValue(int32& Entry) const;
+	/// @return the offset of the first byte after Offset that isn't whitespace
+	int64 SkipWhitespace(int64 Offset) const;
+	/// @return whether only whitespace lies between entry Entry and the one after it
+	bool IsFollowedByNextEntry(int32 Entry) const;
+	/// @return whether the entry exists and is the structural character Char
+	bool IsEntry(int32 Entry, uint8 Char) const;
+	/// @brief Decodes the string between the quotes at entries OpenEntry and OpenEntry + 1
+	bool ReadString(int32 OpenEntry, FString& OutString) const;
+	void LogError(const TCHAR* Error, int64 Offset) const;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+	FString DebugName;
+
+	bool bIndexBuilt = false;
+	bool bIndexValid = false;
+	// Offsets of the structural characters, in document order
+	TArray<uint32> Structurals;
+	// For each opening bracket the entry of its closing bracket, unused for every other entry
+	TArray<int32> Partners;
+	// Strings references resolve to while parsing a document with a string table
+	TArray<TSharedPtr<FJsonValue>> ReferencedStrings;
+	bool bResolvingStrings = false;
+
+	TArray<uint8> OwnedData;
+	TUniquePtr<class IMappedFileHandle> MappedFile;
+	TUniquePtr<class IMappedFileRegion> MappedRegion;
+};
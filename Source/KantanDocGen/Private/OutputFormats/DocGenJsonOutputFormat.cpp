@@ -2,7 +2,9 @@
 #include "Json.h"
 #include "Misc/FileHelper.h"
 #include "OutputFormats/DocGenJsonOutputProcessor.h"
+#include "OutputFormats/DocGenJsonStreamWriter.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
+#include "Serialization/MemoryWriter.h"
 
 FString DocGenJsonSerializer::EscapeString(const FString& InString)
 {
@@ -20,7 +22,7 @@ void DocGenJsonSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	// If we have a single key...
 	if (Obj.GetKeys(ObjectFieldNames) == 1)
 	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
+		TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayFieldValues;
 		// If that single key has multiple values...
 		Obj.MultiFind(ObjectFieldNames[0], ArrayFieldValues, true);
 		if (ArrayFieldValues.Num() > 1)
@@ -37,7 +39,7 @@ void DocGenJsonSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	}
 	for (auto& FieldName : ObjectFieldNames)
 	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
+		TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayFieldValues;
 		Obj.MultiFind(FieldName, ArrayFieldValues, true);
 		if (ArrayFieldValues.Num() > 1)
 		{
@@ -52,7 +54,8 @@ void DocGenJsonSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	}
 }
 
-TSharedPtr<FJsonValueArray> DocGenJsonSerializer::SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements)
+TSharedPtr<FJsonValueArray> DocGenJsonSerializer::SerializeArray(
+	const TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayElements)
 {
 	TArray<TSharedPtr<FJsonValue>> OutArray;
 	for (auto& Element : ArrayElements)
@@ -82,6 +85,16 @@ DocGenJsonSerializer::DocGenJsonSerializer()
 DocGenJsonSerializer::DocGenJsonSerializer(TSharedPtr<FJsonValue>& TargetObject) : TargetObject(TargetObject) {}
 
 bool DocGenJsonSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	TArray<uint8> Result;
+	if (!SaveToBuffer(Result))
+	{
+		return false;
+	}
+	return FFileHelper::SaveArrayToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()));
+}
+
+bool DocGenJsonSerializer::SaveToBuffer(TArray<uint8>& OutBuffer)
 {
 	if (!TopLevelObject)
 	{
@@ -89,13 +102,22 @@ bool DocGenJsonSerializer::SaveToFile(const FString& OutFileDirectory, const FSt
 	}
 	else
 	{
-		FString Result;
-		auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
-		FJsonSerializer::Serialize(TopLevelObject->AsObject().ToSharedRef(), JsonWriter);
+		// Encoded as UTF-8 while it's written, rather than printed to a string and converted afterwards
+		OutBuffer.Reset();
+		FMemoryWriter Archive(OutBuffer);
+		DocGenJsonStreamWriter Writer(Archive, true);
+		Writer.WriteJsonValue(TopLevelObject);
+		return Writer.Close();
+	}
+}
 
-		return FFileHelper::SaveStringToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()),
-											 FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+TSharedPtr<FJsonObject> DocGenJsonSerializer::GetJsonObject() const
+{
+	if (!TopLevelObject || TopLevelObject->Type != EJson::Object)
+	{
+		return nullptr;
 	}
+	return TopLevelObject->AsObject();
 }
 
 TSharedPtr<struct DocTreeNode::IDocTreeSerializer> UDocGenJsonOutputFactory::CreateSerializer()
@@ -126,7 +148,10 @@ TSharedPtr<struct IDocGenOutputProcessor> UDocGenJsonOutputFactory::CreateInterm
 	{
 		DocRootPathOverride = DocRootPath;
 	}
-	return MakeShared<DocGenJsonOutputProcessor>(TemplateOverride, BinaryOverride, RubyOverride, DocRootPathOverride);
+	TSharedPtr<DocGenJsonOutputProcessor> Processor =
+		MakeShared<DocGenJsonOutputProcessor>(TemplateOverride, BinaryOverride, RubyOverride, DocRootPathOverride);
+	Processor->SetRenderTemplateInProcess(bRenderTemplateInProcess);
+	return Processor;
 }
 
 FString UDocGenJsonOutputFactory::GetFormatIdentifier()
@@ -134,6 +159,12 @@ FString UDocGenJsonOutputFactory::GetFormatIdentifier()
 	return "json";
 }
 
+FString UDocGenJsonOutputFactory::GetIntermediateFormatIdentifier()
+{
+	// JSON and MDX share the same intermediate serialization
+	return "json";
+}
+
 void UDocGenJsonOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySettings& Settings)
 {
 	if (Settings.SettingValues.Contains("template"))
@@ -168,6 +199,10 @@ void UDocGenJsonOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySett
 			bOverrideDocRootPath = (Settings.SettingValues["overridedocroot"] == "true");
 		}
 	}
+	if (Settings.SettingValues.Contains("inprocesstemplate"))
+	{
+		bRenderTemplateInProcess = (Settings.SettingValues["inprocesstemplate"] == "true");
+	}
 }
 
 FDocGenOutputFormatFactorySettings UDocGenJsonOutputFactory::SaveSettings()
@@ -197,6 +232,11 @@ FDocGenOutputFormatFactorySettings UDocGenJsonOutputFactory::SaveSettings()
 	}
 	Settings.SettingValues.Add("docroot", DocRootPath.Path);
 
+	if (bRenderTemplateInProcess)
+	{
+		Settings.SettingValues.Add("inprocesstemplate", "true");
+	}
+
 	Settings.FactoryClass = StaticClass();
 	return Settings;
 }
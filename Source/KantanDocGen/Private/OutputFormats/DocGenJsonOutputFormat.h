@@ -16,7 +16,8 @@ class DocGenJsonSerializer : public DocTreeNode::IDocTreeSerializer
 	virtual FString GetFileExtension() override;
 	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
 
-	TSharedPtr<class FJsonValueArray> SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements);
+	TSharedPtr<class FJsonValueArray> SerializeArray(
+		const TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayElements);
 
 	virtual void SerializeString(const FString& InString) override;
 	virtual void SerializeNull() override;
@@ -25,6 +26,9 @@ public:
 	DocGenJsonSerializer(TSharedPtr<FJsonValue>& TargetObject);;
 	DocGenJsonSerializer();
 	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName);;
+	virtual bool SaveToBuffer(TArray<uint8>& OutBuffer) override;
+	/// @brief The serialized document as a json object, without printing it
+	TSharedPtr<class FJsonObject> GetJsonObject() const;
 };
 
 UCLASS(meta = (DisplayName = "JSON"), Meta = (ShowOnlyInnerProperties), Config = EditorPerProjectUserSettings)
@@ -36,6 +40,7 @@ public:
 	virtual TSharedPtr<struct DocTreeNode::IDocTreeSerializer> CreateSerializer() override;
 	virtual TSharedPtr<struct IDocGenOutputProcessor> CreateIntermediateDocProcessor() override;
 	virtual FString GetFormatIdentifier() override;
+	virtual FString GetIntermediateFormatIdentifier() override;
 
 	virtual void LoadSettings(const FDocGenOutputFormatFactorySettings& Settings);
 
@@ -64,4 +69,8 @@ public:
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bOverrideRubyPath"))
 	FFilePath RubyPath;
+
+	// Renders docs.adoc in process instead of running convert.exe. Not byte-compared with convert.exe yet.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bRenderTemplateInProcess = false;
 };
\ No newline at end of file
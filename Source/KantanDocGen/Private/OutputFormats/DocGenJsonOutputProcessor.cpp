@@ -1,5 +1,6 @@
 #include "OutputFormats/DocGenJsonOutputProcessor.h"
 #include "Algo/Transform.h"
+#include "DocGenChildProcess.h"
 #include "HAL/FileManager.h"
 
 // To define the UE_5_0_OR_LATER below
@@ -11,11 +12,12 @@
 #endif
 
 #include "Json.h"
-#include "JsonDomBuilder.h"
 #include "KantanDocGenLog.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Optional.h"
 #include "Misc/Paths.h"
+#include "OutputFormats/DocGenConsolidator.h"
+#include "OutputFormats/DocGenTemplate.h"
 
 FString DocGenJsonOutputProcessor::Quote(const FString& In)
 {
@@ -26,252 +28,45 @@ FString DocGenJsonOutputProcessor::Quote(const FString& In)
 	return "\"" + In.TrimStartAndEnd() + "\"";
 }
 
-TOptional<FString> DocGenJsonOutputProcessor::GetObjectStringField(const TSharedPtr<FJsonObject> Obj,
-																   const FString& FieldName)
-{
-	FString FieldValue;
-	if (!Obj->TryGetStringField(FieldName, FieldValue))
-	{
-		return {};
-	}
-	else
-	{
-		return FieldValue;
-	}
-}
-
-TOptional<FString> DocGenJsonOutputProcessor::GetObjectStringField(const TSharedPtr<FJsonValue> Obj,
-																   const FString& FieldName)
-{
-	const TSharedPtr<FJsonObject>* UnderlyingObject = nullptr;
-	if (!Obj->TryGetObject(UnderlyingObject))
-	{
-		return {};
-	}
-	else
-	{
-		return GetObjectStringField(*UnderlyingObject, FieldName);
-	}
-}
-
-TOptional<TArray<FString>> DocGenJsonOutputProcessor::GetNamesFromFileAtLocation(const FString& NameType,
-																				 const FString& ClassFile)
-{
-	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFile);
-	if (!ParsedClass)
-	{
-		return {};
-	}
-
-	if (ParsedClass->HasTypedField<EJson::Array>(NameType))
-	{
-		TArray<FString> NodeNames;
-		for (const auto& Value : ParsedClass->GetArrayField(NameType))
-		{
-			TOptional<FString> FuncID = GetObjectStringField(Value, "id");
-			if (FuncID.IsSet())
-			{
-				NodeNames.Add(FuncID.GetValue());
-			}
-		}
-		return NodeNames;
-	}
-	else if (ParsedClass->HasTypedField<EJson::Object>(NameType))
-	{
-		TArray<FString> NodeNames;
-		for (const auto& Node : ParsedClass->GetObjectField(NameType)->Values)
-		{
-			TOptional<FString> Name = GetObjectStringField(Node.Value, "id");
-			if (Name.IsSet())
-			{
-				NodeNames.Add(Name.GetValue());
-			}
-		}
-		return NodeNames;
-	}
-	else if (ParsedClass->HasTypedField<EJson::Null>(NameType))
-	{
-		return TArray<FString>();
-	}
-	return {};
-}
-
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseNodeFile(const FString& NodeFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedNode = LoadFileToJson(NodeFilePath);
-	if (!ParsedNode)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-
-	CopyJsonField("inputs", ParsedNode, OutNode);
-	CopyJsonField("outputs", ParsedNode, OutNode);
-	CopyJsonField("rawsignature", ParsedNode, OutNode);
-	CopyJsonField("class_id", ParsedNode, OutNode);
-	CopyJsonField("doxygen", ParsedNode, OutNode);
-	CopyJsonField("imgpath", ParsedNode, OutNode);
-	CopyJsonField("shorttitle", ParsedNode, OutNode);
-	CopyJsonField("fulltitle", ParsedNode, OutNode);
-	CopyJsonField("static", ParsedNode, OutNode);
-	CopyJsonField("autocast", ParsedNode, OutNode);
-	CopyJsonField("funcname", ParsedNode, OutNode);
-	CopyJsonField("access_specifier", ParsedNode, OutNode);
-	CopyJsonField("meta", ParsedNode, OutNode);
-	return OutNode;
-}
-
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseClassFile(const FString& ClassFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFilePath);
-	if (!ParsedClass)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-	// Reusing the class template for now so renaming id to class_id to be consistent
-	if (TSharedPtr<FJsonValue> Field = ParsedClass->TryGetField(TEXT("id")))
-	{
-		OutNode->SetField("class_id", Field);
-	}
-
-	CopyJsonField("doxygen", ParsedClass, OutNode);
-	CopyJsonField("display_name", ParsedClass, OutNode);
-	CopyJsonField("fields", ParsedClass, OutNode);
-	CopyJsonField("parent_class", ParsedClass, OutNode);
-	CopyJsonField("meta", ParsedClass, OutNode);
-	CopyJsonField("blueprint_generated", ParsedClass, OutNode);
-	CopyJsonField("widget_blueprint", ParsedClass, OutNode);
-	CopyJsonField("class_path", ParsedClass, OutNode);
-	CopyJsonField("context_string", ParsedClass, OutNode);
-	return OutNode;
-}
-
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseStructFile(const FString& StructFilePath)
+EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertJsonToAdoc(FString IntermediateDir)
 {
-	TSharedPtr<FJsonObject> ParsedStruct = LoadFileToJson(StructFilePath);
-	if (!ParsedStruct)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-	// Reusing the class template for now so renaming id to class_id to be consistent
-	if (TSharedPtr<FJsonValue> Field = ParsedStruct->TryGetField(TEXT("id")))
-	{
-		OutNode->SetField("class_id", Field);
-	}
-
-	CopyJsonField("doxygen", ParsedStruct, OutNode);
-	CopyJsonField("display_name", ParsedStruct, OutNode);
-	CopyJsonField("fields", ParsedStruct, OutNode);
-	CopyJsonField("parent_class", ParsedStruct, OutNode);
-	CopyJsonField("meta", ParsedStruct, OutNode);
-	CopyJsonField("blueprint_generated", ParsedStruct, OutNode);
-	CopyJsonField("widget_blueprint", ParsedStruct, OutNode);
-	CopyJsonField("class_path", ParsedStruct, OutNode);
-	CopyJsonField("context_string", ParsedStruct, OutNode);
-	return OutNode;
-}
+	const FFilePath OutAdocPath {IntermediateDir / "docs.adoc"};
 
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::ParseEnumFile(const FString& EnumFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedEnum = LoadFileToJson(EnumFilePath);
-	if (!ParsedEnum)
+	// When asked to render in process, convert.exe is only needed for templates using something the in process
+	// renderer doesn't support
+	const TSharedPtr<FJsonObject> ConsolidatedDocument =
+		bRenderTemplateInProcess && Consolidator ? Consolidator->LoadConsolidatedDocument() : nullptr;
+	if (ConsolidatedDocument &&
+		FDocGenTemplate::RenderFile(TemplatePath.FilePath, ConsolidatedDocument, OutAdocPath.FilePath))
 	{
-		return {};
+		return EIntermediateProcessingResult::Success;
 	}
 
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-
-	CopyJsonField("id", ParsedEnum, OutNode);
-	CopyJsonField("doxygen", ParsedEnum, OutNode);
-	CopyJsonField("display_name", ParsedEnum, OutNode);
-	CopyJsonField("values", ParsedEnum, OutNode);
-	CopyJsonField("meta", ParsedEnum, OutNode);
-
-	return OutNode;
-}
-
-void DocGenJsonOutputProcessor::CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode,
-											  TSharedPtr<FJsonObject> OutNode)
-{
-	if (TSharedPtr<FJsonValue> Field = ParsedNode->TryGetField(FieldName))
+	const FFilePath InJsonPath {Consolidator ? Consolidator->GetStandaloneDocumentPath()
+											 : IntermediateDir / FDocGenConsolidator::ConsolidatedFileName};
+	if (InJsonPath.FilePath.IsEmpty())
 	{
-		OutNode->SetField(FieldName, Field);
+		return EIntermediateProcessingResult::UnknownError;
 	}
-}
-
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::InitializeMainOutputFromIndex(TSharedPtr<FJsonObject> ParsedIndex)
-{
-	TSharedPtr<FJsonObject> Output = MakeShared<FJsonObject>();
-
-	CopyJsonField("display_name", ParsedIndex, Output);
-	return Output;
-}
-
-EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertJsonToAdoc(FString IntermediateDir)
-{
-	const FFilePath InJsonPath {IntermediateDir / "consolidated.json"};
-	const FFilePath OutAdocPath {IntermediateDir / "docs.adoc"};
-
-	void* PipeRead = nullptr;
-	void* PipeWrite = nullptr;
-	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
-
 	const FString Args =
 		Quote(TemplatePath.FilePath) + " " + Quote(InJsonPath.FilePath) + " " + Quote(OutAdocPath.FilePath);
 
-	FProcHandle Proc = FPlatformProcess::CreateProc(*(BinaryPath.Path / "convert.exe"), *Args, true, false, false,
-													nullptr, 0, nullptr, PipeWrite);
+	FDocGenChildProcess ConvertProcess(BinaryPath.Path / "convert.exe", Args);
+	ConvertProcess.SetProcessLimiter(ProcessLimiter);
+	ConvertProcess.SetOutputLineHandler(
+		[](const FString& Line) { UE_LOG(LogKantanDocGen, Error, TEXT("[KantanDocGen] %s"), *Line); });
 
 	int32 ReturnCode = 0;
-	if (Proc.IsValid())
+	if (ConvertProcess.Run(ReturnCode) != FDocGenChildProcess::EResult::Exited)
 	{
-		FString BufferedText;
-		for (bool bProcessFinished = false; !bProcessFinished;)
-		{
-			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
-
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
-			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
-			}
-			*/
-			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
-			int32 EndOfLineIdx;
-			while (BufferedText.FindChar('\n', EndOfLineIdx))
-			{
-				FString Line = BufferedText.Left(EndOfLineIdx);
-				Line.RemoveFromEnd(TEXT("\r"));
-
-				UE_LOG(LogKantanDocGen, Error, TEXT("[KantanDocGen] %s"), *Line);
-
-				BufferedText = BufferedText.Mid(EndOfLineIdx + 1);
-			}
-
-			FPlatformProcess::Sleep(0.1f);
-		}
-		FPlatformProcess::CloseProc(Proc);
-		Proc.Reset();
-
-		if (ReturnCode != 0)
-		{
-			UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
-			return EIntermediateProcessingResult::UnknownError;
-		}
-		else
-		{
-			return EIntermediateProcessingResult::Success;
-		}
+		return EIntermediateProcessingResult::UnknownError;
 	}
-	else
+	if (ReturnCode != 0)
 	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
 		return EIntermediateProcessingResult::UnknownError;
 	}
+	return EIntermediateProcessingResult::Success;
 }
 
 EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertAdocToHTML(FString IntermediateDir, FString OutputDir)
@@ -282,63 +77,28 @@ EIntermediateProcessingResult DocGenJsonOutputProcessor::ConvertAdocToHTML(FStri
 
 	const FFilePath InAdocPath {IntermediateDir / "docs.adoc"};
 	const FFilePath OutHTMLPath {OutputDir / "documentation.html"};
-	void* PipeRead = nullptr;
-	void* PipeWrite = nullptr;
-	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
 
 	const FString Args = Quote(DocRootPath.Path / ".." / "scripts" / "render_html.rb") + " " +
 						 Quote(InAdocPath.FilePath) +
 						 " " + Quote(OutHTMLPath.FilePath);
 
-	FProcHandle Proc = FPlatformProcess::CreateProc(*(RubyExecutablePath.FilePath), *Args, true, false, false, nullptr,
-													0, *(DocRootPath.Path / ".." / "scripts"), PipeWrite);
+	FDocGenChildProcess RenderProcess(RubyExecutablePath.FilePath, Args);
+	RenderProcess.SetWorkingDirectory(DocRootPath.Path / ".." / "scripts");
+	RenderProcess.SetProcessLimiter(ProcessLimiter);
+	RenderProcess.SetOutputLineHandler(
+		[](const FString& Line) { UE_LOG(LogKantanDocGen, Log, TEXT("[KantanDocGen] %s"), *Line); });
 
 	int32 ReturnCode = 0;
-	if (Proc.IsValid())
+	if (RenderProcess.Run(ReturnCode) != FDocGenChildProcess::EResult::Exited)
 	{
-		FString BufferedText;
-		for (bool bProcessFinished = false; !bProcessFinished;)
-		{
-			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
-
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
-			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
-			}
-			*/
-			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
-
-			int32 EndOfLineIdx;
-			while (BufferedText.FindChar('\n', EndOfLineIdx))
-			{
-				FString Line = BufferedText.Left(EndOfLineIdx);
-				Line.RemoveFromEnd(TEXT("\r"));
-
-				UE_LOG(LogKantanDocGen, Log, TEXT("[KantanDocGen] %s"), *Line);
-
-				BufferedText = BufferedText.Mid(EndOfLineIdx + 1);
-			}
-
-			FPlatformProcess::Sleep(0.1f);
-		}
-		FPlatformProcess::CloseProc(Proc);
-		Proc.Reset();
-
-		if (ReturnCode != 0)
-		{
-			UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
-			return EIntermediateProcessingResult::UnknownError;
-		}
-		else
-		{
-			return EIntermediateProcessingResult::Success;
-		}
+		return EIntermediateProcessingResult::UnknownError;
 	}
-	else
+	if (ReturnCode != 0)
 	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
 		return EIntermediateProcessingResult::UnknownError;
 	}
+	return EIntermediateProcessingResult::Success;
 }
 
 DocGenJsonOutputProcessor::DocGenJsonOutputProcessor(TOptional<FFilePath> TemplatePathOverride,
@@ -383,233 +143,50 @@ DocGenJsonOutputProcessor::DocGenJsonOutputProcessor(TOptional<FFilePath> Templa
 	}
 }
 
-EIntermediateProcessingResult DocGenJsonOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
-																				 FString const& OutputDir,
-																				 FString const& DocTitle,
-																				 bool bCleanOutput)
+void DocGenJsonOutputProcessor::SetOutputManifest(TSharedPtr<FDocGenOutputManifest> Manifest)
 {
-	TSharedPtr<FJsonObject> ParsedIndex = LoadFileToJson(IntermediateDir / "index.json");
-
-	TSharedPtr<FJsonObject> ConsolidatedOutput = InitializeMainOutputFromIndex(ParsedIndex);
-
-	EIntermediateProcessingResult ClassResult =
-		ConsolidateClasses(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (ClassResult != EIntermediateProcessingResult::Success)
-	{
-		return ClassResult;
-	}
-
-	EIntermediateProcessingResult StructResult =
-		ConsolidateStructs(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (StructResult != EIntermediateProcessingResult::Success)
-	{
-		return StructResult;
-	}
-
-	EIntermediateProcessingResult EnumResult =
-		ConsolidateEnums(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (EnumResult != EIntermediateProcessingResult::Success)
-	{
-		return EnumResult;
-	}
-
-	FString Result;
-	auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
-	FJsonSerializer::Serialize(ConsolidatedOutput.ToSharedRef(), JsonWriter);
-
-	if (!FFileHelper::SaveStringToFile(Result, *(IntermediateDir / "consolidated.json"),
-									   FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
-	{
-		return EIntermediateProcessingResult::DiskWriteFailure;
-	}
-	if (ConvertJsonToAdoc(IntermediateDir) == EIntermediateProcessingResult::Success)
-	{
-		return ConvertAdocToHTML(IntermediateDir, OutputDir);
-	}
-	return EIntermediateProcessingResult::UnknownError;
+	OutputManifest = Manifest;
 }
 
-EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
-																			FString const& IntermediateDir,
-																			FString const& OutputDir,
-																			TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenJsonOutputProcessor::SetDocModel(TSharedPtr<FDocGenDocModel> InDocModel)
 {
-	FJsonDomBuilder::FArray StaticFunctionList;
-	FJsonDomBuilder::FObject ClassFunctionList;
-	TOptional<TArray<FString>> ClassNames = GetNamesFromIndexFile("classes", ParsedIndex);
-	if (!ClassNames.IsSet())
-	{
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& ClassName : ClassNames.GetValue())
-	{
-		const FString ClassFilePath = IntermediateDir / ClassName / ClassName + ".json";
-		TOptional<TArray<FString>> NodeNames = GetNamesFromFileAtLocation("nodes", ClassFilePath);
-		TSharedPtr<FJsonObject> ParsedClass = ParseStructFile(ClassFilePath);
-		if (!NodeNames.IsSet())
-		{
-			return EIntermediateProcessingResult::UnknownError;
-		}
-		else
-		{
-			TOptional<FString> NodeClassID;
-			FJsonDomBuilder::FArray Nodes;
-			for (const auto& NodeName : NodeNames.GetValue())
-			{
-				const FString NodeFilePath = IntermediateDir / ClassName / "nodes" / NodeName + ".json";
-
-				if (TSharedPtr<FJsonObject> NodeJson = ParseNodeFile(NodeFilePath))
-				{
-					FString RelImagePath;
-					if (NodeJson->TryGetStringField(TEXT("imgpath"), RelImagePath))
-					{
-						FString SourceImagePath = IntermediateDir / ClassName / "nodes" / RelImagePath;
-						SourceImagePath =
-							IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourceImagePath);
-						IFileManager::Get().Copy(*(OutputDir / "img" / FPaths::GetCleanFilename(RelImagePath)),
-												 *SourceImagePath, true);
-					}
-					bool FunctionIsStatic = false;
-					NodeJson->TryGetBoolField(TEXT("static"), FunctionIsStatic);
-
-					if (FunctionIsStatic)
-					{
-						StaticFunctionList.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-					else
-					{
-						Nodes.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-				}
-				else
-				{
-					return EIntermediateProcessingResult::UnknownError;
-				}
-			}
-			// We don't want classes in our classlist if all their nodes are static
-			FJsonDomBuilder::FObject ClassObj;
-			ClassObj.Set("functions", Nodes);
-			ClassObj.Set("class_id", ClassName);
-			ClassObj.Set("display_name", ParsedClass->GetStringField(TEXT("display_name")));
-			ClassObj.Set("meta", MakeShared<FJsonValueObject>(ParsedClass->GetObjectField(TEXT("meta"))));
-			ClassObj.Set("parent_class", MakeShared<FJsonValueObject>(ParsedClass->GetObjectField(TEXT("parent_class"))));
-			const TSharedPtr<FJsonObject>* DoxygenBlock;
-			bool bHadDoxygenBlock = ParsedClass->TryGetObjectField(TEXT("doxygen"), DoxygenBlock);
-			if (bHadDoxygenBlock)
-			{
-				ClassObj.Set(TEXT("doxygen"), MakeShared<FJsonValueObject>(*DoxygenBlock));
-			}
-			const TArray<TSharedPtr<FJsonValue>>* FieldArray;
-			bool bHadFields = ParsedClass->TryGetArrayField(TEXT("fields"), FieldArray);
-			ClassObj.Set(TEXT("fields"), bHadFields ? MakeShared<FJsonValueArray>(*FieldArray)
-											  : MakeShared<FJsonValueArray>(TArray<TSharedPtr<FJsonValue>> {}));
-
-			ClassFunctionList.Set(ClassName, ClassObj);
-		}
-	}
-
-	ConsolidatedOutput->SetField("functions", StaticFunctionList.AsJsonValue());
-	ConsolidatedOutput->SetField("classes", ClassFunctionList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	DocModel = InDocModel;
 }
 
-EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
-																			FString const& IntermediateDir,
-																			FString const& OutputDir,
-																			TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenJsonOutputProcessor::SetDocumentCache(TSharedPtr<FDocGenParsedDocumentCache> InDocumentCache)
 {
-	FJsonDomBuilder::FArray StructList;
-
-	TOptional<TArray<FString>> StructNames = GetNamesFromIndexFile("structs", ParsedIndex);
-	if (!StructNames.IsSet())
-	{
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& StructName : StructNames.GetValue())
-	{
-		const FString StructFilePath = IntermediateDir / StructName / StructName + ".json";
-		TSharedPtr<FJsonObject> StructJson = ParseStructFile(StructFilePath);
-		StructList.Add(MakeShared<FJsonValueObject>(StructJson));
-	}
-
-	ConsolidatedOutput->SetField("structs", StructList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	DocumentCache = InDocumentCache;
 }
 
-EIntermediateProcessingResult DocGenJsonOutputProcessor::ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex,
-																		  FString const& IntermediateDir,
-																		  FString const& OutputDir,
-																		  TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenJsonOutputProcessor::SetConsolidator(TSharedPtr<FDocGenConsolidator> InConsolidator)
 {
-	FJsonDomBuilder::FArray EnumList;
-
-	TOptional<TArray<FString>> EnumNames = GetNamesFromIndexFile("enums", ParsedIndex);
-	if (!EnumNames.IsSet())
-	{
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& EnumName : EnumNames.GetValue())
-	{
-		const FString EnumFilePath = IntermediateDir / EnumName / EnumName + ".json";
-		TSharedPtr<FJsonObject> EnumJson = ParseEnumFile(EnumFilePath);
-		EnumList.Add(MakeShared<FJsonValueObject>(EnumJson));
-	}
-
-	ConsolidatedOutput->SetField("enums", EnumList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	Consolidator = InConsolidator;
 }
 
-TOptional<TArray<FString>> DocGenJsonOutputProcessor::GetNamesFromIndexFile(const FString& NameType,
-																			TSharedPtr<FJsonObject> ParsedIndex)
+void DocGenJsonOutputProcessor::SetProcessLimiter(TSharedPtr<FDocGenProcessLimiter> InProcessLimiter)
 {
-	if (!ParsedIndex)
-	{
-		return {};
-	}
-
-	const TArray<TSharedPtr<FJsonValue>>* ClassEntries;
-	if (!ParsedIndex->TryGetArrayField(NameType, ClassEntries))
-	{
-		return {};
-	}
-	TArray<FString> ClassJsonFiles;
-	for (const auto& ClassEntry : *ClassEntries)
-	{
-		TOptional<FString> ClassID = GetObjectStringField(ClassEntry, "id");
-		if (ClassID.IsSet())
-		{
-			ClassJsonFiles.Add(ClassID.GetValue());
-		}
-	}
-	if (ClassJsonFiles.Num())
-	{
-		return ClassJsonFiles;
-	}
-	else
-	{
-		return {};
-	}
+	ProcessLimiter = InProcessLimiter;
 }
 
-TSharedPtr<FJsonObject> DocGenJsonOutputProcessor::LoadFileToJson(FString const& FilePath)
+EIntermediateProcessingResult DocGenJsonOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
+																				 FString const& OutputDir,
+																				 FString const& DocTitle,
+																				 bool bCleanOutput)
 {
-	FString IndexFileString;
-	if (!FFileHelper::LoadFileToString(IndexFileString, &FPlatformFileManager::Get().GetPlatformFile(), *FilePath))
-	{
-		return nullptr;
-	}
-
-	TSharedPtr<FJsonStringReader> TopLevelJson = FJsonStringReader::Create(IndexFileString);
-	TSharedPtr<FJsonObject> ParsedFile;
-	if (!FJsonSerializer::Deserialize<TCHAR>(*TopLevelJson, ParsedFile, FJsonSerializer::EFlags::None))
+	if (!Consolidator)
 	{
-		return nullptr;
+		// Run outside of a task, so nothing consolidated the intermediate docs for us
+		Consolidator =
+			MakeShared<FDocGenConsolidator>(IntermediateDir, OutputDir, OutputManifest, DocModel, DocumentCache);
+		const EIntermediateProcessingResult ConsolidationResult = Consolidator->Consolidate();
+		if (ConsolidationResult != EIntermediateProcessingResult::Success)
+		{
+			return ConsolidationResult;
+		}
 	}
-	else
+	if (ConvertJsonToAdoc(IntermediateDir) == EIntermediateProcessingResult::Success)
 	{
-		return ParsedFile;
+		return ConvertAdocToHTML(IntermediateDir, OutputDir);
 	}
+	return EIntermediateProcessingResult::UnknownError;
 }
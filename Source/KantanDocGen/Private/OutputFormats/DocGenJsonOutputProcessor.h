@@ -10,25 +10,18 @@
 class DocGenJsonOutputProcessor : public IDocGenOutputProcessor
 {
 	FString Quote(const FString& In);
-	TOptional<FString> GetObjectStringField(const TSharedPtr<class FJsonValue> Obj, const FString& FieldName);
-
-	TOptional<FString> GetObjectStringField(const TSharedPtr<FJsonObject> Obj, const FString& FieldName);
-
-	TOptional<TArray<FString>> GetNamesFromFileAtLocation(const FString& NameType, const FString& ClassFile);
-
-	TSharedPtr<class FJsonObject> ParseNodeFile(const FString& NodeFilePath);
-
-	TSharedPtr<FJsonObject> ParseClassFile(const FString& ClassFilePath);
-	TSharedPtr<FJsonObject> ParseStructFile(const FString& StructFilePath);
-	TSharedPtr<FJsonObject> ParseEnumFile(const FString& EnumFilePath);
-	void CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode, TSharedPtr<FJsonObject> OutNode);
-	TSharedPtr<FJsonObject> InitializeMainOutputFromIndex(TSharedPtr<FJsonObject> ParsedIndex);
 	EIntermediateProcessingResult ConvertJsonToAdoc(FString IntermediateDir);
 	EIntermediateProcessingResult ConvertAdocToHTML(FString IntermediateDir, FString OutputDir);
+	TSharedPtr<class FDocGenOutputManifest> OutputManifest;
+	TSharedPtr<class FDocGenDocModel> DocModel;
+	TSharedPtr<class FDocGenParsedDocumentCache> DocumentCache;
+	TSharedPtr<class FDocGenConsolidator> Consolidator;
+	TSharedPtr<class FDocGenProcessLimiter> ProcessLimiter;
 	FFilePath TemplatePath;
 	FDirectoryPath BinaryPath;
 	FDirectoryPath DocRootPath;
 	FFilePath RubyExecutablePath;
+	bool bRenderTemplateInProcess = false;
 
 public:
 	DocGenJsonOutputProcessor(TOptional<FFilePath> TemplatePathOverride, TOptional<FDirectoryPath> BinaryPathOverride,
@@ -36,21 +29,20 @@ public:
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) override;
-
-	EIntermediateProcessingResult ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
-													 FString const& IntermediateDir, FString const& OutputDir,
-													 TSharedPtr<FJsonObject> ConsolidatedOutput);
-
-	EIntermediateProcessingResult ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
-													 FString const& IntermediateDir, FString const& OutputDir,
-													 TSharedPtr<FJsonObject> ConsolidatedOutput);
-	
-	EIntermediateProcessingResult ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex,
-													 FString const& IntermediateDir, FString const& OutputDir,
-													 TSharedPtr<FJsonObject> ConsolidatedOutput);
-	
-
-	TOptional<TArray<FString>> GetNamesFromIndexFile(const FString& NameType, TSharedPtr<FJsonObject> ParsedIndex);
-
-	TSharedPtr<FJsonObject> LoadFileToJson(FString const& FilePath);
-};
\ No newline at end of file
+	virtual void SetOutputManifest(TSharedPtr<FDocGenOutputManifest> Manifest) override;
+	virtual void SetDocModel(TSharedPtr<FDocGenDocModel> InDocModel) override;
+	virtual void SetDocumentCache(TSharedPtr<FDocGenParsedDocumentCache> InDocumentCache) override;
+	virtual bool UsesConsolidatedOutput() const override
+	{
+		return true;
+	}
+	virtual void SetConsolidator(TSharedPtr<FDocGenConsolidator> InConsolidator) override;
+	virtual void SetProcessLimiter(TSharedPtr<FDocGenProcessLimiter> InProcessLimiter) override;
+
+	/// @brief Renders the template with FDocGenTemplate instead of convert.exe, falling back to convert.exe if it
+	/// doesn't compile
+	void SetRenderTemplateInProcess(bool bInRenderTemplateInProcess)
+	{
+		bRenderTemplateInProcess = bInRenderTemplateInProcess;
+	}
+};
@@ -0,0 +1,354 @@
+#include "OutputFormats/DocGenJsonStreamWriter.h"
+#include "DocGenUTF8.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Hash/CityHash.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	// Output is handed to the archive a buffer at a time, always full ones except for the last, so the content hash
+	// doesn't depend on how the document happened to be written
+	constexpr int32 StreamBufferSize = 64 * 1024;
+} // namespace
+
+const TCHAR* const FDocGenJsonStringTable::TableMemberName = TEXT("$strings");
+const TCHAR* const FDocGenJsonStringTable::RefMemberName = TEXT("$ref");
+
+int32 FDocGenJsonStringTable::Intern(const FString& Value)
+{
+	if (const int32* ExistingIndex = Indices.Find(Value))
+	{
+		return *ExistingIndex;
+	}
+	const int32 Index = Strings.Add(Value);
+	Indices.Add(Value, Index);
+	return Index;
+}
+
+DocGenJsonStreamWriter::DocGenJsonStreamWriter(FArchive& Archive, bool bPrettyPrint, int32 FragmentArrayDepth)
+	: Archive(Archive),
+	  bPrettyPrint(bPrettyPrint),
+	  bIsFragment(FragmentArrayDepth > 0)
+{
+	Buffer.Reserve(StreamBufferSize);
+	if (bIsFragment)
+	{
+		// Acts as the array the fragment will be spliced into, indented as deep as that array's elements
+		ContainerStack.Add({true, false});
+		IndentOffset = FragmentArrayDepth - 1;
+	}
+}
+
+void DocGenJsonStreamWriter::BeginObject()
+{
+	BeginValue();
+	WriteAscii("{");
+	ContainerStack.Add({false, false});
+}
+
+void DocGenJsonStreamWriter::EndObject()
+{
+	check(ContainerStack.Num() && !ContainerStack.Last().bIsArray && !bExpectingMemberValue);
+	const FOpenContainer Container = ContainerStack.Pop();
+	if (Container.bHasElements)
+	{
+		WriteNewLineAndIndent();
+	}
+	WriteAscii("}");
+}
+
+void DocGenJsonStreamWriter::BeginArray()
+{
+	BeginValue();
+	WriteAscii("[");
+	ContainerStack.Add({true, false});
+}
+
+void DocGenJsonStreamWriter::EndArray()
+{
+	check(ContainerStack.Num() > (bIsFragment ? 1 : 0) && ContainerStack.Last().bIsArray);
+	const FOpenContainer Container = ContainerStack.Pop();
+	if (Container.bHasElements)
+	{
+		WriteNewLineAndIndent();
+	}
+	WriteAscii("]");
+}
+
+void DocGenJsonStreamWriter::WriteKey(const FString& Key)
+{
+	check(ContainerStack.Num() && !ContainerStack.Last().bIsArray && !bExpectingMemberValue);
+	FOpenContainer& Container = ContainerStack.Last();
+	if (Container.bHasElements)
+	{
+		WriteAscii(",");
+	}
+	Container.bHasElements = true;
+	WriteNewLineAndIndent();
+	WriteEscapedString(Key);
+	WriteAscii(bPrettyPrint ? ": " : ":");
+	bExpectingMemberValue = true;
+}
+
+void DocGenJsonStreamWriter::WriteString(const FString& Value)
+{
+	BeginValue();
+	if (StringTable && Value.Len() >= FDocGenJsonStringTable::MinInternedLength)
+	{
+		ANSICHAR Ref[32];
+		FCStringAnsi::Snprintf(Ref, sizeof(Ref), bPrettyPrint ? "{\"$ref\": %d}" : "{\"$ref\":%d}",
+							   StringTable->Intern(Value));
+		WriteAscii(Ref);
+		return;
+	}
+	WriteEscapedString(Value);
+}
+
+void DocGenJsonStreamWriter::WriteBool(bool bValue)
+{
+	BeginValue();
+	WriteAscii(bValue ? "true" : "false");
+}
+
+void DocGenJsonStreamWriter::WriteNumber(double Value)
+{
+	BeginValue();
+	ANSICHAR Formatted[64];
+	// Whole numbers are what the intermediates hold, write those without an exponent or fraction
+	if (FMath::IsFinite(Value) && Value == FMath::RoundToDouble(Value) && FMath::Abs(Value) < 9007199254740992.0)
+	{
+		FCStringAnsi::Snprintf(Formatted, sizeof(Formatted), "%lld", static_cast<long long>(Value));
+	}
+	else
+	{
+		FCStringAnsi::Snprintf(Formatted, sizeof(Formatted), "%.17g", Value);
+	}
+	WriteAscii(Formatted);
+}
+
+void DocGenJsonStreamWriter::WriteNull()
+{
+	BeginValue();
+	WriteAscii("null");
+}
+
+void DocGenJsonStreamWriter::WriteJsonValue(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value)
+	{
+		WriteNull();
+		return;
+	}
+	switch (Value->Type)
+	{
+		case EJson::String:
+			WriteString(Value->AsString());
+			break;
+		case EJson::Number:
+			WriteNumber(Value->AsNumber());
+			break;
+		case EJson::Boolean:
+			WriteBool(Value->AsBool());
+			break;
+		case EJson::Array:
+			BeginArray();
+			for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+			{
+				WriteJsonValue(Element);
+			}
+			EndArray();
+			break;
+		case EJson::Object:
+			WriteJsonObject(Value->AsObject());
+			break;
+		default:
+			WriteNull();
+			break;
+	}
+}
+
+void DocGenJsonStreamWriter::WriteJsonObject(const TSharedPtr<FJsonObject>& Object)
+{
+	if (!Object)
+	{
+		WriteNull();
+		return;
+	}
+	BeginObject();
+	for (const auto& Member : Object->Values)
+	{
+		WriteKey(Member.Key);
+		WriteJsonValue(Member.Value);
+	}
+	EndObject();
+}
+
+void DocGenJsonStreamWriter::WriteStringTable()
+{
+	check(StringTable);
+	const TSharedPtr<FDocGenJsonStringTable> Table = MoveTemp(StringTable);
+	WriteKey(FDocGenJsonStringTable::TableMemberName);
+	BeginArray();
+	for (const FString& String : Table->GetStrings())
+	{
+		WriteString(String);
+	}
+	EndArray();
+}
+
+void DocGenJsonStreamWriter::AppendArrayFragment(FArchive& Fragment, bool bFragmentHasElements)
+{
+	check(ContainerStack.Num() && ContainerStack.Last().bIsArray && !ContainerStack.Last().bHasElements);
+	uint8 CopyBuffer[16 * 1024];
+	for (int64 Remaining = Fragment.TotalSize() - Fragment.Tell(); Remaining > 0 && !Fragment.IsError();)
+	{
+		const int64 ChunkSize = FMath::Min<int64>(Remaining, sizeof(CopyBuffer));
+		Fragment.Serialize(CopyBuffer, ChunkSize);
+		WriteBytes(CopyBuffer, ChunkSize);
+		Remaining -= ChunkSize;
+	}
+	if (Fragment.IsError())
+	{
+		Archive.SetError();
+	}
+	ContainerStack.Last().bHasElements = bFragmentHasElements;
+}
+
+bool DocGenJsonStreamWriter::HasRootElements() const
+{
+	return bIsFragment && ContainerStack.Num() && ContainerStack[0].bHasElements;
+}
+
+bool DocGenJsonStreamWriter::Close()
+{
+	check(ContainerStack.Num() == (bIsFragment ? 1 : 0) && !bExpectingMemberValue);
+	FlushBuffer();
+	Archive.Flush();
+	return !Archive.IsError();
+}
+
+void DocGenJsonStreamWriter::BeginValue()
+{
+	if (ContainerStack.Num() == 0)
+	{
+		return;
+	}
+	FOpenContainer& Container = ContainerStack.Last();
+	if (!Container.bIsArray)
+	{
+		// Object members get their separator and indentation with the key
+		check(bExpectingMemberValue);
+		bExpectingMemberValue = false;
+		return;
+	}
+	if (Container.bHasElements)
+	{
+		WriteAscii(",");
+	}
+	Container.bHasElements = true;
+	WriteNewLineAndIndent();
+}
+
+void DocGenJsonStreamWriter::WriteNewLineAndIndent()
+{
+	if (!bPrettyPrint)
+	{
+		return;
+	}
+	WriteAscii(LINE_TERMINATOR_ANSI);
+	static const uint8 Tabs[] = {'\t', '\t', '\t', '\t', '\t', '\t', '\t', '\t'};
+	for (int32 Remaining = ContainerStack.Num() + IndentOffset; Remaining > 0; Remaining -= UE_ARRAY_COUNT(Tabs))
+	{
+		WriteBytes(Tabs, FMath::Min<int32>(Remaining, UE_ARRAY_COUNT(Tabs)));
+	}
+}
+
+void DocGenJsonStreamWriter::WriteEscapedString(const FString& Value)
+{
+	WriteAscii("\"");
+	const TCHAR* Start = *Value;
+	const TCHAR* Current = Start;
+	while (*Current)
+	{
+		const TCHAR Char = *Current;
+		if (Char >= 0x20 && Char != TEXT('"') && Char != TEXT('\\'))
+		{
+			++Current;
+			continue;
+		}
+		WriteTChars(Start, Current - Start);
+		switch (Char)
+		{
+			case TEXT('"'):
+				WriteAscii("\\\"");
+				break;
+			case TEXT('\\'):
+				WriteAscii("\\\\");
+				break;
+			case TEXT('\n'):
+				WriteAscii("\\n");
+				break;
+			case TEXT('\r'):
+				WriteAscii("\\r");
+				break;
+			case TEXT('\t'):
+				WriteAscii("\\t");
+				break;
+			case TEXT('\b'):
+				WriteAscii("\\b");
+				break;
+			case TEXT('\f'):
+				WriteAscii("\\f");
+				break;
+			default:
+			{
+				ANSICHAR Escaped[8];
+				FCStringAnsi::Snprintf(Escaped, sizeof(Escaped), "\\u%04x", static_cast<uint32>(Char));
+				WriteAscii(Escaped);
+				break;
+			}
+		}
+		Start = ++Current;
+	}
+	WriteTChars(Start, Current - Start);
+	WriteAscii("\"");
+}
+
+void DocGenJsonStreamWriter::WriteAscii(const ANSICHAR* Text)
+{
+	WriteBytes(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+}
+
+void DocGenJsonStreamWriter::WriteTChars(const TCHAR* Text, int32 Len)
+{
+	EncodedText.Reset();
+	DocGenUTF8::Append(EncodedText, Text, Len);
+	WriteBytes(EncodedText.GetData(), EncodedText.Num());
+}
+
+void DocGenJsonStreamWriter::WriteBytes(const uint8* Bytes, int64 Num)
+{
+	while (Num > 0)
+	{
+		const int64 ToCopy = FMath::Min<int64>(Num, StreamBufferSize - Buffer.Num());
+		Buffer.Append(Bytes, ToCopy);
+		Bytes += ToCopy;
+		Num -= ToCopy;
+		if (Buffer.Num() == StreamBufferSize)
+		{
+			FlushBuffer();
+		}
+	}
+}
+
+void DocGenJsonStreamWriter::FlushBuffer()
+{
+	if (Buffer.Num() == 0)
+	{
+		return;
+	}
+	ContentHash = CityHash64WithSeed(reinterpret_cast<const char*>(Buffer.GetData()), Buffer.Num(), ContentHash);
+	Archive.Serialize(Buffer.GetData(), Buffer.Num());
+	Buffer.Reset();
+}
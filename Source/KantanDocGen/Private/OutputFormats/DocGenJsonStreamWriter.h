@@ -0,0 +1,118 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "OutputFormats/DocGenBinaryFormat.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Strings shared by the writers of one document. Writers given a table write each string value of at least
+/// MinInternedLength characters as {"$ref": N} instead, N being its index in the table, and the table itself ends up
+/// in the document as an array of strings under the top level member "$strings". Keys and shorter strings, which
+/// wouldn't get any shorter, are written as usual.
+/// Not thread safe, every writer sharing a table has to be used from the same thread.
+class FDocGenJsonStringTable
+{
+public:
+	static const TCHAR* const TableMemberName;
+	static const TCHAR* const RefMemberName;
+	static constexpr int32 MinInternedLength = 16;
+
+	/// @return the index of Value, which is added if the table doesn't hold it yet
+	int32 Intern(const FString& Value);
+
+	const TArray<FString>& GetStrings() const
+	{
+		return Strings;
+	}
+
+private:
+	TArray<FString> Strings;
+	TMap<FString, int32, FDefaultSetAllocator, DocGenBinaryFormat::TCaseSensitiveKeyFuncs<int32>> Indices;
+};
+
+/// @brief Forward-only JSON writer emitting UTF-8 straight into an archive through a small fixed-size buffer, so
+/// arbitrarily large documents can be written without holding them in memory.
+/// Pretty output indents with tabs and puts every member and element on its own line, compact output has no
+/// whitespace at all.
+class DocGenJsonStreamWriter
+{
+public:
+	/// @param Archive destination, must outlive the writer
+	/// @param bPrettyPrint whether to write indentation and line breaks
+	/// @param FragmentArrayDepth when non zero the writer produces the elements of an array nested this deep in
+	/// another writer's document, to be spliced into it with AppendArrayFragment. Elements are written directly at
+	/// the top level and no brackets are written.
+	DocGenJsonStreamWriter(FArchive& Archive, bool bPrettyPrint, int32 FragmentArrayDepth = 0);
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+	/// @brief Writes the key of the next member of the currently open object, its value has to be written next
+	void WriteKey(const FString& Key);
+
+	void WriteString(const FString& Value);
+	void WriteBool(bool bValue);
+	void WriteNumber(double Value);
+	void WriteNull();
+	/// @brief Writes a parsed json value, recursing into objects and arrays
+	void WriteJsonValue(const TSharedPtr<class FJsonValue>& Value);
+	void WriteJsonObject(const TSharedPtr<class FJsonObject>& Object);
+
+	/// @brief Makes long string values references into StringTable from here on, nullptr to write them in full again
+	void SetStringTable(TSharedPtr<FDocGenJsonStringTable> InStringTable)
+	{
+		StringTable = InStringTable;
+	}
+
+	/// @brief Writes the string table as a member of the currently open object, with every string in full. The
+	/// writer stops referencing strings, nothing can be added to the table once it's written.
+	void WriteStringTable();
+
+	/// @brief Copies the output of a fragment writer into the currently open array, which must still be empty
+	/// @param Fragment positioned at the start of the fragment, read until its end
+	/// @param bFragmentHasElements HasRootElements of the fragment writer
+	void AppendArrayFragment(FArchive& Fragment, bool bFragmentHasElements);
+
+	/// @return whether anything has been written at the top level of a fragment writer
+	bool HasRootElements() const;
+
+	/// @brief Writes out whatever is still buffered. Every object and array has to have been closed.
+	/// @return false if the archive reported an error at any point
+	bool Close();
+
+	/// @brief Hash of everything written, only valid after Close. Computed a buffer at a time, so it's stable for
+	/// identical output but differs from hashing the whole output in one go.
+	uint64 GetContentHash() const
+	{
+		return ContentHash;
+	}
+
+private:
+	struct FOpenContainer
+	{
+		bool bIsArray = false;
+		bool bHasElements = false;
+	};
+
+	void BeginValue();
+	void WriteNewLineAndIndent();
+	void WriteEscapedString(const FString& Value);
+	void WriteAscii(const ANSICHAR* Text);
+	void WriteTChars(const TCHAR* Text, int32 Len);
+	void WriteBytes(const uint8* Bytes, int64 Num);
+	void FlushBuffer();
+
+	FArchive& Archive;
+	TArray<uint8> Buffer;
+	// Strings are encoded here before going into Buffer, which is only ever filled to its fixed size
+	TArray<uint8> EncodedText;
+	TArray<FOpenContainer> ContainerStack;
+	int32 IndentOffset = 0;
+	bool bPrettyPrint;
+	bool bIsFragment;
+	bool bExpectingMemberValue = false;
+	uint64 ContentHash = 0;
+	TSharedPtr<FDocGenJsonStringTable> StringTable;
+};
@@ -1,8 +1,10 @@
 #include "OutputFormats/DocGenMdxOutputFormat.h"
 #include "Json.h"
 #include "Misc/FileHelper.h"
+#include "OutputFormats/DocGenJsonStreamWriter.h"
 #include "OutputFormats/DocGenMdxOutputProcessor.h"
 #include "OutputFormats/DocGenOutputProcessor.h"
+#include "Serialization/MemoryWriter.h"
 
 FString DocGenMdxSerializer::EscapeString(const FString& InString)
 {
@@ -20,7 +22,7 @@ void DocGenMdxSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	// If we have a single key...
 	if (Obj.GetKeys(ObjectFieldNames) == 1)
 	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
+		TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayFieldValues;
 		// If that single key has multiple values...
 		Obj.MultiFind(ObjectFieldNames[0], ArrayFieldValues, true);
 		if (ArrayFieldValues.Num() > 1)
@@ -37,7 +39,7 @@ void DocGenMdxSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	}
 	for (auto& FieldName : ObjectFieldNames)
 	{
-		TArray<TSharedPtr<DocTreeNode>> ArrayFieldValues;
+		TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayFieldValues;
 		Obj.MultiFind(FieldName, ArrayFieldValues, true);
 		if (ArrayFieldValues.Num() > 1)
 		{
@@ -52,7 +54,8 @@ void DocGenMdxSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 	}
 }
 
-TSharedPtr<FJsonValueArray> DocGenMdxSerializer::SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements)
+TSharedPtr<FJsonValueArray> DocGenMdxSerializer::SerializeArray(
+	const TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayElements)
 {
 	TArray<TSharedPtr<FJsonValue>> OutArray;
 	for (auto& Element : ArrayElements)
@@ -82,6 +85,16 @@ DocGenMdxSerializer::DocGenMdxSerializer()
 DocGenMdxSerializer::DocGenMdxSerializer(TSharedPtr<FJsonValue>& TargetObject) : TargetObject(TargetObject) {}
 
 bool DocGenMdxSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
+{
+	TArray<uint8> Result;
+	if (!SaveToBuffer(Result))
+	{
+		return false;
+	}
+	return FFileHelper::SaveArrayToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()));
+}
+
+bool DocGenMdxSerializer::SaveToBuffer(TArray<uint8>& OutBuffer)
 {
 	if (!TopLevelObject)
 	{
@@ -89,12 +102,12 @@ bool DocGenMdxSerializer::SaveToFile(const FString& OutFileDirectory, const FStr
 	}
 	else
 	{
-		FString Result;
-		auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
-		FJsonSerializer::Serialize(TopLevelObject->AsObject().ToSharedRef(), JsonWriter);
-
-		return FFileHelper::SaveStringToFile(Result, *(OutFileDirectory / OutFileName + GetFileExtension()),
-											 FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		// Encoded as UTF-8 while it's written, rather than printed to a string and converted afterwards
+		OutBuffer.Reset();
+		FMemoryWriter Archive(OutBuffer);
+		DocGenJsonStreamWriter Writer(Archive, true);
+		Writer.WriteJsonValue(TopLevelObject);
+		return Writer.Close();
 	}
 }
 
@@ -130,8 +143,11 @@ TSharedPtr<struct IDocGenOutputProcessor> UDocGenMdxOutputFactory::CreateInterme
 	{
 		DocusaurusOverride = DocusaurusPath;
 	}
-	return MakeShared<DocGenMdxOutputProcessor>(TemplateOverride, BinaryOverride, NpmOverride, DocRootOverride,
-												DocusaurusOverride);
+	TSharedPtr<DocGenMdxOutputProcessor> Processor = MakeShared<DocGenMdxOutputProcessor>(
+		TemplateOverride, BinaryOverride, NpmOverride, DocRootOverride, DocusaurusOverride);
+	Processor->SetShardedOutput(bShardedOutput);
+	Processor->SetRenderTemplateInProcess(bRenderTemplateInProcess);
+	return Processor;
 }
 
 FString UDocGenMdxOutputFactory::GetFormatIdentifier()
@@ -139,6 +155,12 @@ FString UDocGenMdxOutputFactory::GetFormatIdentifier()
 	return "mdx";
 }
 
+FString UDocGenMdxOutputFactory::GetIntermediateFormatIdentifier()
+{
+	// JSON and MDX share the same intermediate serialization
+	return "json";
+}
+
 void UDocGenMdxOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySettings& Settings)
 {
 	if (Settings.SettingValues.Contains("template"))
@@ -181,6 +203,14 @@ void UDocGenMdxOutputFactory::LoadSettings(const FDocGenOutputFormatFactorySetti
 			bOverrideDocusaurusPath = (Settings.SettingValues["overridedocusaurus"] == "true");
 		}
 	}
+	if (Settings.SettingValues.Contains("sharded"))
+	{
+		bShardedOutput = (Settings.SettingValues["sharded"] == "true");
+	}
+	if (Settings.SettingValues.Contains("inprocesstemplate"))
+	{
+		bRenderTemplateInProcess = (Settings.SettingValues["inprocesstemplate"] == "true");
+	}
 }
 
 FDocGenOutputFormatFactorySettings UDocGenMdxOutputFactory::SaveSettings()
@@ -216,6 +246,15 @@ FDocGenOutputFormatFactorySettings UDocGenMdxOutputFactory::SaveSettings()
 	}
 	Settings.SettingValues.Add("docusaurus", DocusaurusPath.Path);
 
+	if (bShardedOutput)
+	{
+		Settings.SettingValues.Add("sharded", "true");
+	}
+	if (bRenderTemplateInProcess)
+	{
+		Settings.SettingValues.Add("inprocesstemplate", "true");
+	}
+
 	Settings.FactoryClass = StaticClass();
 	return Settings;
 }
@@ -17,7 +17,8 @@ class DocGenMdxSerializer : public DocTreeNode::IDocTreeSerializer
 	virtual FString GetFileExtension() override;
 	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
 
-	TSharedPtr<class FJsonValueArray> SerializeArray(const TArray<TSharedPtr<DocTreeNode>> ArrayElements);
+	TSharedPtr<class FJsonValueArray> SerializeArray(
+		const TArray<TSharedPtr<DocTreeNode, ESPMode::ThreadSafe>> ArrayElements);
 
 	virtual void SerializeString(const FString& InString) override;
 	virtual void SerializeNull() override;
@@ -26,6 +27,7 @@ public:
 	DocGenMdxSerializer(TSharedPtr<FJsonValue>& TargetObject);;
 	DocGenMdxSerializer();
 	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName);;
+	virtual bool SaveToBuffer(TArray<uint8>& OutBuffer) override;
 };
 
 UCLASS(meta = (DisplayName = "MDX"), Meta = (ShowOnlyInnerProperties), Config = EditorPerProjectUserSettings)
@@ -37,6 +39,7 @@ public:
 	virtual TSharedPtr<struct DocTreeNode::IDocTreeSerializer> CreateSerializer() override;
 	virtual TSharedPtr<struct IDocGenOutputProcessor> CreateIntermediateDocProcessor() override;
 	virtual FString GetFormatIdentifier() override;
+	virtual FString GetIntermediateFormatIdentifier() override;
 
 	virtual void LoadSettings(const FDocGenOutputFormatFactorySettings& Settings);
 
@@ -66,4 +69,14 @@ public:
 	bool bOverrideDocusaurusPath = false;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bOverrideDocusaurusPath"))
 	FDirectoryPath DocusaurusPath;
+
+	// Writes a page per class, struct and enum plus a generated index and sidebar instead of a single refdocs.mdx
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bShardedOutput = false;
+
+	// Renders refdocs.mdx in process instead of running convert.exe. Not byte-compared with convert.exe yet, which is
+	// also run in its markdown mode the in process renderer doesn't reproduce. Sharded output always renders in
+	// process.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bRenderTemplateInProcess = false;
 };
\ No newline at end of file
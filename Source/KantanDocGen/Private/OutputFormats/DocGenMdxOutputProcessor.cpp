@@ -1,342 +1,478 @@
 #include "OutputFormats/DocGenMdxOutputProcessor.h"
 #include "Algo/Transform.h"
+#include "Async/ParallelFor.h"
+#include "DocGenChildProcess.h"
+#include "DocGenDirectoryCleaner.h"
+#include "DocGenImageManifest.h"
+#include "DocGenOutputManifest.h"
+#include "DocGenProcessLimiter.h"
+#include "DocGenUTF8.h"
+#include "DocGenWriteQueue.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformFileManager.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Json.h"
-#include "JsonDomBuilder.h"
 #include "KantanDocGenLog.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Optional.h"
 #include "Misc/Paths.h"
+#include "OutputFormats/DocGenConsolidator.h"
+#include "OutputFormats/DocGenTemplate.h"
+#include "Serialization/MemoryWriter.h"
+#include "ThreadingHelpers.h"
 
-FString DocGenMdxOutputProcessor::Quote(const FString& In)
+namespace
 {
-	if (In.TrimStartAndEnd().StartsWith("\""))
+	/// @brief Quotes Text for yaml front matter
+	FString QuoteYamlString(const FString& Text)
 	{
-		return In;
+		return TEXT("\"") + Text.ReplaceCharWithEscapedChar() + TEXT("\"");
 	}
-	return "\"" + In.TrimStartAndEnd() + "\"";
-}
 
-TOptional<FString> DocGenMdxOutputProcessor::GetObjectStringField(const TSharedPtr<FJsonObject> Obj,
-																  const FString& FieldName)
-{
-	FString FieldValue;
-	if (!Obj->TryGetStringField(FieldName, FieldValue))
+	/// @brief Collects the files below Directory, relative to it, leaving out what npm and docusaurus generate
+	void FindStagingSourceFiles(const FString& Directory, const FString& RelativePath, TArray<FString>& OutFiles)
 	{
-		return {};
+		IFileManager::Get().IterateDirectory(*(Directory / RelativePath), [&](const TCHAR* Path, bool bIsDirectory) {
+			const FString Name = FPaths::GetCleanFilename(Path);
+			const FString ChildPath = RelativePath.IsEmpty() ? Name : RelativePath / Name;
+			if (!bIsDirectory)
+			{
+				OutFiles.Add(ChildPath);
+			}
+			else if (Name != TEXT("node_modules") &&
+					 !(RelativePath.IsEmpty() && (Name == TEXT("build") || Name == TEXT(".docusaurus"))))
+			{
+				FindStagingSourceFiles(Directory, ChildPath, OutFiles);
+			}
+			return true;
+		});
 	}
-	else
+
+	/// @brief Hashes the files npm install works from, an install is only needed when this changes
+	FString HashPackageFiles(const FString& PackageDir)
 	{
-		return FieldValue;
+		TArray<uint8> PackageFiles;
+		for (const TCHAR* FileName : {TEXT("package.json"), TEXT("package-lock.json")})
+		{
+			TArray<uint8> Bytes;
+			FFileHelper::LoadFileToArray(Bytes, *(PackageDir / FileName), FILEREAD_Silent);
+			PackageFiles.Append(Bytes);
+			// Keeps moving bytes between the two files from going unnoticed
+			PackageFiles.Add(0);
+		}
+		return FString::Printf(TEXT("%016llx"),
+							   FDocGenOutputManifest::HashBytes(PackageFiles.GetData(), PackageFiles.Num()));
 	}
-}
 
-TOptional<FString> DocGenMdxOutputProcessor::GetObjectStringField(const TSharedPtr<FJsonValue> Obj,
-																  const FString& FieldName)
-{
-	const TSharedPtr<FJsonObject>* UnderlyingObject = nullptr;
-	if (!Obj->TryGetObject(UnderlyingObject))
+	/// @brief Escapes the characters markdown or jsx would interpret in link text
+	FString EscapeMdxText(const FString& Text)
 	{
-		return {};
+		FString Escaped;
+		for (TCHAR Char : Text)
+		{
+			if (FCString::Strchr(TEXT("\\`*_{}[]<>"), Char))
+			{
+				Escaped.AppendChar(TEXT('\\'));
+			}
+			Escaped.AppendChar(Char);
+		}
+		return Escaped;
 	}
-	else
+} // namespace
+
+FString DocGenMdxOutputProcessor::Quote(const FString& In)
+{
+	if (In.TrimStartAndEnd().StartsWith("\""))
 	{
-		return GetObjectStringField(*UnderlyingObject, FieldName);
+		return In;
 	}
+	return "\"" + In.TrimStartAndEnd() + "\"";
 }
 
-TOptional<TArray<FString>> DocGenMdxOutputProcessor::GetNamesFromFileAtLocation(const FString& NameType,
-																				const FString& ClassFile)
+EIntermediateProcessingResult DocGenMdxOutputProcessor::ConvertJsonToMdx(FString IntermediateDir)
 {
-	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFile);
-	if (!ParsedClass)
-	{
-		return {};
-	}
+	const FFilePath OutMdxPath {IntermediateDir / TEXT("docs.mdx")};
 
-	if (ParsedClass->HasTypedField<EJson::Array>(NameType))
+	const TSharedPtr<FJsonObject> ConsolidatedDocument = (bShardedOutput || bRenderTemplateInProcess) && Consolidator
+															 ? Consolidator->LoadConsolidatedDocument()
+															 : nullptr;
+	TSharedPtr<FDocGenTemplate> ShardTemplate;
+	if (bShardedOutput && ConsolidatedDocument)
 	{
-		TArray<FString> NodeNames;
-		for (const auto& Value : ParsedClass->GetArrayField(NameType))
+		FString Error;
+		ShardTemplate = FDocGenTemplate::Compile(TemplatePath.FilePath, Error);
+		if (!ShardTemplate)
 		{
-			TOptional<FString> FuncID = GetObjectStringField(Value, "id");
-			if (FuncID.IsSet())
-			{
-				NodeNames.Add(FuncID.GetValue());
-			}
+			UE_LOG(LogKantanDocGen, Warning,
+				   TEXT("Sharded output needs a template that renders in process, writing a single page instead: %s"),
+				   *Error);
 		}
-		return NodeNames;
 	}
-	else if (ParsedClass->HasTypedField<EJson::Object>(NameType))
+
+	// Unless asked to render in process, or the template uses something the in process renderer doesn't support, the
+	// single page is rendered by convert.exe in its markdown mode
+	if (!ShardTemplate &&
+		(!bRenderTemplateInProcess || !ConsolidatedDocument ||
+		 !FDocGenTemplate::RenderFile(TemplatePath.FilePath, ConsolidatedDocument, OutMdxPath.FilePath)))
 	{
-		TArray<FString> NodeNames;
-		for (const auto& Node : ParsedClass->GetObjectField(NameType)->Values)
+		const FFilePath InJsonPath {Consolidator ? Consolidator->GetStandaloneDocumentPath()
+												 : IntermediateDir / FDocGenConsolidator::ConsolidatedFileName};
+		if (InJsonPath.FilePath.IsEmpty())
 		{
-			TOptional<FString> Name = GetObjectStringField(Node.Value, "id");
-			if (Name.IsSet())
-			{
-				NodeNames.Add(Name.GetValue());
-			}
+			return EIntermediateProcessingResult::UnknownError;
 		}
-		return NodeNames;
-	}
-	else if (ParsedClass->HasTypedField<EJson::Null>(NameType))
-	{
-		return TArray<FString>();
-	}
-	return {};
-}
+		const FString Format {TEXT("markdown")};
+		const FString Args = Quote(TemplatePath.FilePath) + " " + Quote(InJsonPath.FilePath) + " " +
+							 Quote(OutMdxPath.FilePath) + " " + Quote(Format);
 
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::ParseNodeFile(const FString& NodeFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedNode = LoadFileToJson(NodeFilePath);
-	if (!ParsedNode)
-	{
-		return {};
-	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-
-	CopyJsonField("inputs", ParsedNode, OutNode);
-	CopyJsonField("outputs", ParsedNode, OutNode);
-	CopyJsonField("rawsignature", ParsedNode, OutNode);
-	CopyJsonField("class_id", ParsedNode, OutNode);
-	CopyJsonField("doxygen", ParsedNode, OutNode);
-	CopyJsonField("imgpath", ParsedNode, OutNode);
-	CopyJsonField("shorttitle", ParsedNode, OutNode);
-	CopyJsonField("fulltitle", ParsedNode, OutNode);
-	CopyJsonField("static", ParsedNode, OutNode);
-	CopyJsonField("autocast", ParsedNode, OutNode);
-	CopyJsonField("funcname", ParsedNode, OutNode);
-	CopyJsonField("access_specifier", ParsedNode, OutNode);
-	CopyJsonField("meta", ParsedNode, OutNode);
-	return OutNode;
-}
+		FDocGenChildProcess ConvertProcess(BinaryPath.Path / TEXT("convert.exe"), Args);
+		ConvertProcess.SetProcessLimiter(ProcessLimiter);
+		ConvertProcess.SetOutputLineHandler(
+			[](const FString& Line) { UE_LOG(LogKantanDocGen, Error, TEXT("[KantanDocGen] %s"), *Line); });
 
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::ParseClassFile(const FString& ClassFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedClass = LoadFileToJson(ClassFilePath);
-	if (!ParsedClass)
-	{
-		return {};
+		int32 ReturnCode = 0;
+		if (ConvertProcess.Run(ReturnCode) != FDocGenChildProcess::EResult::Exited)
+		{
+			return EIntermediateProcessingResult::UnknownError;
+		}
+		if (ReturnCode != 0)
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
+			return EIntermediateProcessingResult::UnknownError;
+		}
 	}
 
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-	// Reusing the class template for now so renaming id to class_id to be consistent
-	if (TSharedPtr<FJsonValue> Field = ParsedClass->TryGetField(TEXT("id")))
+	// Sync the docusaurus template into the persistent staging directory, with doc_root merged into its public
+	// directory. Only files whose content changed are written, the staging manifest tracks what an earlier run left.
+	TMap<FString, FString> StagingSources;
+	TArray<FString> TemplateFiles;
+	FindStagingSourceFiles(DocusaurusPath.Path, FString(), TemplateFiles);
+	if (!TemplateFiles.Num())
 	{
-		OutNode->SetField("class_id", Field);
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to find the docusaurus template in %s"), *DocusaurusPath.Path);
+		return EIntermediateProcessingResult::UnknownError;
 	}
-
-	CopyJsonField(TEXT("doxygen"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("display_name"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("fields"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("parent_class"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("meta"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("blueprint_generated"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("widget_blueprint"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("class_path"), ParsedClass, OutNode);
-	CopyJsonField(TEXT("context_string"), ParsedClass, OutNode);
-	return OutNode;
-}
-
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::ParseStructFile(const FString& StructFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedStruct = LoadFileToJson(StructFilePath);
-	if (!ParsedStruct)
+	for (const FString& TemplateFile : TemplateFiles)
 	{
-		return {};
+		StagingSources.Add(TemplateFile, DocusaurusPath.Path / TemplateFile);
 	}
-
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-	// Reusing the class template for now so renaming id to class_id to be consistent
-	if (TSharedPtr<FJsonValue> Field = ParsedStruct->TryGetField(TEXT("id")))
+	TArray<FString> DocRootFiles;
+	FindStagingSourceFiles(DocRootPath.Path, FString(), DocRootFiles);
+	for (const FString& DocRootFile : DocRootFiles)
 	{
-		OutNode->SetField(TEXT("class_id"), Field);
+		// The template's own files take precedence
+		if (!StagingSources.Contains(TEXT("public") / DocRootFile))
+		{
+			StagingSources.Add(TEXT("public") / DocRootFile, DocRootPath.Path / DocRootFile);
+		}
 	}
-
-	CopyJsonField(TEXT("doxygen"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("display_name"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("fields"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("parent_class"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("meta"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("blueprint_generated"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("widget_blueprint"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("class_path"), ParsedStruct, OutNode);
-	CopyJsonField(TEXT("context_string"), ParsedStruct, OutNode);
-	return OutNode;
-}
-
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::ParseEnumFile(const FString& EnumFilePath)
-{
-	TSharedPtr<FJsonObject> ParsedEnum = LoadFileToJson(EnumFilePath);
-	if (!ParsedEnum)
+	for (const auto& StagingSource : StagingSources)
 	{
-		return {};
+		WriteQueue->EnqueueCopy(StagingPath / StagingSource.Key, StagingSource.Value);
 	}
 
-	TSharedPtr<FJsonObject> OutNode = MakeShared<FJsonObject>();
-
-	CopyJsonField(TEXT("id"), ParsedEnum, OutNode);
-	CopyJsonField(TEXT("doxygen"), ParsedEnum, OutNode);
-	CopyJsonField(TEXT("display_name"), ParsedEnum, OutNode);
-	CopyJsonField(TEXT("values"), ParsedEnum, OutNode);
-	CopyJsonField(TEXT("meta"), ParsedEnum, OutNode);
-
-	return OutNode;
-}
-
-void DocGenMdxOutputProcessor::CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode,
-											 TSharedPtr<FJsonObject> OutNode)
-{
-	if (TSharedPtr<FJsonValue> Field = ParsedNode->TryGetField(FieldName))
+	// copy the newly generated mdx and img files into staging directory
+	const FFilePath MdxDestinationPath {StagingPath / TEXT("public/en-us/refdocs.mdx")};
+	const FDirectoryPath ImgDestinationPath {StagingPath / TEXT("public/en-us/img/refdocs")};
+	if (ShardTemplate)
 	{
-		OutNode->SetField(FieldName, Field);
+		const EIntermediateProcessingResult ShardResult =
+			WriteShardedMdx(*ShardTemplate, ConsolidatedDocument, StagingPath / TEXT("public/en-us"));
+		if (ShardResult != EIntermediateProcessingResult::Success)
+		{
+			return ShardResult;
+		}
 	}
-}
-
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::InitializeMainOutputFromIndex(TSharedPtr<FJsonObject> ParsedIndex)
-{
-	TSharedPtr<FJsonObject> Output = MakeShared<FJsonObject>();
-
-	CopyJsonField(TEXT("display_name"), ParsedIndex, Output);
-	return Output;
-}
-
-EIntermediateProcessingResult DocGenMdxOutputProcessor::ConvertJsonToMdx(FString IntermediateDir)
-{
-	const FFilePath InJsonPath {IntermediateDir / TEXT("consolidated.json")};
-	const FFilePath OutMdxPath {IntermediateDir / TEXT("docs.mdx")};
-
-	const FString Format {TEXT("markdown")};
-	void* PipeRead = nullptr;
-	void* PipeWrite = nullptr;
-	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
-
-	const FString Args = Quote(TemplatePath.FilePath) + " " + Quote(InJsonPath.FilePath) + " " +
-						 Quote(OutMdxPath.FilePath) + " " + Quote(Format);
-
-	FProcHandle Proc = FPlatformProcess::CreateProc(*(BinaryPath.Path / TEXT("convert.exe")), *Args, true, false, false,
-													nullptr, 0, nullptr, PipeWrite);
-	if (!Proc.IsValid())
+	else
 	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create process %s"), *(BinaryPath.Path / TEXT("convert.exe")));
-		return EIntermediateProcessingResult::UnknownError;
+		WriteQueue->EnqueueCopy(MdxDestinationPath.FilePath, OutMdxPath.FilePath);
 	}
-
-	FString BufferedText;
-	int32 ReturnCode = 0;
-	for (bool bProcessFinished = false; !bProcessFinished;)
+	const TSharedPtr<FDocGenImageManifest> ImageManifest =
+		FDocGenImageManifest::Load(IntermediateDir / FDocGenImageManifest::ManifestFileName);
+	if (!ImageManifest)
 	{
-		bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
-		BufferedText += FPlatformProcess::ReadPipe(PipeRead);
-		int32 EndOfLineIdx;
-		while (BufferedText.FindChar('\n', EndOfLineIdx))
+		UE_LOG(LogKantanDocGen, Warning, TEXT("No image manifest in %s, images won't be copied"), *IntermediateDir);
+	}
+	else
+	{
+		for (const FDocGenImageManifest::FImage& Image : ImageManifest->GetImages())
 		{
-			FString Line = BufferedText.Left(EndOfLineIdx);
-			Line.RemoveFromEnd(TEXT("\r"));
-
-			UE_LOG(LogKantanDocGen, Error, TEXT("[KantanDocGen] %s"), *Line);
-
-			BufferedText = BufferedText.Mid(EndOfLineIdx + 1);
+			// if this limit is adjusted, all <plugin>/Doc/template/function.mdx.in files must be updated to match
+			if (Image.Id.Len() > 140)
+			{
+				UE_LOG(LogKantanDocGen, Warning,
+					   TEXT("Skipping image with filename length %d to avoid windows path length restrictions: %s"),
+					   Image.Id.Len(), *Image.Id);
+				continue;
+			}
+			FDocGenImageManifest::EnqueuePlacement(*WriteQueue, ImgDestinationPath.Path / Image.Id, Image);
 		}
-
-		FPlatformProcess::Sleep(0.1f);
 	}
-	FPlatformProcess::CloseProc(Proc);
-	Proc.Reset();
-	if (ReturnCode != 0)
+	if (!WriteQueue->Flush())
 	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to update docusaurus staging directory %s"), *StagingPath);
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	// create docusaurus staging directory
-	const FString DocusaurusStagingPath {IntermediateDir / TEXT("docusaurus")};
-	if (!FPlatformFileManager::Get().GetPlatformFile().CopyDirectoryTree(*DocusaurusStagingPath, *DocusaurusPath.Path,
-																		 true))
-	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy template docusaurus %s to intermediate directory %s"),
-			   *DocusaurusPath.Path, *DocusaurusStagingPath);
-		return EIntermediateProcessingResult::UnknownError;
+	// Everything staged this run is in place, so whatever an earlier run staged and this one didn't is stale: pages
+	// of removed types, their images, files removed from the template
+	StagingManifest->RemoveStaleFiles();
+	StagingManifest->Save();
+	UE_LOG(LogKantanDocGen, Log, TEXT("Docusaurus staging: %d files updated, %d unchanged"),
+		   StagingManifest->GetWrittenCount(), StagingManifest->GetSkippedCount());
+	return EIntermediateProcessingResult::Success;
+}
+
+EIntermediateProcessingResult DocGenMdxOutputProcessor::WriteShardedMdx(
+	const FDocGenTemplate& Template, const TSharedPtr<FJsonObject>& ConsolidatedDocument, const FString& DocsPath)
+{
+	struct FShardKind
+	{
+		const TCHAR* MemberName;
+		const TCHAR* IdField;
+		const TCHAR* Label;
+		// Classes are an object keyed by class id, the other kinds arrays
+		bool bKeyedById;
+	};
+	static const FShardKind ShardKinds[] = {
+		{TEXT("classes"), TEXT("class_id"), TEXT("Classes"), true},
+		{TEXT("structs"), TEXT("class_id"), TEXT("Structs"), false},
+		{TEXT("enums"), TEXT("id"), TEXT("Enums"), false},
+	};
+
+	struct FShard
+	{
+		const FShardKind* Kind = nullptr;
+		// Key of the document in its kind's object, empty for kinds that are arrays
+		FString Key;
+		FString Id;
+		FString Title;
+		TSharedPtr<FJsonValue> Document;
+	};
+	TArray<FShard> Shards;
+	for (const FShardKind& Kind : ShardKinds)
+	{
+		TArray<TPair<FString, TSharedPtr<FJsonValue>>> Documents;
+		if (Kind.bKeyedById)
+		{
+			const TSharedPtr<FJsonObject>* DocumentsObject = nullptr;
+			if (ConsolidatedDocument->TryGetObjectField(Kind.MemberName, DocumentsObject))
+			{
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : (*DocumentsObject)->Values)
+				{
+					Documents.Emplace(Entry.Key, Entry.Value);
+				}
+			}
+		}
+		else
+		{
+			const TArray<TSharedPtr<FJsonValue>>* DocumentsArray = nullptr;
+			if (ConsolidatedDocument->TryGetArrayField(Kind.MemberName, DocumentsArray))
+			{
+				for (const TSharedPtr<FJsonValue>& Document : *DocumentsArray)
+				{
+					Documents.Emplace(FString(), Document);
+				}
+			}
+		}
+		for (TPair<FString, TSharedPtr<FJsonValue>>& Document : Documents)
+		{
+			const TSharedPtr<FJsonObject>* DocumentObject = nullptr;
+			FShard Shard;
+			if (!Document.Value->TryGetObject(DocumentObject) ||
+				!(*DocumentObject)->TryGetStringField(Kind.IdField, Shard.Id))
+			{
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Skipping an entry of %s without %s"), Kind.MemberName,
+					   Kind.IdField);
+				continue;
+			}
+			if (!(*DocumentObject)->TryGetStringField(TEXT("display_name"), Shard.Title) || Shard.Title.IsEmpty())
+			{
+				Shard.Title = Shard.Id;
+			}
+			Shard.Kind = &Kind;
+			Shard.Key = MoveTemp(Document.Key);
+			Shard.Document = MoveTemp(Document.Value);
+			Shards.Add(MoveTemp(Shard));
+		}
 	}
 
-	// merge doc_root into staging directory
-	if (!FPlatformFileManager::Get().GetPlatformFile().CopyDirectoryTree(*(DocusaurusStagingPath / "public"),
-																		 *(DocRootPath.Path), false))
+	// The top level functions are the static functions of every class, each class page only gets its own
+	const bool bHasFunctions = ConsolidatedDocument->HasField(TEXT("functions"));
+	TMap<FString, TArray<TSharedPtr<FJsonValue>>> FunctionsByClass;
+	const TArray<TSharedPtr<FJsonValue>>* Functions = nullptr;
+	if (ConsolidatedDocument->TryGetArrayField(TEXT("functions"), Functions))
 	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to merge doc_root %s into docusaurus staging directory %s"),
-			   *(DocRootPath.Path), *(DocusaurusStagingPath / TEXT("public")));
-		return EIntermediateProcessingResult::UnknownError;
+		for (const TSharedPtr<FJsonValue>& Function : *Functions)
+		{
+			const TSharedPtr<FJsonObject>* FunctionObject = nullptr;
+			FString FunctionClassId;
+			if (Function->TryGetObject(FunctionObject) &&
+				(*FunctionObject)->TryGetStringField(TEXT("class_id"), FunctionClassId))
+			{
+				FunctionsByClass.FindOrAdd(FunctionClassId).Add(Function);
+			}
+		}
 	}
 
-	// copy the newly generated mdx and img files into staging directory
-	const FFilePath MdxDestinationPath {DocusaurusStagingPath / TEXT("public/en-us/refdocs.mdx")};
-	const FDirectoryPath ImgDestinationPath {DocusaurusStagingPath / TEXT("public/en-us/img/refdocs")};
-	if (IFileManager::Get().Copy(*MdxDestinationPath.FilePath, *OutMdxPath.FilePath) != 0)
+	// Every shard is rendered with the whole template, from a document that only lists its own type. The lists of the
+	// other kinds are left empty but keep their types. Templates can tell which page they're rendering from the shard
+	// object, and reach the docs root through its root path.
+	const FString RefDocsPath = DocsPath / TEXT("refdocs");
+	FThreadSafeCounter FailedShards;
+	// Shard documents share the consolidated document's values, so they're only rendered in parallel where that's safe
+	ParallelFor(Shards.Num(), [&](int32 ShardIndex) {
+		if (ProcessLimiter && ProcessLimiter->IsCancelRequested())
+		{
+			return;
+		}
+		const FShard& Shard = Shards[ShardIndex];
+		TSharedPtr<FJsonObject> ShardDocument = MakeShared<FJsonObject>();
+		ShardDocument->Values = ConsolidatedDocument->Values;
+		for (const FShardKind& Kind : ShardKinds)
+		{
+			const bool bOwnKind = &Kind == Shard.Kind;
+			if (Kind.bKeyedById)
+			{
+				TSharedPtr<FJsonObject> KindDocuments = MakeShared<FJsonObject>();
+				if (bOwnKind)
+				{
+					KindDocuments->SetField(Shard.Key, Shard.Document);
+				}
+				ShardDocument->SetObjectField(Kind.MemberName, KindDocuments);
+			}
+			else
+			{
+				TArray<TSharedPtr<FJsonValue>> KindDocuments;
+				if (bOwnKind)
+				{
+					KindDocuments.Add(Shard.Document);
+				}
+				ShardDocument->SetArrayField(Kind.MemberName, KindDocuments);
+			}
+		}
+		if (bHasFunctions)
+		{
+			const TArray<TSharedPtr<FJsonValue>>* ClassFunctions =
+				Shard.Kind->bKeyedById ? FunctionsByClass.Find(Shard.Id) : nullptr;
+			ShardDocument->SetArrayField(TEXT("functions"),
+										 ClassFunctions ? *ClassFunctions : TArray<TSharedPtr<FJsonValue>>());
+		}
+		TSharedPtr<FJsonObject> ShardInfo = MakeShared<FJsonObject>();
+		ShardInfo->SetStringField(TEXT("kind"), Shard.Kind->MemberName);
+		ShardInfo->SetStringField(TEXT("id"), Shard.Id);
+		ShardInfo->SetStringField(TEXT("title"), Shard.Title);
+		ShardInfo->SetStringField(TEXT("root"), TEXT("../../"));
+		ShardDocument->SetObjectField(TEXT("shard"), ShardInfo);
+
+		TArray<uint8> Page;
+		FMemoryWriter PageWriter(Page);
+		FString Error;
+		if (!Template.Render(ShardDocument, PageWriter, Error))
+		{
+			UE_LOG(LogKantanDocGen, Error, TEXT("Failed to render the page of %s: %s"), *Shard.Id, *Error);
+			FailedShards.Increment();
+			return;
+		}
+		WriteQueue->EnqueueWrite(RefDocsPath / Shard.Kind->MemberName / Shard.Id + TEXT(".mdx"), MoveTemp(Page));
+	}, !DocGenThreads::bThreadSafeJson);
+	if (ProcessLimiter && ProcessLimiter->IsCancelRequested())
 	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy generated file %s to %s"), *OutMdxPath.FilePath,
-			   *MdxDestinationPath.FilePath);
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Rendering mdx pages was cancelled"));
 		return EIntermediateProcessingResult::UnknownError;
 	}
-	TArray<FString> ImgDirectories;
-	IFileManager::Get().FindFilesRecursive(ImgDirectories, *IntermediateDir, TEXT("img"), false, true);
-	for (FString ImgDirectory : ImgDirectories)
+	if (FailedShards.GetValue())
 	{
-		if (ImgDirectory.Contains(DocusaurusStagingPath))
-		{
-			continue;
-		}
-		TArray<FString> ImageFiles;
-		IFileManager::Get().FindFiles(ImageFiles, *ImgDirectory, TEXT("png"));
-		for (FString Image : ImageFiles)
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to render %d mdx pages, see above output."),
+			   FailedShards.GetValue());
+		return EIntermediateProcessingResult::UnknownError;
+	}
+
+	// The index page links every shard, sidebar.json lists them in the same order for sidebars.js to require
+	FString DocTitle;
+	ConsolidatedDocument->TryGetStringField(TEXT("display_name"), DocTitle);
+	FString IndexPage = FString::Printf(TEXT("---\ntitle: %s\n---\n"), *QuoteYamlString(DocTitle));
+	TArray<TSharedPtr<FJsonValue>> SidebarItems;
+	TSharedPtr<FJsonObject> IndexItem = MakeShared<FJsonObject>();
+	IndexItem->SetStringField(TEXT("type"), TEXT("doc"));
+	IndexItem->SetStringField(TEXT("id"), TEXT("refdocs/index"));
+	IndexItem->SetStringField(TEXT("label"), TEXT("Overview"));
+	SidebarItems.Add(MakeShared<FJsonValueObject>(IndexItem));
+	for (const FShardKind& Kind : ShardKinds)
+	{
+		TArray<TSharedPtr<FJsonValue>> CategoryItems;
+		for (const FShard& Shard : Shards)
 		{
-			// if this limit is adjusted, all <plugin>/Doc/template/function.mdx.in files must be updated to match
-			if (Image.Len() > 140)
+			if (Shard.Kind != &Kind)
 			{
-				UE_LOG(LogKantanDocGen, Warning,
-					   TEXT("Skipping image with filename length %d to avoid windows path length restrictions: %s"),
-					   Image.Len(), *Image);
 				continue;
 			}
-			FString SourceImagePath {ImgDirectory / Image};
-			FString DestinationImagePath {ImgDestinationPath.Path / Image};
-			if (IFileManager::Get().Copy(*DestinationImagePath, *SourceImagePath) != 0)
+			const FString DocId = FString::Printf(TEXT("%s/%s"), Kind.MemberName, *Shard.Id);
+			if (!CategoryItems.Num())
 			{
-				UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy %s to %s"), *SourceImagePath,
-					   *DestinationImagePath);
-				return EIntermediateProcessingResult::UnknownError;
+				IndexPage += FString::Printf(TEXT("\n## %s\n\n"), Kind.Label);
 			}
+			IndexPage += FString::Printf(TEXT("- [%s](./%s)\n"), *EscapeMdxText(Shard.Title), *DocId);
+			TSharedPtr<FJsonObject> Item = MakeShared<FJsonObject>();
+			Item->SetStringField(TEXT("type"), TEXT("doc"));
+			Item->SetStringField(TEXT("id"), TEXT("refdocs/") + DocId);
+			Item->SetStringField(TEXT("label"), Shard.Title);
+			CategoryItems.Add(MakeShared<FJsonValueObject>(Item));
+		}
+		if (CategoryItems.Num())
+		{
+			TSharedPtr<FJsonObject> Category = MakeShared<FJsonObject>();
+			Category->SetStringField(TEXT("type"), TEXT("category"));
+			Category->SetStringField(TEXT("label"), Kind.Label);
+			Category->SetArrayField(TEXT("items"), CategoryItems);
+			SidebarItems.Add(MakeShared<FJsonValueObject>(Category));
 		}
 	}
+	FString Sidebar;
+	FJsonSerializer::Serialize(SidebarItems, TJsonWriterFactory<>::Create(&Sidebar));
+	WriteQueue->EnqueueWrite(RefDocsPath / TEXT("index.mdx"), DocGenUTF8::FromString(IndexPage));
+	WriteQueue->EnqueueWrite(RefDocsPath / TEXT("sidebar.json"), DocGenUTF8::FromString(Sidebar));
+
+	UE_LOG(LogKantanDocGen, Log, TEXT("Rendered %d mdx pages"), Shards.Num());
 	return EIntermediateProcessingResult::Success;
 }
 
 EIntermediateProcessingResult DocGenMdxOutputProcessor::ConvertMdxToHtml(FString IntermediateDir, FString OutputDir)
 {
-	const FString DocusaurusStagingPath {IntermediateDir / TEXT("docusaurus")};
-
-	// invoke npm install to install required packages
-	if (const EIntermediateProcessingResult ReturnCode = RunNPMCommand(TEXT("install"), DocusaurusStagingPath);
-		ReturnCode != EIntermediateProcessingResult::Success)
+	// invoke npm install to install required packages, unless the installed ones came from the same package files.
+	// The stamp lives in node_modules so deleting it forces a fresh install.
+	const FString InstallStampPath = StagingPath / TEXT("node_modules") / TEXT(".kantandocgen-install");
+	const FString PackageHash = HashPackageFiles(StagingPath);
+	FString InstalledPackageHash;
+	if (FFileHelper::LoadFileToString(InstalledPackageHash, *InstallStampPath) && InstalledPackageHash == PackageHash)
 	{
-		return ReturnCode;
+		UE_LOG(LogKantanDocGen, Log, TEXT("npm packages are up to date, skipping npm install"));
+	}
+	else
+	{
+		if (const EIntermediateProcessingResult ReturnCode = RunNPMCommand(TEXT("install"), StagingPath);
+			ReturnCode != EIntermediateProcessingResult::Success)
+		{
+			return ReturnCode;
+		}
+		FFileHelper::SaveStringToFile(PackageHash, *InstallStampPath);
 	}
 
 	// invoke npm run build to build the html docs
-	if (const EIntermediateProcessingResult ReturnCode = RunNPMCommand(TEXT("run build"), DocusaurusStagingPath);
+	// The staging directory persists, so docusaurus and webpack reuse their caches in it and only rebuild what
+	// changed
+	if (const EIntermediateProcessingResult ReturnCode = RunNPMCommand(TEXT("run build"), StagingPath);
 		ReturnCode != EIntermediateProcessingResult::Success)
 	{
 		return ReturnCode;
 	}
 
-	// copy result from intermediate directory to output directory
+	// copy result from staging directory to output directory
 	if (!FPlatformFileManager::Get().GetPlatformFile().CopyDirectoryTree(
-			*OutputDir, *(DocusaurusStagingPath / TEXT("build")), true))
+			*OutputDir, *(StagingPath / TEXT("build")), true))
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to copy build docs %s to output directory %s"),
-			   *(DocusaurusStagingPath / TEXT("build")), *OutputDir);
+			   *(StagingPath / TEXT("build")), *OutputDir);
 		return EIntermediateProcessingResult::UnknownError;
 	}
 	return EIntermediateProcessingResult::Success;
@@ -367,40 +503,25 @@ EIntermediateProcessingResult DocGenMdxOutputProcessor::RunNPMCommand(const FStr
 
 	FString Args = FString::Printf(TEXT("-e \"%s\""), *JsCode);
 
-	void* ReadPipe = nullptr;
-	void* WritePipe = nullptr;
-	FPlatformProcess::CreatePipe(ReadPipe, WritePipe);
-
-	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*NodeExe, *Args,
-															 true, // bLaunchDetached
-															 false, // bLaunchHidden
-															 false, // bLaunchReallyHidden
-															 nullptr, 0, *PackageJsonPath, WritePipe);
+	FDocGenChildProcess NodeProcess(NodeExe, Args);
+	NodeProcess.SetWorkingDirectory(PackageJsonPath);
+	NodeProcess.SetProcessLimiter(ProcessLimiter);
+	// Only shown if the command fails
+	TArray<FString> OutputLines;
+	NodeProcess.SetOutputLineHandler([&OutputLines](const FString& Line) { OutputLines.Add(Line); });
 
-	if (!ProcessHandle.IsValid())
+	int32 ExitCode = 0;
+	if (NodeProcess.Run(ExitCode) != FDocGenChildProcess::EResult::Exited)
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("npm command [%s] failed for %s"), *Command, *(NpmExecutablePath.FilePath));
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	FString Output;
-	while (FPlatformProcess::IsProcRunning(ProcessHandle))
-	{
-		Output += FPlatformProcess::ReadPipe(ReadPipe);
-		FPlatformProcess::Sleep(0.1f);
-	}
-	// final flush
-	Output += FPlatformProcess::ReadPipe(ReadPipe);
-
-	int32 ExitCode;
-	FPlatformProcess::GetProcReturnCode(ProcessHandle, &ExitCode);
-	FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
-
 	if (ExitCode != 0)
 	{
 		UE_LOG(LogKantanDocGen, Error, TEXT("npm command [%s] error"), *Command);
 		UE_LOG(LogKantanDocGen, Error, TEXT("npm exited with code %d"), ExitCode);
-		UE_LOG(LogKantanDocGen, Error, TEXT("npm output:\n%s"), *Output);
+		UE_LOG(LogKantanDocGen, Error, TEXT("npm output:\n%s"), *FString::Join(OutputLines, TEXT("\n")));
 
 		return EIntermediateProcessingResult::UnknownError;
 	}
@@ -457,267 +578,62 @@ DocGenMdxOutputProcessor::DocGenMdxOutputProcessor(TOptional<FFilePath> Template
 	}
 }
 
-EIntermediateProcessingResult DocGenMdxOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
-																				FString const& OutputDir,
-																				FString const& DocTitle,
-																				bool bCleanOutput)
+void DocGenMdxOutputProcessor::SetOutputManifest(TSharedPtr<FDocGenOutputManifest> Manifest)
 {
-	TSharedPtr<FJsonObject> ParsedIndex = LoadFileToJson(IntermediateDir / TEXT("index.json"));
-
-	TSharedPtr<FJsonObject> ConsolidatedOutput = InitializeMainOutputFromIndex(ParsedIndex);
-
-	EIntermediateProcessingResult ClassResult =
-		ConsolidateClasses(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (ClassResult != EIntermediateProcessingResult::Success)
-	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate classes"));
-		return ClassResult;
-	}
-
-	EIntermediateProcessingResult StructResult =
-		ConsolidateStructs(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (StructResult != EIntermediateProcessingResult::Success)
-	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate structs"));
-		return StructResult;
-	}
-
-	EIntermediateProcessingResult EnumResult =
-		ConsolidateEnums(ParsedIndex, IntermediateDir, OutputDir, ConsolidatedOutput);
-	if (EnumResult != EIntermediateProcessingResult::Success)
-	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate Enums"));
-		return EnumResult;
-	}
-
-	FString Result;
-	auto JsonWriter = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Result);
-	FJsonSerializer::Serialize(ConsolidatedOutput.ToSharedRef(), JsonWriter);
-
-	if (!FFileHelper::SaveStringToFile(Result, *(IntermediateDir / TEXT("consolidated.json")),
-									   FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
-	{
-		return EIntermediateProcessingResult::DiskWriteFailure;
-	}
-	// create mdx and image files, and copy them to doc_root
-	if (ConvertJsonToMdx(IntermediateDir) == EIntermediateProcessingResult::Success)
-	{
-		// invoke npm to convert mdx to html, and copy results to specified output directory
-		return ConvertMdxToHtml(IntermediateDir, OutputDir);
-	}
-
-	UE_LOG(LogKantanDocGen, Error, TEXT("Failed to consolidate due to unknown error"));
-	return EIntermediateProcessingResult::UnknownError;
+	OutputManifest = Manifest;
 }
 
-EIntermediateProcessingResult DocGenMdxOutputProcessor::ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
-																		   FString const& IntermediateDir,
-																		   FString const& OutputDir,
-																		   TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenMdxOutputProcessor::SetDocModel(TSharedPtr<FDocGenDocModel> InDocModel)
 {
-	FJsonDomBuilder::FArray StaticFunctionList;
-	FJsonDomBuilder::FObject ClassFunctionList;
-	TOptional<TArray<FString>> ClassNames = GetNamesFromIndexFile(TEXT("classes"), TEXT("class"), ParsedIndex);
-	if (!ClassNames.IsSet())
-	{
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& ClassName : ClassNames.GetValue())
-	{
-		const FString ClassFilePath = IntermediateDir / ClassName / ClassName + TEXT(".json");
-		TOptional<TArray<FString>> NodeNames = GetNamesFromFileAtLocation(TEXT("nodes"), ClassFilePath);
-		TSharedPtr<FJsonObject> ParsedClass = ParseStructFile(ClassFilePath);
-		if (!NodeNames.IsSet())
-		{
-			return EIntermediateProcessingResult::UnknownError;
-		}
-		else
-		{
-			TOptional<FString> NodeClassID;
-			FJsonDomBuilder::FArray Nodes;
-			for (const auto& NodeName : NodeNames.GetValue())
-			{
-				const FString NodeFilePath = IntermediateDir / ClassName / TEXT("nodes") / NodeName + TEXT(".json");
-
-				if (TSharedPtr<FJsonObject> NodeJson = ParseNodeFile(NodeFilePath))
-				{
-					FString RelImagePath;
-					if (NodeJson->TryGetStringField(TEXT("imgpath"), RelImagePath))
-					{
-						FString SourceImagePath = IntermediateDir / ClassName / TEXT("nodes") / RelImagePath;
-						SourceImagePath =
-							IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SourceImagePath);
-						IFileManager::Get().Copy(*(OutputDir / TEXT("img") / FPaths::GetCleanFilename(RelImagePath)),
-												 *SourceImagePath, true);
-					}
-					bool FunctionIsStatic = false;
-					NodeJson->TryGetBoolField(TEXT("static"), FunctionIsStatic);
-
-					if (FunctionIsStatic)
-					{
-						StaticFunctionList.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-					else
-					{
-						Nodes.Add(MakeShared<FJsonValueObject>(NodeJson));
-					}
-				}
-				else
-				{
-					return EIntermediateProcessingResult::UnknownError;
-				}
-			}
-			// We don't want classes in our classlist if all their nodes are static
-			FJsonDomBuilder::FObject ClassObj;
-			ClassObj.Set(TEXT("functions"), Nodes);
-			ClassObj.Set(TEXT("class_id"), ClassName);
-			ClassObj.Set(TEXT("display_name"), ParsedClass->GetStringField(TEXT("display_name")));
-			ClassObj.Set(TEXT("meta"), MakeShared<FJsonValueObject>(ParsedClass->GetObjectField(TEXT("meta"))));
-			ClassObj.Set(TEXT("parent_class"),
-						 MakeShared<FJsonValueObject>(ParsedClass->GetObjectField(TEXT("parent_class"))));
-			const TSharedPtr<FJsonObject>* DoxygenBlock;
-			bool bHadDoxygenBlock = ParsedClass->TryGetObjectField(TEXT("doxygen"), DoxygenBlock);
-			if (bHadDoxygenBlock)
-			{
-				ClassObj.Set(TEXT("doxygen"), MakeShared<FJsonValueObject>(*DoxygenBlock));
-			}
-			const TArray<TSharedPtr<FJsonValue>>* FieldArray;
-			bool bHadFields = ParsedClass->TryGetArrayField(TEXT("fields"), FieldArray);
-			ClassObj.Set(TEXT("fields"), bHadFields ? MakeShared<FJsonValueArray>(*FieldArray)
-													: MakeShared<FJsonValueArray>(TArray<TSharedPtr<FJsonValue>> {}));
-
-			ClassFunctionList.Set(ClassName, ClassObj);
-		}
-	}
-
-	ConsolidatedOutput->SetField(TEXT("functions"), StaticFunctionList.AsJsonValue());
-	ConsolidatedOutput->SetField(TEXT("classes"), ClassFunctionList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	DocModel = InDocModel;
 }
 
-EIntermediateProcessingResult DocGenMdxOutputProcessor::ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
-																		   FString const& IntermediateDir,
-																		   FString const& OutputDir,
-																		   TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenMdxOutputProcessor::SetDocumentCache(TSharedPtr<FDocGenParsedDocumentCache> InDocumentCache)
 {
-	FJsonDomBuilder::FArray StructList;
-
-	TOptional<TArray<FString>> StructNames = GetNamesFromIndexFile(TEXT("structs"), TEXT("struct"), ParsedIndex);
-	if (!StructNames.IsSet())
-	{
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& StructName : StructNames.GetValue())
-	{
-		const FString StructFilePath = IntermediateDir / StructName / StructName + TEXT(".json");
-		TSharedPtr<FJsonObject> StructJson = ParseStructFile(StructFilePath);
-		StructList.Add(MakeShared<FJsonValueObject>(StructJson));
-	}
-
-	ConsolidatedOutput->SetField(TEXT("structs"), StructList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	DocumentCache = InDocumentCache;
 }
 
-EIntermediateProcessingResult DocGenMdxOutputProcessor::ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex,
-																		 FString const& IntermediateDir,
-																		 FString const& OutputDir,
-																		 TSharedPtr<FJsonObject> ConsolidatedOutput)
+void DocGenMdxOutputProcessor::SetConsolidator(TSharedPtr<FDocGenConsolidator> InConsolidator)
 {
-	FJsonDomBuilder::FArray EnumList;
-
-	TOptional<TArray<FString>> EnumNames = GetNamesFromIndexFile(TEXT("enums"), TEXT("enum"), ParsedIndex);
-	if (!EnumNames.IsSet())
-	{
-		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to get enum names from index file"));
-		return EIntermediateProcessingResult::UnknownError;
-	}
-
-	for (const auto& EnumName : EnumNames.GetValue())
-	{
-		UE_LOG(LogKantanDocGen, Log, TEXT("Processing enum: %s"), *EnumName);
-		const FString EnumFilePath = IntermediateDir / EnumName / EnumName + TEXT(".json");
-		TSharedPtr<FJsonObject> EnumJson = ParseEnumFile(EnumFilePath);
-		EnumList.Add(MakeShared<FJsonValueObject>(EnumJson));
-	}
-
-	ConsolidatedOutput->SetField(TEXT("enums"), EnumList.AsJsonValue());
-	return EIntermediateProcessingResult::Success;
+	Consolidator = InConsolidator;
 }
 
-TOptional<TArray<FString>> DocGenMdxOutputProcessor::GetNamesFromIndexFile(const FString& NameType,
-																		   const FString& ChildNameType,
-																		   TSharedPtr<FJsonObject> ParsedIndex)
+void DocGenMdxOutputProcessor::SetProcessLimiter(TSharedPtr<FDocGenProcessLimiter> InProcessLimiter)
 {
-	if (!ParsedIndex)
-	{
-		return {};
-	}
-	TArray<FString> ClassJsonFiles;
-	TArray<TSharedPtr<FJsonValue>> Entries;
-
-	const TArray<TSharedPtr<FJsonValue>>* ArrayEntries = nullptr;
-	if (ParsedIndex->TryGetArrayField(NameType, ArrayEntries))
-	{
-		Entries = *ArrayEntries;
-	}
-	// If there was only a single entry, it won't be added as an array and our code generator will fail later on.
-	else
-	{
-		const TSharedPtr<FJsonObject>* ArrayObjectEntry = nullptr;
-		if (ParsedIndex->TryGetObjectField(NameType, ArrayObjectEntry))
-		{
-			const TSharedPtr<FJsonObject>* ObjectEntry = nullptr;
-			// This is a special case where we're only storing a single object in the index
-			if ((*ArrayObjectEntry)->TryGetObjectField(ChildNameType, ObjectEntry))
-			{
-				// Wrap the object in a JsonValue for uniform processing
-				Entries.Add(MakeShared<FJsonValueObject>(*ObjectEntry));
-			}
-		}
-	}
+	ProcessLimiter = InProcessLimiter;
+}
 
-	for (const auto& Entry : Entries)
+EIntermediateProcessingResult DocGenMdxOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
+																				FString const& OutputDir,
+																				FString const& DocTitle,
+																				bool bCleanOutput)
+{
+	if (!Consolidator)
 	{
-		TOptional<FString> EnumID = GetObjectStringField(Entry, TEXT("id"));
-		if (EnumID.IsSet())
-		{
-			UE_LOG(LogKantanDocGen, Log, TEXT("Processing entry: %s"), *EnumID.GetValue());
-			ClassJsonFiles.Add(EnumID.GetValue());
-		}
-		else
+		// Run outside of a task, so nothing consolidated the intermediate docs for us
+		Consolidator =
+			MakeShared<FDocGenConsolidator>(IntermediateDir, OutputDir, OutputManifest, DocModel, DocumentCache);
+		const EIntermediateProcessingResult ConsolidationResult = Consolidator->Consolidate();
+		if (ConsolidationResult != EIntermediateProcessingResult::Success)
 		{
-			UE_LOG(LogKantanDocGen, Error, TEXT("Entry missing 'id' field: %s"), *Entry->AsString());
+			return ConsolidationResult;
 		}
 	}
-
-	if (ClassJsonFiles.Num())
-	{
-		return ClassJsonFiles;
-	}
-	else
-	{
-		return {};
-	}
-}
-
-TSharedPtr<FJsonObject> DocGenMdxOutputProcessor::LoadFileToJson(FString const& FilePath)
-{
-	FString IndexFileString;
-	if (!FFileHelper::LoadFileToString(IndexFileString, &FPlatformFileManager::Get().GetPlatformFile(), *FilePath))
+	// The staging directory lives next to the intermediate directory rather than in it, so it survives the
+	// intermediate directory being cleaned and npm packages and build caches carry over between runs
+	StagingPath = IntermediateDir + TEXT(".docusaurus");
+	StagingManifest = FDocGenOutputManifest::Load(StagingPath / FDocGenOutputManifest::ManifestFileName);
+	// Left inside the intermediate directory by earlier versions
+	FDocGenDirectoryCleaner::Delete(IntermediateDir / TEXT("docusaurus"));
+	WriteQueue = MakeShared<FDocGenWriteQueue>();
+	WriteQueue->SetManifest(StagingManifest);
+	// create mdx and image files, and copy them to doc_root
+	if (ConvertJsonToMdx(IntermediateDir) == EIntermediateProcessingResult::Success)
 	{
-		return nullptr;
+		// invoke npm to convert mdx to html, and copy results to specified output directory
+		return ConvertMdxToHtml(IntermediateDir, OutputDir);
 	}
 
-	TSharedPtr<FJsonStringReader> TopLevelJson = FJsonStringReader::Create(IndexFileString);
-	TSharedPtr<FJsonObject> ParsedFile;
-	if (!FJsonSerializer::Deserialize<TCHAR>(*TopLevelJson, ParsedFile, FJsonSerializer::EFlags::None))
-	{
-		return nullptr;
-	}
-	else
-	{
-		return ParsedFile;
-	}
+	UE_LOG(LogKantanDocGen, Error, TEXT("Failed to convert consolidated docs due to unknown error"));
+	return EIntermediateProcessingResult::UnknownError;
 }
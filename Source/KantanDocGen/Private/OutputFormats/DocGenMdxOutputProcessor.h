@@ -10,27 +10,31 @@
 class DocGenMdxOutputProcessor : public IDocGenOutputProcessor
 {
 	FString Quote(const FString& In);
-	TOptional<FString> GetObjectStringField(const TSharedPtr<class FJsonValue> Obj, const FString& FieldName);
-
-	TOptional<FString> GetObjectStringField(const TSharedPtr<FJsonObject> Obj, const FString& FieldName);
-
-	TOptional<TArray<FString>> GetNamesFromFileAtLocation(const FString& NameType, const FString& ClassFile);
-
-	TSharedPtr<class FJsonObject> ParseNodeFile(const FString& NodeFilePath);
-
-	TSharedPtr<FJsonObject> ParseClassFile(const FString& ClassFilePath);
-	TSharedPtr<FJsonObject> ParseStructFile(const FString& StructFilePath);
-	TSharedPtr<FJsonObject> ParseEnumFile(const FString& EnumFilePath);
-	void CopyJsonField(const FString& FieldName, TSharedPtr<FJsonObject> ParsedNode, TSharedPtr<FJsonObject> OutNode);
-	TSharedPtr<FJsonObject> InitializeMainOutputFromIndex(TSharedPtr<FJsonObject> ParsedIndex);
 	EIntermediateProcessingResult ConvertJsonToMdx(FString IntermediateDir);
+	/// @brief Renders a page per class, struct and enum into DocsPath/refdocs, plus an index page and sidebar.json
+	/// listing them. Unchanged pages are skipped through the staging manifest, which also removes pages of types that
+	/// no longer exist.
+	EIntermediateProcessingResult WriteShardedMdx(const class FDocGenTemplate& Template,
+												  const TSharedPtr<class FJsonObject>& ConsolidatedDocument,
+												  const FString& DocsPath);
 	EIntermediateProcessingResult RunNPMCommand(const FString& Command, const FString& PackageJsonPath) const;
 	EIntermediateProcessingResult ConvertMdxToHtml(FString IntermediateDir, FString OutputDir);
+	TSharedPtr<class FDocGenWriteQueue> WriteQueue;
+	TSharedPtr<class FDocGenOutputManifest> OutputManifest;
+	TSharedPtr<class FDocGenDocModel> DocModel;
+	TSharedPtr<class FDocGenParsedDocumentCache> DocumentCache;
+	TSharedPtr<class FDocGenConsolidator> Consolidator;
+	TSharedPtr<class FDocGenProcessLimiter> ProcessLimiter;
+	// Persistent docusaurus project the docs are built in, and the record of which files a run staged in it
+	FString StagingPath;
+	TSharedPtr<FDocGenOutputManifest> StagingManifest;
 	FFilePath TemplatePath;
 	FDirectoryPath BinaryPath;
 	FDirectoryPath DocRootPath;
 	FDirectoryPath DocusaurusPath;
 	FFilePath NpmExecutablePath;
+	bool bShardedOutput = false;
+	bool bRenderTemplateInProcess = false;
 
 public:
 	DocGenMdxOutputProcessor(TOptional<FFilePath> TemplatePathOverride, TOptional<FDirectoryPath> BinaryPathOverride,
@@ -39,21 +43,27 @@ public:
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) override;
+	virtual void SetOutputManifest(TSharedPtr<FDocGenOutputManifest> Manifest) override;
+	virtual void SetDocModel(TSharedPtr<FDocGenDocModel> InDocModel) override;
+	virtual void SetDocumentCache(TSharedPtr<FDocGenParsedDocumentCache> InDocumentCache) override;
+	virtual bool UsesConsolidatedOutput() const override
+	{
+		return true;
+	}
+	virtual void SetConsolidator(TSharedPtr<FDocGenConsolidator> InConsolidator) override;
+	virtual void SetProcessLimiter(TSharedPtr<FDocGenProcessLimiter> InProcessLimiter) override;
 
-	EIntermediateProcessingResult ConsolidateClasses(TSharedPtr<FJsonObject> ParsedIndex,
-													 FString const& IntermediateDir, FString const& OutputDir,
-													 TSharedPtr<FJsonObject> ConsolidatedOutput);
-
-	EIntermediateProcessingResult ConsolidateStructs(TSharedPtr<FJsonObject> ParsedIndex,
-													 FString const& IntermediateDir, FString const& OutputDir,
-													 TSharedPtr<FJsonObject> ConsolidatedOutput);
-
-	EIntermediateProcessingResult ConsolidateEnums(TSharedPtr<FJsonObject> ParsedIndex, FString const& IntermediateDir,
-												   FString const& OutputDir,
-												   TSharedPtr<FJsonObject> ConsolidatedOutput);
-
-	TOptional<TArray<FString>> GetNamesFromIndexFile(const FString& NameType, const FString& ChildNameType,
-													 TSharedPtr<FJsonObject> ParsedIndex);
+	/// @brief Renders a page per type instead of a single refdocs.mdx, so docusaurus only rebuilds the pages that
+	/// changed. Needs the template to be renderable in process, a single page is rendered otherwise.
+	void SetShardedOutput(bool bInShardedOutput)
+	{
+		bShardedOutput = bInShardedOutput;
+	}
 
-	TSharedPtr<FJsonObject> LoadFileToJson(FString const& FilePath);
-};
\ No newline at end of file
+	/// @brief Renders the single page template with FDocGenTemplate instead of convert.exe, falling back to
+	/// convert.exe if it doesn't compile
+	void SetRenderTemplateInProcess(bool bInRenderTemplateInProcess)
+	{
+		bRenderTemplateInProcess = bInRenderTemplateInProcess;
+	}
+};
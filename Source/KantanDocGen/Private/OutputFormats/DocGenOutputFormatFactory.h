@@ -31,6 +31,12 @@ class KANTANDOCGEN_API IDocGenOutputFormatFactory
 public:
 	/// @brief returns a string identifier for this output format to make specifying formats on the command line easier
 	virtual FString GetFormatIdentifier() = 0;
+	/// @brief returns an identifier for the bytes written by this format's serializer. Formats sharing an identifier
+	/// produce identical intermediate files, so the generator only serializes each document once for all of them
+	virtual FString GetIntermediateFormatIdentifier()
+	{
+		return GetFormatIdentifier();
+	}
 	/// @brief Constructs an instance of an object implementing the doc tree serialization interface
 	/// @return shared pointer to the instance
 	virtual TSharedPtr<struct DocTreeNode::IDocTreeSerializer> CreateSerializer() = 0;
@@ -1,6 +1,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "Containers/UnrealString.h"
+#include "Templates/SharedPointer.h"
 
 enum EIntermediateProcessingResult : uint8
 {
@@ -13,6 +14,27 @@ enum EIntermediateProcessingResult : uint8
 struct IDocGenOutputProcessor
 {
 	virtual ~IDocGenOutputProcessor() {};
+	/// @brief Supplies the manifest of files written by previous runs, processors that write through a
+	/// FDocGenWriteQueue use it to skip files whose content hasn't changed
+	virtual void SetOutputManifest(TSharedPtr<class FDocGenOutputManifest> Manifest) {}
+	/// @brief Supplies the documents generated in this process, processors reading json intermediates take them from
+	/// memory instead of loading them back from the intermediate directory
+	virtual void SetDocModel(TSharedPtr<class FDocGenDocModel> DocModel) {}
+	/// @brief Supplies the parsed document cache shared by every processor of the run
+	virtual void SetDocumentCache(TSharedPtr<class FDocGenParsedDocumentCache> DocumentCache) {}
+	/// @brief Whether this processor renders from the consolidated json document. A task builds that document once
+	/// and hands it to every such processor through SetConsolidator before calling ProcessIntermediateDocs.
+	virtual bool UsesConsolidatedOutput() const
+	{
+		return false;
+	}
+	/// @brief Supplies a consolidator that already consolidated the intermediate directory about to be processed
+	virtual void SetConsolidator(TSharedPtr<class FDocGenConsolidator> Consolidator) {}
+	/// @brief Supplies the limiter every external tool has to hold a slot of while running, as a task runs the
+	/// processors of all its formats at the same time
+	virtual void SetProcessLimiter(TSharedPtr<class FDocGenProcessLimiter> ProcessLimiter) {}
+	/// @brief Converts the intermediate docs into this format. May run concurrently with other processors of the same
+	/// task, each of which gets its own OutputDir.
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) = 0;
@@ -0,0 +1,66 @@
+#include "OutputFormats/DocGenParsedDocumentCache.h"
+#include "Dom/JsonObject.h"
+#include "Misc/ScopeLock.h"
+
+FDocGenParsedDocumentCache::FDocGenParsedDocumentCache(int64 MaxSourceBytes) : MaxSourceBytes(MaxSourceBytes) {}
+
+TSharedPtr<FJsonObject> FDocGenParsedDocumentCache::Find(const FString& FilePath, uint64 ContentHash)
+{
+	FScopeLock Lock(&EntriesLock);
+	FEntry* Entry = Entries.Find(FilePath);
+	if (!Entry || Entry->ContentHash != ContentHash)
+	{
+		MissCount.Increment();
+		return nullptr;
+	}
+	Entry->LastAccess = ++AccessClock;
+	HitCount.Increment();
+	return Entry->Document;
+}
+
+void FDocGenParsedDocumentCache::Add(const FString& FilePath, uint64 ContentHash, TSharedPtr<FJsonObject> Document,
+									 int64 SourceBytes)
+{
+	if (!Document || SourceBytes > MaxSourceBytes)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&EntriesLock);
+	FEntry& Entry = Entries.FindOrAdd(FilePath);
+	CachedSourceBytes += SourceBytes - Entry.SourceBytes;
+	Entry.ContentHash = ContentHash;
+	Entry.Document = Document;
+	Entry.SourceBytes = SourceBytes;
+	Entry.LastAccess = ++AccessClock;
+
+	if (CachedSourceBytes > MaxSourceBytes)
+	{
+		EvictLeastRecentlyUsed();
+	}
+}
+
+void FDocGenParsedDocumentCache::EvictLeastRecentlyUsed()
+{
+	// Evict down to three quarters of the budget, so the sort is paid for once per batch of evictions rather than on
+	// every insertion while the cache is full
+	const int64 TargetSourceBytes = MaxSourceBytes / 4 * 3;
+
+	TArray<TPair<uint64, FString>> EntriesByAge;
+	EntriesByAge.Reserve(Entries.Num());
+	for (const auto& Entry : Entries)
+	{
+		EntriesByAge.Emplace(Entry.Value.LastAccess, Entry.Key);
+	}
+	EntriesByAge.Sort([](const TPair<uint64, FString>& A, const TPair<uint64, FString>& B) { return A.Key < B.Key; });
+
+	for (const TPair<uint64, FString>& OldestEntry : EntriesByAge)
+	{
+		if (CachedSourceBytes <= TargetSourceBytes)
+		{
+			break;
+		}
+		CachedSourceBytes -= Entries.FindChecked(OldestEntry.Value).SourceBytes;
+		Entries.Remove(OldestEntry.Value);
+	}
+}
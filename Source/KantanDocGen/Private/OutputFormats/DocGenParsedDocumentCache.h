@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Templates/SharedPointer.h"
+
+/// @brief Parsed intermediate documents shared by every output processor of a run, so a file is parsed once however
+/// often and by however many processors it is read. Entries are keyed by path and content hash, so a file that changed
+/// since it was cached is parsed again. The least recently used entries are evicted once the cache outgrows its budget.
+/// Documents handed out are shared between callers and must be treated as read-only. All members are safe to call from
+/// any thread.
+class FDocGenParsedDocumentCache
+{
+public:
+	/// @param MaxSourceBytes budget, measured in bytes of the source documents rather than of the parsed objects
+	explicit FDocGenParsedDocumentCache(int64 MaxSourceBytes = 256 * 1024 * 1024);
+
+	/// @return the cached document for FilePath, or nullptr if it isn't cached or was cached with different content
+	TSharedPtr<class FJsonObject> Find(const FString& FilePath, uint64 ContentHash);
+
+	/// @brief Caches Document as the parsed form of FilePath, evicting older entries if that exceeds the budget
+	/// @param SourceBytes size of the document Document was parsed from
+	void Add(const FString& FilePath, uint64 ContentHash, TSharedPtr<FJsonObject> Document, int64 SourceBytes);
+
+	int32 GetHitCount() const
+	{
+		return HitCount.GetValue();
+	}
+	int32 GetMissCount() const
+	{
+		return MissCount.GetValue();
+	}
+
+private:
+	struct FEntry
+	{
+		uint64 ContentHash = 0;
+		TSharedPtr<FJsonObject> Document;
+		int64 SourceBytes = 0;
+		uint64 LastAccess = 0;
+	};
+
+	// Caller must hold EntriesLock
+	void EvictLeastRecentlyUsed();
+
+	FCriticalSection EntriesLock;
+	TMap<FString, FEntry> Entries;
+	int64 CachedSourceBytes = 0;
+	int64 MaxSourceBytes;
+	uint64 AccessClock = 0;
+	FThreadSafeCounter HitCount;
+	FThreadSafeCounter MissCount;
+};
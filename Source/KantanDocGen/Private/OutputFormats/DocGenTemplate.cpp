@@ -0,0 +1,1860 @@
+#include "OutputFormats/DocGenTemplate.h"
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "DocGenUTF8.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "HAL/FileManager.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/Archive.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ThreadingHelpers.h"
+
+namespace
+{
+	// Output is handed to the archive in chunks of about this size
+	constexpr int32 OutputFlushSize = 64 * 1024;
+	// Iterations of a parallel loop rendered ahead of being written out
+	constexpr int32 ParallelBatchSize = 64;
+	constexpr int32 MaxIncludeDepth = 16;
+
+	TSharedPtr<FJsonValue> MakeBool(bool bValue)
+	{
+		return MakeShared<FJsonValueBoolean>(bValue);
+	}
+
+	TSharedPtr<FJsonValue> MakeNumber(double Value)
+	{
+		return MakeShared<FJsonValueNumber>(Value);
+	}
+
+	TSharedPtr<FJsonValue> MakeString(const FString& Value)
+	{
+		return MakeShared<FJsonValueString>(Value);
+	}
+
+	bool IsWholeNumber(double Value)
+	{
+		return FMath::IsFinite(Value) && Value == FMath::RoundToDouble(Value) && FMath::Abs(Value) < 9007199254740992.0;
+	}
+
+	const TCHAR* GetTypeName(const TSharedPtr<FJsonValue>& Value)
+	{
+		switch (Value->Type)
+		{
+			case EJson::String:
+				return TEXT("string");
+			case EJson::Number:
+				return TEXT("number");
+			case EJson::Boolean:
+				return TEXT("boolean");
+			case EJson::Array:
+				return TEXT("array");
+			case EJson::Object:
+				return TEXT("object");
+			default:
+				return TEXT("null");
+		}
+	}
+
+	/// @brief inja's notion of truth: false, 0, null and empty strings, arrays and objects are false
+	bool IsTruthy(const TSharedPtr<FJsonValue>& Value)
+	{
+		switch (Value->Type)
+		{
+			case EJson::String:
+				return !Value->AsString().IsEmpty();
+			case EJson::Number:
+				return Value->AsNumber() != 0.0;
+			case EJson::Boolean:
+				return Value->AsBool();
+			case EJson::Array:
+				return Value->AsArray().Num() > 0;
+			case EJson::Object:
+				return Value->AsObject()->Values.Num() > 0;
+			default:
+				return false;
+		}
+	}
+
+	bool JsonEquals(const TSharedPtr<FJsonValue>& A, const TSharedPtr<FJsonValue>& B)
+	{
+		const bool bANull = A->Type == EJson::Null || A->Type == EJson::None;
+		const bool bBNull = B->Type == EJson::Null || B->Type == EJson::None;
+		if (bANull || bBNull)
+		{
+			return bANull && bBNull;
+		}
+		if (A->Type != B->Type)
+		{
+			return false;
+		}
+		switch (A->Type)
+		{
+			case EJson::String:
+				return A->AsString().Equals(B->AsString(), ESearchCase::CaseSensitive);
+			case EJson::Number:
+				return A->AsNumber() == B->AsNumber();
+			case EJson::Boolean:
+				return A->AsBool() == B->AsBool();
+			case EJson::Array:
+			{
+				const TArray<TSharedPtr<FJsonValue>>& ElementsA = A->AsArray();
+				const TArray<TSharedPtr<FJsonValue>>& ElementsB = B->AsArray();
+				if (ElementsA.Num() != ElementsB.Num())
+				{
+					return false;
+				}
+				for (int32 Index = 0; Index < ElementsA.Num(); ++Index)
+				{
+					if (!JsonEquals(ElementsA[Index], ElementsB[Index]))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+			case EJson::Object:
+			{
+				const TMap<FString, TSharedPtr<FJsonValue>>& MembersA = A->AsObject()->Values;
+				const TMap<FString, TSharedPtr<FJsonValue>>& MembersB = B->AsObject()->Values;
+				if (MembersA.Num() != MembersB.Num())
+				{
+					return false;
+				}
+				for (const auto& Member : MembersA)
+				{
+					const TSharedPtr<FJsonValue>* OtherMember = MembersB.Find(Member.Key);
+					if (!OtherMember || !JsonEquals(Member.Value, *OtherMember))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+			default:
+				return false;
+		}
+	}
+
+	/// @brief Orders numbers and strings among themselves, anything else by type
+	bool JsonLess(const TSharedPtr<FJsonValue>& A, const TSharedPtr<FJsonValue>& B)
+	{
+		if (A->Type != B->Type)
+		{
+			return A->Type < B->Type;
+		}
+		if (A->Type == EJson::Number)
+		{
+			return A->AsNumber() < B->AsNumber();
+		}
+		if (A->Type == EJson::String)
+		{
+			return A->AsString().Compare(B->AsString(), ESearchCase::CaseSensitive) < 0;
+		}
+		if (A->Type == EJson::Boolean)
+		{
+			return !A->AsBool() && B->AsBool();
+		}
+		return false;
+	}
+
+	FString FormatNumber(double Value)
+	{
+		if (IsWholeNumber(Value))
+		{
+			return FString::Printf(TEXT("%lld"), static_cast<long long>(Value));
+		}
+		return FString::SanitizeFloat(Value);
+	}
+
+	/// @brief How inja prints a value: strings without quotes, anything else as compact json
+	FString ToDisplayString(const TSharedPtr<FJsonValue>& Value)
+	{
+		switch (Value->Type)
+		{
+			case EJson::String:
+				return Value->AsString();
+			case EJson::Number:
+				return FormatNumber(Value->AsNumber());
+			case EJson::Boolean:
+				return Value->AsBool() ? TEXT("true") : TEXT("false");
+			case EJson::Array:
+			{
+				FString Json;
+				auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+				FJsonSerializer::Serialize(Value->AsArray(), Writer);
+				return Json;
+			}
+			case EJson::Object:
+			{
+				FString Json;
+				auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+				FJsonSerializer::Serialize(Value->AsObject().ToSharedRef(), Writer);
+				return Json;
+			}
+			default:
+				return TEXT("null");
+		}
+	}
+
+	/// @return the member or element Segment names, or nullptr if there is none
+	TSharedPtr<FJsonValue> GetMember(const TSharedPtr<FJsonValue>& Value, const FString& Segment)
+	{
+		if (Value->Type == EJson::Object)
+		{
+			return Value->AsObject()->Values.FindRef(Segment);
+		}
+		if (Value->Type == EJson::Array && Segment.IsNumeric())
+		{
+			const TArray<TSharedPtr<FJsonValue>>& Elements = Value->AsArray();
+			const int32 Index = FCString::Atoi(*Segment);
+			return Elements.IsValidIndex(Index) ? Elements[Index] : nullptr;
+		}
+		return nullptr;
+	}
+
+	struct FFunctionSignature
+	{
+		const TCHAR* Name;
+		int32 NumArguments;
+	};
+} // namespace
+
+struct FDocGenTemplate::FRenderContext
+{
+	TSharedPtr<FJsonObject> Data;
+	// Variables the template set, then one scope per enclosing loop iteration
+	TArray<TMap<FString, TSharedPtr<FJsonValue>>> Scopes;
+	TArray<uint8> Output;
+	// Output is flushed to the archive as it grows, contexts without one keep all of it
+	FArchive* Archive = nullptr;
+	int32 LoopDepth = 0;
+	FString Error;
+
+	void Write(const uint8* Bytes, int32 Num)
+	{
+		Output.Append(Bytes, Num);
+		if (Archive && Output.Num() >= OutputFlushSize)
+		{
+			Flush();
+		}
+	}
+
+	void Write(const FString& Text)
+	{
+		DocGenUTF8::Append(Output, Text);
+		if (Archive && Output.Num() >= OutputFlushSize)
+		{
+			Flush();
+		}
+	}
+
+	void Flush()
+	{
+		if (Archive && Output.Num())
+		{
+			Archive->Serialize(Output.GetData(), Output.Num());
+			Output.Reset();
+		}
+	}
+
+	bool Fail(const FString& Message)
+	{
+		Error = Message;
+		return false;
+	}
+};
+
+class FDocGenTemplate::FCompiler
+{
+public:
+	explicit FCompiler(FDocGenTemplate& Template) : Template(Template) {}
+
+	bool CompileFile(const FString& FilePath, int32 IncludeDepth);
+
+	FString Error;
+
+private:
+	struct FToken
+	{
+		enum class EType : uint8
+		{
+			Identifier,
+			Number,
+			String,
+			Operator,
+			End
+		};
+		EType Type = EType::End;
+		FString Text;
+		double Number = 0.0;
+	};
+
+	struct FOpenBlock
+	{
+		bool bIsFor = false;
+		// For: the ForBegin. If: the JumpIfFalse of the current branch, INDEX_NONE once in the else branch.
+		int32 Instruction = INDEX_NONE;
+		// If: jumps from the end of every branch taken to past the endif
+		TArray<int32> PendingJumps;
+	};
+
+	bool CompileSource(const FString& Source, int32 IncludeDepth);
+	bool CompileStatement(const FString& Statement, int32 IncludeDepth);
+	bool CompileExpressionTag(const FString& ExpressionText);
+	void EmitText(const FString& Text);
+	int32 Emit(EInstructionType Type, int32 Expression = INDEX_NONE);
+
+	bool Tokenize(const FString& Source);
+	const FToken& Peek() const
+	{
+		return Tokens[TokenIndex];
+	}
+	bool IsOperator(const TCHAR* Operator) const
+	{
+		return Peek().Type == FToken::EType::Operator && Peek().Text == Operator;
+	}
+	bool IsKeyword(const TCHAR* Keyword) const
+	{
+		return Peek().Type == FToken::EType::Identifier && Peek().Text == Keyword;
+	}
+	bool ExpectEnd();
+
+	int32 ParseOr();
+	int32 ParseAnd();
+	int32 ParseNot();
+	int32 ParseComparison();
+	int32 ParseAdditive();
+	int32 ParseMultiplicative();
+	int32 ParsePower();
+	int32 ParseUnary();
+	int32 ParsePostfix();
+	int32 ParsePrimary();
+	/// @brief Parses a parenthesized argument list, if there is one, onto OutArguments
+	bool ParseArguments(TArray<int32>& OutArguments);
+	int32 AddFunction(const FString& Name, TArray<int32>&& Arguments);
+	int32 AddExpression(EExpressionType Type, TArray<int32>&& Operands = {});
+
+	bool Fail(const FString& Message)
+	{
+		if (Error.IsEmpty())
+		{
+			Error = FString::Printf(TEXT("%s(%d): %s"), *CurrentFile, CurrentLine, *Message);
+		}
+		return false;
+	}
+
+	FDocGenTemplate& Template;
+	TArray<FToken> Tokens;
+	int32 TokenIndex = 0;
+	TArray<FOpenBlock> OpenBlocks;
+	FString CurrentFile;
+	int32 CurrentLine = 1;
+};
+
+bool FDocGenTemplate::FCompiler::CompileFile(const FString& FilePath, int32 IncludeDepth)
+{
+	if (IncludeDepth > MaxIncludeDepth)
+	{
+		return Fail(FString::Printf(TEXT("includes nested deeper than %d levels"), MaxIncludeDepth));
+	}
+	FString Source;
+	if (!FFileHelper::LoadFileToString(Source, *FilePath))
+	{
+		return Fail(FString::Printf(TEXT("failed to read %s"), *FilePath));
+	}
+
+	const FString IncludingFile = CurrentFile;
+	const int32 IncludingLine = CurrentLine;
+	const int32 IncludingOpenBlocks = OpenBlocks.Num();
+	CurrentFile = FilePath;
+	CurrentLine = 1;
+	bool bCompiled = CompileSource(Source, IncludeDepth);
+	if (bCompiled && OpenBlocks.Num() != IncludingOpenBlocks)
+	{
+		bCompiled = Fail(OpenBlocks.Last().bIsFor ? TEXT("missing endfor") : TEXT("missing endif"));
+	}
+	CurrentFile = IncludingFile;
+	CurrentLine = IncludingLine;
+	return bCompiled;
+}
+
+bool FDocGenTemplate::FCompiler::CompileSource(const FString& Source, int32 IncludeDepth)
+{
+	// Text since the previous tag, and whether the previous tag asked for the whitespace following it to be trimmed
+	FString Text;
+	bool bTrimLeading = false;
+	const int32 SourceLen = Source.Len();
+	auto CountLines = [&Source](int32 Start, int32 End) {
+		int32 Lines = 0;
+		for (int32 Index = Start; Index < End; ++Index)
+		{
+			Lines += Source[Index] == TEXT('\n') ? 1 : 0;
+		}
+		return Lines;
+	};
+
+	int32 Cursor = 0;
+	while (Cursor < SourceLen)
+	{
+		const TCHAR Char = Source[Cursor];
+		const TCHAR Next = Cursor + 1 < SourceLen ? Source[Cursor + 1] : TEXT('\0');
+		if (Char != TEXT('{') || (Next != TEXT('{') && Next != TEXT('%') && Next != TEXT('#')))
+		{
+			CurrentLine += Char == TEXT('\n') ? 1 : 0;
+			++Cursor;
+			if (bTrimLeading && FChar::IsWhitespace(Char))
+			{
+				continue;
+			}
+			bTrimLeading = false;
+			Text.AppendChar(Char);
+			continue;
+		}
+
+		const TCHAR* CloseMarker = Next == TEXT('{') ? TEXT("}}") : Next == TEXT('%') ? TEXT("%}") : TEXT("#}");
+		int32 ContentStart = Cursor + 2;
+		if (ContentStart < SourceLen && Source[ContentStart] == TEXT('-'))
+		{
+			++ContentStart;
+			Text.TrimEndInline();
+		}
+		const int32 CloseIndex = Source.Find(CloseMarker, ESearchCase::CaseSensitive, ESearchDir::FromStart,
+											 ContentStart);
+		if (CloseIndex == INDEX_NONE)
+		{
+			return Fail(FString::Printf(TEXT("unterminated tag, expected %s"), CloseMarker));
+		}
+		int32 ContentEnd = CloseIndex;
+		bTrimLeading = ContentEnd > ContentStart && Source[ContentEnd - 1] == TEXT('-');
+		if (bTrimLeading)
+		{
+			--ContentEnd;
+		}
+		const FString Content = Source.Mid(ContentStart, ContentEnd - ContentStart);
+		const int32 TagLine = CurrentLine;
+		CurrentLine += CountLines(Cursor, CloseIndex);
+		Cursor = CloseIndex + 2;
+		if (Next == TEXT('#'))
+		{
+			continue;
+		}
+
+		EmitText(Text);
+		Text.Reset();
+		const int32 NextLine = CurrentLine;
+		CurrentLine = TagLine;
+		if (Next == TEXT('{'))
+		{
+			if (!CompileExpressionTag(Content))
+			{
+				return false;
+			}
+		}
+		else if (Content.TrimStartAndEnd() == TEXT("raw"))
+		{
+			// Everything up to the matching endraw is text, tags included
+			int32 SearchFrom = Cursor;
+			while (true)
+			{
+				const int32 TagStart = Source.Find(TEXT("{%"), ESearchCase::CaseSensitive, ESearchDir::FromStart,
+												   SearchFrom);
+				const int32 TagEnd = TagStart == INDEX_NONE ? INDEX_NONE
+															: Source.Find(TEXT("%}"), ESearchCase::CaseSensitive,
+																		  ESearchDir::FromStart, TagStart + 2);
+				if (TagEnd == INDEX_NONE)
+				{
+					return Fail(TEXT("missing endraw"));
+				}
+				FString Inner = Source.Mid(TagStart + 2, TagEnd - TagStart - 2);
+				const bool bTrimBefore = Inner.StartsWith(TEXT("-"));
+				const bool bTrimAfter = Inner.EndsWith(TEXT("-"));
+				Inner = Inner.Mid(bTrimBefore ? 1 : 0, Inner.Len() - (bTrimBefore ? 1 : 0) - (bTrimAfter ? 1 : 0));
+				if (Inner.TrimStartAndEnd() != TEXT("endraw"))
+				{
+					SearchFrom = TagStart + 2;
+					continue;
+				}
+				FString RawText = Source.Mid(Cursor, TagStart - Cursor);
+				if (bTrimLeading)
+				{
+					RawText.TrimStartInline();
+				}
+				if (bTrimBefore)
+				{
+					RawText.TrimEndInline();
+				}
+				Text = MoveTemp(RawText);
+				bTrimLeading = bTrimAfter;
+				CurrentLine = NextLine + CountLines(Cursor, TagEnd);
+				Cursor = TagEnd + 2;
+				break;
+			}
+			continue;
+		}
+		else if (!CompileStatement(Content, IncludeDepth))
+		{
+			return false;
+		}
+		CurrentLine = NextLine;
+	}
+	EmitText(Text);
+	return true;
+}
+
+bool FDocGenTemplate::FCompiler::CompileExpressionTag(const FString& ExpressionText)
+{
+	if (!Tokenize(ExpressionText))
+	{
+		return false;
+	}
+	const int32 Expression = ParseOr();
+	if (Expression == INDEX_NONE || !ExpectEnd())
+	{
+		return false;
+	}
+	Emit(EInstructionType::Print, Expression);
+	return true;
+}
+
+bool FDocGenTemplate::FCompiler::CompileStatement(const FString& Statement, int32 IncludeDepth)
+{
+	if (!Tokenize(Statement))
+	{
+		return false;
+	}
+	if (Peek().Type != FToken::EType::Identifier)
+	{
+		return Fail(TEXT("expected a statement"));
+	}
+	const FString Keyword = Peek().Text;
+	++TokenIndex;
+
+	if (Keyword == TEXT("if"))
+	{
+		const int32 Condition = ParseOr();
+		if (Condition == INDEX_NONE || !ExpectEnd())
+		{
+			return false;
+		}
+		FOpenBlock& Block = OpenBlocks.AddDefaulted_GetRef();
+		Block.Instruction = Emit(EInstructionType::JumpIfFalse, Condition);
+		return true;
+	}
+	if (Keyword == TEXT("else"))
+	{
+		if (!OpenBlocks.Num() || OpenBlocks.Last().bIsFor || OpenBlocks.Last().Instruction == INDEX_NONE)
+		{
+			return Fail(TEXT("else without a matching if"));
+		}
+		int32 Condition = INDEX_NONE;
+		if (IsKeyword(TEXT("if")))
+		{
+			++TokenIndex;
+			Condition = ParseOr();
+			if (Condition == INDEX_NONE)
+			{
+				return false;
+			}
+		}
+		if (!ExpectEnd())
+		{
+			return false;
+		}
+		FOpenBlock& Block = OpenBlocks.Last();
+		Block.PendingJumps.Add(Emit(EInstructionType::Jump));
+		Template.Instructions[Block.Instruction].Target = Template.Instructions.Num();
+		Block.Instruction = Condition != INDEX_NONE ? Emit(EInstructionType::JumpIfFalse, Condition) : INDEX_NONE;
+		return true;
+	}
+	if (Keyword == TEXT("endif"))
+	{
+		if (!ExpectEnd())
+		{
+			return false;
+		}
+		if (!OpenBlocks.Num() || OpenBlocks.Last().bIsFor)
+		{
+			return Fail(TEXT("endif without a matching if"));
+		}
+		const FOpenBlock Block = OpenBlocks.Pop();
+		const int32 End = Template.Instructions.Num();
+		if (Block.Instruction != INDEX_NONE)
+		{
+			Template.Instructions[Block.Instruction].Target = End;
+		}
+		for (int32 Jump : Block.PendingJumps)
+		{
+			Template.Instructions[Jump].Target = End;
+		}
+		return true;
+	}
+	if (Keyword == TEXT("for"))
+	{
+		// for value in array, or for key, value in object
+		TArray<FString> Names;
+		while (true)
+		{
+			if (Peek().Type != FToken::EType::Identifier || Peek().Text.Contains(TEXT(".")))
+			{
+				return Fail(TEXT("expected a loop variable name"));
+			}
+			Names.Add(Peek().Text);
+			++TokenIndex;
+			if (Names.Num() == 2 || !IsOperator(TEXT(",")))
+			{
+				break;
+			}
+			++TokenIndex;
+		}
+		if (!IsKeyword(TEXT("in")))
+		{
+			return Fail(TEXT("expected 'in'"));
+		}
+		++TokenIndex;
+		const int32 Iterable = ParseOr();
+		if (Iterable == INDEX_NONE || !ExpectEnd())
+		{
+			return false;
+		}
+		const int32 ForBegin = Emit(EInstructionType::ForBegin, Iterable);
+		FInstruction& Instruction = Template.Instructions[ForBegin];
+		Instruction.ValueName = Names.Last();
+		Instruction.KeyName = Names.Num() > 1 ? Names[0] : FString();
+		FOpenBlock& Block = OpenBlocks.AddDefaulted_GetRef();
+		Block.bIsFor = true;
+		Block.Instruction = ForBegin;
+		return true;
+	}
+	if (Keyword == TEXT("endfor"))
+	{
+		if (!ExpectEnd())
+		{
+			return false;
+		}
+		if (!OpenBlocks.Num() || !OpenBlocks.Last().bIsFor)
+		{
+			return Fail(TEXT("endfor without a matching for"));
+		}
+		const int32 ForBegin = OpenBlocks.Pop().Instruction;
+		const int32 ForEnd = Emit(EInstructionType::ForEnd);
+		Template.Instructions[ForEnd].Target = ForBegin;
+		FInstruction& BeginInstruction = Template.Instructions[ForBegin];
+		BeginInstruction.Target = ForEnd;
+		// Set is the only way an iteration can affect the ones after it
+		BeginInstruction.bIndependentIterations = true;
+		for (int32 Index = ForBegin + 1; Index < ForEnd; ++Index)
+		{
+			if (Template.Instructions[Index].Type == EInstructionType::Set)
+			{
+				BeginInstruction.bIndependentIterations = false;
+				break;
+			}
+		}
+		return true;
+	}
+	if (Keyword == TEXT("set"))
+	{
+		if (Peek().Type != FToken::EType::Identifier || Peek().Text.Contains(TEXT(".")))
+		{
+			return Fail(TEXT("expected a variable name, assigning to members isn't supported"));
+		}
+		const FString Name = Peek().Text;
+		++TokenIndex;
+		if (!IsOperator(TEXT("=")))
+		{
+			return Fail(TEXT("expected '='"));
+		}
+		++TokenIndex;
+		const int32 Value = ParseOr();
+		if (Value == INDEX_NONE || !ExpectEnd())
+		{
+			return false;
+		}
+		Template.Instructions[Emit(EInstructionType::Set, Value)].ValueName = Name;
+		return true;
+	}
+	if (Keyword == TEXT("include"))
+	{
+		if (Peek().Type != FToken::EType::String)
+		{
+			return Fail(TEXT("include expects a file name"));
+		}
+		const FString IncludeName = Peek().Text;
+		++TokenIndex;
+		if (!ExpectEnd())
+		{
+			return false;
+		}
+		// Looked up next to the including template first, like inja does
+		FString IncludePath = FPaths::GetPath(CurrentFile) / IncludeName;
+		if (!FPaths::FileExists(IncludePath) && FPaths::FileExists(IncludeName))
+		{
+			IncludePath = IncludeName;
+		}
+		return CompileFile(IncludePath, IncludeDepth + 1);
+	}
+	return Fail(FString::Printf(TEXT("unsupported statement '%s'"), *Keyword));
+}
+
+void FDocGenTemplate::FCompiler::EmitText(const FString& Text)
+{
+	if (Text.IsEmpty())
+	{
+		return;
+	}
+	// Not merged with a preceding text instruction, a jump may target this one
+	FInstruction& Instruction = Template.Instructions[Emit(EInstructionType::Text)];
+	DocGenUTF8::Append(Instruction.Text, Text);
+}
+
+int32 FDocGenTemplate::FCompiler::Emit(EInstructionType Type, int32 Expression)
+{
+	FInstruction& Instruction = Template.Instructions.AddDefaulted_GetRef();
+	Instruction.Type = Type;
+	Instruction.Expression = Expression;
+	return Template.Instructions.Num() - 1;
+}
+
+bool FDocGenTemplate::FCompiler::Tokenize(const FString& Source)
+{
+	Tokens.Reset();
+	TokenIndex = 0;
+	const int32 SourceLen = Source.Len();
+	int32 Cursor = 0;
+	while (Cursor < SourceLen)
+	{
+		const TCHAR Char = Source[Cursor];
+		if (FChar::IsWhitespace(Char))
+		{
+			++Cursor;
+			continue;
+		}
+		FToken& Token = Tokens.AddDefaulted_GetRef();
+		const int32 Start = Cursor;
+		if (FChar::IsDigit(Char))
+		{
+			while (Cursor < SourceLen && (FChar::IsDigit(Source[Cursor]) || Source[Cursor] == TEXT('.')))
+			{
+				++Cursor;
+			}
+			if (Cursor < SourceLen && (Source[Cursor] == TEXT('e') || Source[Cursor] == TEXT('E')))
+			{
+				++Cursor;
+				if (Cursor < SourceLen && (Source[Cursor] == TEXT('+') || Source[Cursor] == TEXT('-')))
+				{
+					++Cursor;
+				}
+				while (Cursor < SourceLen && FChar::IsDigit(Source[Cursor]))
+				{
+					++Cursor;
+				}
+			}
+			Token.Type = FToken::EType::Number;
+			Token.Text = Source.Mid(Start, Cursor - Start);
+			Token.Number = FCString::Atod(*Token.Text);
+		}
+		else if (FChar::IsAlpha(Char) || Char == TEXT('_'))
+		{
+			while (Cursor < SourceLen &&
+				   (FChar::IsAlnum(Source[Cursor]) || Source[Cursor] == TEXT('_') || Source[Cursor] == TEXT('.')))
+			{
+				++Cursor;
+			}
+			Token.Type = FToken::EType::Identifier;
+			Token.Text = Source.Mid(Start, Cursor - Start);
+		}
+		else if (Char == TEXT('"') || Char == TEXT('\''))
+		{
+			Token.Type = FToken::EType::String;
+			for (++Cursor; Cursor < SourceLen && Source[Cursor] != Char; ++Cursor)
+			{
+				TCHAR Literal = Source[Cursor];
+				if (Literal == TEXT('\\') && Cursor + 1 < SourceLen)
+				{
+					Literal = Source[++Cursor];
+					Literal = Literal == TEXT('n') ? TEXT('\n') : Literal == TEXT('t') ? TEXT('\t') : Literal;
+				}
+				Token.Text.AppendChar(Literal);
+			}
+			if (Cursor == SourceLen)
+			{
+				return Fail(TEXT("unterminated string"));
+			}
+			++Cursor;
+		}
+		else
+		{
+			static const TCHAR* const TwoCharOperators[] = {TEXT("=="), TEXT("!="), TEXT("<="), TEXT(">=")};
+			Token.Type = FToken::EType::Operator;
+			for (const TCHAR* Operator : TwoCharOperators)
+			{
+				if (Cursor + 1 < SourceLen && Source[Cursor] == Operator[0] && Source[Cursor + 1] == Operator[1])
+				{
+					Token.Text = Operator;
+					Cursor += 2;
+					break;
+				}
+			}
+			if (Token.Text.IsEmpty())
+			{
+				if (!FCString::Strchr(TEXT("<>+-*/%^~()[],|="), Char))
+				{
+					return Fail(FString::Printf(TEXT("unexpected character '%c'"), Char));
+				}
+				Token.Text.AppendChar(Char);
+				++Cursor;
+			}
+		}
+	}
+	Tokens.AddDefaulted();
+	return true;
+}
+
+bool FDocGenTemplate::FCompiler::ExpectEnd()
+{
+	if (Peek().Type != FToken::EType::End)
+	{
+		return Fail(FString::Printf(TEXT("unexpected '%s'"), *Peek().Text));
+	}
+	return true;
+}
+
+int32 FDocGenTemplate::FCompiler::ParseOr()
+{
+	int32 Left = ParseAnd();
+	while (Left != INDEX_NONE && IsKeyword(TEXT("or")))
+	{
+		++TokenIndex;
+		const int32 Right = ParseAnd();
+		Left = Right == INDEX_NONE ? INDEX_NONE : AddExpression(EExpressionType::Or, {Left, Right});
+	}
+	return Left;
+}
+
+int32 FDocGenTemplate::FCompiler::ParseAnd()
+{
+	int32 Left = ParseNot();
+	while (Left != INDEX_NONE && IsKeyword(TEXT("and")))
+	{
+		++TokenIndex;
+		const int32 Right = ParseNot();
+		Left = Right == INDEX_NONE ? INDEX_NONE : AddExpression(EExpressionType::And, {Left, Right});
+	}
+	return Left;
+}
+
+int32 FDocGenTemplate::FCompiler::ParseNot()
+{
+	if (!IsKeyword(TEXT("not")))
+	{
+		return ParseComparison();
+	}
+	++TokenIndex;
+	const int32 Operand = ParseNot();
+	return Operand == INDEX_NONE ? INDEX_NONE : AddExpression(EExpressionType::Not, {Operand});
+}
+
+int32 FDocGenTemplate::FCompiler::ParseComparison()
+{
+	const int32 Left = ParseAdditive();
+	if (Left == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+	struct FComparison
+	{
+		const TCHAR* Operator;
+		EExpressionType Type;
+	};
+	static const FComparison Comparisons[] = {
+		{TEXT("=="), EExpressionType::Equal},  {TEXT("!="), EExpressionType::NotEqual},
+		{TEXT("<"), EExpressionType::Less},	   {TEXT("<="), EExpressionType::LessEqual},
+		{TEXT(">"), EExpressionType::Greater}, {TEXT(">="), EExpressionType::GreaterEqual},
+	};
+	TOptional<EExpressionType> Type;
+	if (IsKeyword(TEXT("in")))
+	{
+		Type = EExpressionType::In;
+	}
+	for (const FComparison& Comparison : Comparisons)
+	{
+		if (IsOperator(Comparison.Operator))
+		{
+			Type = Comparison.Type;
+		}
+	}
+	if (!Type.IsSet())
+	{
+		return Left;
+	}
+	++TokenIndex;
+	const int32 Right = ParseAdditive();
+	return Right == INDEX_NONE ? INDEX_NONE : AddExpression(Type.GetValue(), {Left, Right});
+}
+
+int32 FDocGenTemplate::FCompiler::ParseAdditive()
+{
+	int32 Left = ParseMultiplicative();
+	while (Left != INDEX_NONE && (IsOperator(TEXT("+")) || IsOperator(TEXT("-")) || IsOperator(TEXT("~"))))
+	{
+		const EExpressionType Type = IsOperator(TEXT("+"))	 ? EExpressionType::Add
+									 : IsOperator(TEXT("-")) ? EExpressionType::Subtract
+															 : EExpressionType::Concat;
+		++TokenIndex;
+		const int32 Right = ParseMultiplicative();
+		Left = Right == INDEX_NONE ? INDEX_NONE : AddExpression(Type, {Left, Right});
+	}
+	return Left;
+}
+
+int32 FDocGenTemplate::FCompiler::ParseMultiplicative()
+{
+	int32 Left = ParsePower();
+	while (Left != INDEX_NONE && (IsOperator(TEXT("*")) || IsOperator(TEXT("/")) || IsOperator(TEXT("%"))))
+	{
+		const EExpressionType Type = IsOperator(TEXT("*"))	 ? EExpressionType::Multiply
+									 : IsOperator(TEXT("/")) ? EExpressionType::Divide
+															 : EExpressionType::Modulo;
+		++TokenIndex;
+		const int32 Right = ParsePower();
+		Left = Right == INDEX_NONE ? INDEX_NONE : AddExpression(Type, {Left, Right});
+	}
+	return Left;
+}
+
+int32 FDocGenTemplate::FCompiler::ParsePower()
+{
+	int32 Left = ParseUnary();
+	while (Left != INDEX_NONE && IsOperator(TEXT("^")))
+	{
+		++TokenIndex;
+		const int32 Right = ParseUnary();
+		Left = Right == INDEX_NONE ? INDEX_NONE : AddExpression(EExpressionType::Power, {Left, Right});
+	}
+	return Left;
+}
+
+int32 FDocGenTemplate::FCompiler::ParseUnary()
+{
+	if (!IsOperator(TEXT("-")))
+	{
+		return ParsePostfix();
+	}
+	++TokenIndex;
+	const int32 Operand = ParseUnary();
+	return Operand == INDEX_NONE ? INDEX_NONE : AddExpression(EExpressionType::Negate, {Operand});
+}
+
+int32 FDocGenTemplate::FCompiler::ParsePostfix()
+{
+	int32 Operand = ParsePrimary();
+	// value | function(arguments) calls function with value as its first argument
+	while (Operand != INDEX_NONE && IsOperator(TEXT("|")))
+	{
+		++TokenIndex;
+		if (Peek().Type != FToken::EType::Identifier)
+		{
+			Fail(TEXT("expected a function name after '|'"));
+			return INDEX_NONE;
+		}
+		const FString Name = Peek().Text;
+		++TokenIndex;
+		TArray<int32> Arguments = {Operand};
+		if (IsOperator(TEXT("(")) && !ParseArguments(Arguments))
+		{
+			return INDEX_NONE;
+		}
+		Operand = AddFunction(Name, MoveTemp(Arguments));
+	}
+	return Operand;
+}
+
+int32 FDocGenTemplate::FCompiler::ParsePrimary()
+{
+	const FToken Token = Peek();
+	++TokenIndex;
+	switch (Token.Type)
+	{
+		case FToken::EType::Number:
+		{
+			const int32 Literal = AddExpression(EExpressionType::Literal);
+			Template.Expressions[Literal].Literal = MakeNumber(Token.Number);
+			return Literal;
+		}
+		case FToken::EType::String:
+		{
+			const int32 Literal = AddExpression(EExpressionType::Literal);
+			Template.Expressions[Literal].Literal = MakeString(Token.Text);
+			return Literal;
+		}
+		case FToken::EType::Operator:
+			if (Token.Text == TEXT("("))
+			{
+				const int32 Inner = ParseOr();
+				if (Inner == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+				if (!IsOperator(TEXT(")")))
+				{
+					Fail(TEXT("expected ')'"));
+					return INDEX_NONE;
+				}
+				++TokenIndex;
+				return Inner;
+			}
+			if (Token.Text == TEXT("["))
+			{
+				TArray<int32> Elements;
+				while (!IsOperator(TEXT("]")))
+				{
+					if (Elements.Num())
+					{
+						if (!IsOperator(TEXT(",")))
+						{
+							Fail(TEXT("expected ',' or ']'"));
+							return INDEX_NONE;
+						}
+						++TokenIndex;
+					}
+					const int32 Element = ParseOr();
+					if (Element == INDEX_NONE)
+					{
+						return INDEX_NONE;
+					}
+					Elements.Add(Element);
+				}
+				++TokenIndex;
+				return AddExpression(EExpressionType::MakeArray, MoveTemp(Elements));
+			}
+			break;
+		case FToken::EType::Identifier:
+		{
+			if (Token.Text == TEXT("true") || Token.Text == TEXT("false") || Token.Text == TEXT("null"))
+			{
+				const int32 Literal = AddExpression(EExpressionType::Literal);
+				if (Token.Text == TEXT("null"))
+				{
+					Template.Expressions[Literal].Literal = MakeShared<FJsonValueNull>();
+				}
+				else
+				{
+					Template.Expressions[Literal].Literal = MakeBool(Token.Text == TEXT("true"));
+				}
+				return Literal;
+			}
+			if (IsOperator(TEXT("(")))
+			{
+				TArray<int32> Arguments;
+				if (!ParseArguments(Arguments))
+				{
+					return INDEX_NONE;
+				}
+				return AddFunction(Token.Text, MoveTemp(Arguments));
+			}
+			TArray<FString> Path;
+			Token.Text.ParseIntoArray(Path, TEXT("."), false);
+			if (Path.Contains(FString()))
+			{
+				Fail(FString::Printf(TEXT("invalid variable name '%s'"), *Token.Text));
+				return INDEX_NONE;
+			}
+			const int32 Variable = AddExpression(EExpressionType::Variable);
+			Template.Expressions[Variable].Path = MoveTemp(Path);
+			return Variable;
+		}
+		default:
+			break;
+	}
+	Fail(Token.Type == FToken::EType::End ? FString(TEXT("unexpected end of expression"))
+										  : FString::Printf(TEXT("unexpected '%s'"), *Token.Text));
+	return INDEX_NONE;
+}
+
+bool FDocGenTemplate::FCompiler::ParseArguments(TArray<int32>& OutArguments)
+{
+	check(IsOperator(TEXT("(")));
+	++TokenIndex;
+	bool bFirst = true;
+	while (!IsOperator(TEXT(")")))
+	{
+		if (!bFirst)
+		{
+			if (!IsOperator(TEXT(",")))
+			{
+				return Fail(TEXT("expected ',' or ')'"));
+			}
+			++TokenIndex;
+		}
+		bFirst = false;
+		const int32 Argument = ParseOr();
+		if (Argument == INDEX_NONE)
+		{
+			return false;
+		}
+		OutArguments.Add(Argument);
+	}
+	++TokenIndex;
+	return true;
+}
+
+int32 FDocGenTemplate::FCompiler::AddFunction(const FString& Name, TArray<int32>&& Arguments)
+{
+	// Indexed by EFunction
+	static const FFunctionSignature Signatures[] = {
+		{TEXT("at"), 2},		  {TEXT("capitalize"), 1}, {TEXT("default"), 2},  {TEXT("divisibleBy"), 2},
+		{TEXT("even"), 1},		  {TEXT("exists"), 1},	   {TEXT("existsIn"), 2}, {TEXT("first"), 1},
+		{TEXT("float"), 1},		  {TEXT("int"), 1},		   {TEXT("isArray"), 1},  {TEXT("isBoolean"), 1},
+		{TEXT("isFloat"), 1},	  {TEXT("isInteger"), 1},  {TEXT("isNumber"), 1}, {TEXT("isObject"), 1},
+		{TEXT("isString"), 1},	  {TEXT("join"), 2},	   {TEXT("last"), 1},	  {TEXT("length"), 1},
+		{TEXT("lower"), 1},		  {TEXT("max"), 1},		   {TEXT("min"), 1},	  {TEXT("odd"), 1},
+		{TEXT("range"), 1},		  {TEXT("replace"), 3},	   {TEXT("round"), 2},	  {TEXT("sort"), 1},
+		{TEXT("upper"), 1},
+	};
+	constexpr int32 NumSignatures = UE_ARRAY_COUNT(Signatures);
+	static_assert(NumSignatures == static_cast<int32>(EFunction::Upper) + 1, "Signatures must list every EFunction");
+	for (int32 Index = 0; Index < NumSignatures; ++Index)
+	{
+		if (Name != Signatures[Index].Name)
+		{
+			continue;
+		}
+		if (Arguments.Num() != Signatures[Index].NumArguments)
+		{
+			Fail(FString::Printf(TEXT("%s expects %d arguments"), *Name, Signatures[Index].NumArguments));
+			return INDEX_NONE;
+		}
+		const int32 Function = AddExpression(EExpressionType::Function, MoveTemp(Arguments));
+		Template.Expressions[Function].Function = static_cast<EFunction>(Index);
+		return Function;
+	}
+	Fail(FString::Printf(TEXT("unsupported function '%s'"), *Name));
+	return INDEX_NONE;
+}
+
+int32 FDocGenTemplate::FCompiler::AddExpression(EExpressionType Type, TArray<int32>&& Operands)
+{
+	FExpression& Expression = Template.Expressions.AddDefaulted_GetRef();
+	Expression.Type = Type;
+	Expression.Operands = MoveTemp(Operands);
+	return Template.Expressions.Num() - 1;
+}
+
+TSharedPtr<FDocGenTemplate> FDocGenTemplate::Compile(const FString& TemplatePath, FString& OutError)
+{
+	TSharedPtr<FDocGenTemplate> Template = MakeShared<FDocGenTemplate>();
+	FCompiler Compiler(*Template);
+	if (!Compiler.CompileFile(TemplatePath, 0))
+	{
+		OutError = Compiler.Error;
+		return nullptr;
+	}
+	return Template;
+}
+
+bool FDocGenTemplate::Render(const TSharedPtr<FJsonObject>& Data, FArchive& Output, FString& OutError) const
+{
+	FRenderContext Context;
+	Context.Data = Data;
+	Context.Scopes.AddDefaulted();
+	Context.Archive = &Output;
+	if (!Execute(0, Instructions.Num(), Context))
+	{
+		OutError = Context.Error;
+		return false;
+	}
+	Context.Flush();
+	if (Output.IsError())
+	{
+		OutError = TEXT("failed to write the output");
+		return false;
+	}
+	return true;
+}
+
+bool FDocGenTemplate::RenderFile(const FString& TemplatePath, const TSharedPtr<FJsonObject>& Data,
+								 const FString& OutputPath)
+{
+	FString Error;
+	TSharedPtr<FDocGenTemplate> Template = Compile(TemplatePath, Error);
+	if (!Template)
+	{
+		UE_LOG(LogKantanDocGen, Log, TEXT("Template %s can't be rendered in process: %s"), *TemplatePath, *Error);
+		return false;
+	}
+	TUniquePtr<FArchive> OutputFile(IFileManager::Get().CreateFileWriter(*OutputPath));
+	if (!OutputFile)
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to create %s"), *OutputPath);
+		return false;
+	}
+	const bool bRendered = Template->Render(Data, *OutputFile, Error);
+	const bool bClosed = OutputFile->Close();
+	OutputFile.Reset();
+	if (!bRendered || !bClosed)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Failed to render %s to %s: %s"), *TemplatePath, *OutputPath,
+			   bRendered ? TEXT("failed to write the output") : *Error);
+		IFileManager::Get().Delete(*OutputPath, false, true, true);
+		return false;
+	}
+	return true;
+}
+
+bool FDocGenTemplate::Execute(int32 Begin, int32 End, FRenderContext& Context) const
+{
+	for (int32 Index = Begin; Index < End;)
+	{
+		const FInstruction& Instruction = Instructions[Index];
+		switch (Instruction.Type)
+		{
+			case EInstructionType::Text:
+				Context.Write(Instruction.Text.GetData(), Instruction.Text.Num());
+				++Index;
+				break;
+			case EInstructionType::Print:
+			{
+				TSharedPtr<FJsonValue> Value;
+				if (!Evaluate(Instruction.Expression, Context, Value))
+				{
+					return false;
+				}
+				Context.Write(ToDisplayString(Value));
+				++Index;
+				break;
+			}
+			case EInstructionType::JumpIfFalse:
+			{
+				TSharedPtr<FJsonValue> Condition;
+				if (!Evaluate(Instruction.Expression, Context, Condition))
+				{
+					return false;
+				}
+				Index = IsTruthy(Condition) ? Index + 1 : Instruction.Target;
+				break;
+			}
+			case EInstructionType::Jump:
+				Index = Instruction.Target;
+				break;
+			case EInstructionType::ForBegin:
+				if (!ExecuteFor(Index, Context))
+				{
+					return false;
+				}
+				Index = Instruction.Target + 1;
+				break;
+			case EInstructionType::ForEnd:
+				++Index;
+				break;
+			case EInstructionType::Set:
+			{
+				TSharedPtr<FJsonValue> Value;
+				if (!Evaluate(Instruction.Expression, Context, Value))
+				{
+					return false;
+				}
+				Context.Scopes[0].Add(Instruction.ValueName, Value);
+				++Index;
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+bool FDocGenTemplate::ExecuteFor(int32 ForBegin, FRenderContext& Context) const
+{
+	const FInstruction& Instruction = Instructions[ForBegin];
+	TSharedPtr<FJsonValue> Iterable;
+	if (!Evaluate(Instruction.Expression, Context, Iterable))
+	{
+		return false;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Items;
+	TArray<FString> Keys;
+	if (Iterable->Type == EJson::Array && Instruction.KeyName.IsEmpty())
+	{
+		Items = Iterable->AsArray();
+	}
+	else if (Iterable->Type == EJson::Object && !Instruction.KeyName.IsEmpty())
+	{
+		const TMap<FString, TSharedPtr<FJsonValue>>& Members = Iterable->AsObject()->Values;
+		Members.GetKeys(Keys);
+		// inja iterates objects in key order
+		Keys.Sort([](const FString& A, const FString& B) { return A.Compare(B, ESearchCase::CaseSensitive) < 0; });
+		for (const FString& Key : Keys)
+		{
+			Items.Add(Members.FindChecked(Key));
+		}
+	}
+	else
+	{
+		return Context.Fail(FString::Printf(TEXT("can't iterate over %s with %s"), GetTypeName(Iterable),
+											Instruction.KeyName.IsEmpty() ? TEXT("one loop variable")
+																		  : TEXT("two loop variables")));
+	}
+
+	TSharedPtr<FJsonValue> ParentLoop;
+	for (int32 ScopeIndex = Context.Scopes.Num() - 1; ScopeIndex > 0 && !ParentLoop; --ScopeIndex)
+	{
+		ParentLoop = Context.Scopes[ScopeIndex].FindRef(TEXT("loop"));
+	}
+
+	auto RenderIteration = [this, &Instruction, &Items, &Keys, &ParentLoop,
+							ForBegin](int32 ItemIndex, FRenderContext& IterationContext) {
+		TSharedPtr<FJsonObject> Loop = MakeShared<FJsonObject>();
+		Loop->SetNumberField(TEXT("index"), ItemIndex);
+		Loop->SetNumberField(TEXT("index1"), ItemIndex + 1);
+		Loop->SetBoolField(TEXT("is_first"), ItemIndex == 0);
+		Loop->SetBoolField(TEXT("is_last"), ItemIndex == Items.Num() - 1);
+		if (ParentLoop)
+		{
+			Loop->SetField(TEXT("parent"), ParentLoop);
+		}
+		TMap<FString, TSharedPtr<FJsonValue>>& Scope = IterationContext.Scopes.AddDefaulted_GetRef();
+		Scope.Add(Instruction.ValueName, Items[ItemIndex]);
+		if (!Instruction.KeyName.IsEmpty())
+		{
+			Scope.Add(Instruction.KeyName, MakeString(Keys[ItemIndex]));
+		}
+		Scope.Add(TEXT("loop"), MakeShared<FJsonValueObject>(Loop));
+
+		++IterationContext.LoopDepth;
+		const bool bRendered = Execute(ForBegin + 1, Instruction.Target, IterationContext);
+		--IterationContext.LoopDepth;
+		IterationContext.Scopes.Pop();
+		return bRendered;
+	};
+
+	// Only loops outside of other loops are split up, that's where the classes are iterated and nesting further
+	// would only add overhead. Iterations share the data's json values, which needs them to be thread safe.
+	if (!DocGenThreads::bThreadSafeJson || !Instruction.bIndependentIterations || Context.LoopDepth > 0 ||
+		Items.Num() < 2)
+	{
+		for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+		{
+			if (!RenderIteration(ItemIndex, Context))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Every iteration renders into a context of its own, their output is written out in order once the batch is done
+	TArray<FRenderContext> IterationContexts;
+	TArray<bool> Rendered;
+	for (int32 BatchStart = 0; BatchStart < Items.Num(); BatchStart += ParallelBatchSize)
+	{
+		const int32 BatchSize = FMath::Min(ParallelBatchSize, Items.Num() - BatchStart);
+		IterationContexts.Reset();
+		IterationContexts.SetNum(BatchSize);
+		Rendered.Reset();
+		Rendered.SetNumZeroed(BatchSize);
+		ParallelFor(BatchSize, [&Context, &IterationContexts, &Rendered, &RenderIteration, BatchStart](int32 Slot) {
+			FRenderContext& IterationContext = IterationContexts[Slot];
+			IterationContext.Data = Context.Data;
+			IterationContext.Scopes = Context.Scopes;
+			Rendered[Slot] = RenderIteration(BatchStart + Slot, IterationContext);
+		});
+		for (int32 Slot = 0; Slot < BatchSize; ++Slot)
+		{
+			if (!Rendered[Slot])
+			{
+				return Context.Fail(IterationContexts[Slot].Error);
+			}
+			Context.Write(IterationContexts[Slot].Output.GetData(), IterationContexts[Slot].Output.Num());
+		}
+	}
+	return true;
+}
+
+bool FDocGenTemplate::LookUp(const TArray<FString>& Path, FRenderContext& Context,
+							 TSharedPtr<FJsonValue>& OutValue) const
+{
+	TSharedPtr<FJsonValue> Value;
+	for (int32 ScopeIndex = Context.Scopes.Num() - 1; ScopeIndex >= 0 && !Value; --ScopeIndex)
+	{
+		Value = Context.Scopes[ScopeIndex].FindRef(Path[0]);
+	}
+	if (!Value && Context.Data)
+	{
+		Value = Context.Data->Values.FindRef(Path[0]);
+	}
+	for (int32 Segment = 1; Value && Segment < Path.Num(); ++Segment)
+	{
+		Value = GetMember(Value, Path[Segment]);
+	}
+	if (!Value)
+	{
+		return Context.Fail(FString::Printf(TEXT("variable '%s' not found"), *FString::Join(Path, TEXT("."))));
+	}
+	OutValue = Value;
+	return true;
+}
+
+bool FDocGenTemplate::Evaluate(int32 ExpressionIndex, FRenderContext& Context, TSharedPtr<FJsonValue>& OutValue) const
+{
+	const FExpression& Expression = Expressions[ExpressionIndex];
+	switch (Expression.Type)
+	{
+		case EExpressionType::Literal:
+			OutValue = Expression.Literal;
+			return true;
+		case EExpressionType::Variable:
+			return LookUp(Expression.Path, Context, OutValue);
+		case EExpressionType::Function:
+			return EvaluateFunction(Expression, Context, OutValue);
+		case EExpressionType::MakeArray:
+		{
+			TArray<TSharedPtr<FJsonValue>> Elements;
+			for (int32 Operand : Expression.Operands)
+			{
+				if (!Evaluate(Operand, Context, Elements.AddDefaulted_GetRef()))
+				{
+					return false;
+				}
+			}
+			OutValue = MakeShared<FJsonValueArray>(Elements);
+			return true;
+		}
+		case EExpressionType::And:
+		case EExpressionType::Or:
+		{
+			// Short-circuits, so exists("x") and x.y doesn't fail when x is missing
+			TSharedPtr<FJsonValue> Left;
+			if (!Evaluate(Expression.Operands[0], Context, Left))
+			{
+				return false;
+			}
+			const bool bIsAnd = Expression.Type == EExpressionType::And;
+			if (IsTruthy(Left) != bIsAnd)
+			{
+				OutValue = MakeBool(!bIsAnd);
+				return true;
+			}
+			TSharedPtr<FJsonValue> Right;
+			if (!Evaluate(Expression.Operands[1], Context, Right))
+			{
+				return false;
+			}
+			OutValue = MakeBool(IsTruthy(Right));
+			return true;
+		}
+		default:
+			break;
+	}
+
+	TSharedPtr<FJsonValue> Left;
+	TSharedPtr<FJsonValue> Right;
+	if (!Evaluate(Expression.Operands[0], Context, Left) ||
+		(Expression.Operands.Num() > 1 && !Evaluate(Expression.Operands[1], Context, Right)))
+	{
+		return false;
+	}
+	const bool bNumbers = Left->Type == EJson::Number && Right && Right->Type == EJson::Number;
+	const bool bStrings = Left->Type == EJson::String && Right && Right->Type == EJson::String;
+	auto RequireNumbers = [&Context, &Left, &Right, bNumbers](const TCHAR* Operator) {
+		return bNumbers || Context.Fail(FString::Printf(TEXT("can't apply %s to %s and %s"), Operator,
+														  GetTypeName(Left), GetTypeName(Right)));
+	};
+
+	switch (Expression.Type)
+	{
+		case EExpressionType::Not:
+			OutValue = MakeBool(!IsTruthy(Left));
+			return true;
+		case EExpressionType::Negate:
+			if (Left->Type != EJson::Number)
+			{
+				return Context.Fail(FString::Printf(TEXT("can't negate %s"), GetTypeName(Left)));
+			}
+			OutValue = MakeNumber(-Left->AsNumber());
+			return true;
+		case EExpressionType::Equal:
+			OutValue = MakeBool(JsonEquals(Left, Right));
+			return true;
+		case EExpressionType::NotEqual:
+			OutValue = MakeBool(!JsonEquals(Left, Right));
+			return true;
+		case EExpressionType::Less:
+		case EExpressionType::LessEqual:
+		case EExpressionType::Greater:
+		case EExpressionType::GreaterEqual:
+		{
+			if (!bNumbers && !bStrings)
+			{
+				return Context.Fail(
+					FString::Printf(TEXT("can't compare %s and %s"), GetTypeName(Left), GetTypeName(Right)));
+			}
+			const bool bLess = JsonLess(Left, Right);
+			const bool bGreater = JsonLess(Right, Left);
+			const bool bResult = Expression.Type == EExpressionType::Less		 ? bLess
+								 : Expression.Type == EExpressionType::LessEqual ? !bGreater
+								 : Expression.Type == EExpressionType::Greater	 ? bGreater
+																				 : !bLess;
+			OutValue = MakeBool(bResult);
+			return true;
+		}
+		case EExpressionType::In:
+			if (Right->Type != EJson::Array)
+			{
+				return Context.Fail(FString::Printf(TEXT("'in' expects an array, not %s"), GetTypeName(Right)));
+			}
+			OutValue = MakeBool(Right->AsArray().ContainsByPredicate(
+				[&Left](const TSharedPtr<FJsonValue>& Element) { return JsonEquals(Left, Element); }));
+			return true;
+		case EExpressionType::Add:
+			if (bStrings)
+			{
+				OutValue = MakeString(Left->AsString() + Right->AsString());
+				return true;
+			}
+			if (!RequireNumbers(TEXT("+")))
+			{
+				return false;
+			}
+			OutValue = MakeNumber(Left->AsNumber() + Right->AsNumber());
+			return true;
+		case EExpressionType::Subtract:
+			if (!RequireNumbers(TEXT("-")))
+			{
+				return false;
+			}
+			OutValue = MakeNumber(Left->AsNumber() - Right->AsNumber());
+			return true;
+		case EExpressionType::Multiply:
+			if (!RequireNumbers(TEXT("*")))
+			{
+				return false;
+			}
+			OutValue = MakeNumber(Left->AsNumber() * Right->AsNumber());
+			return true;
+		case EExpressionType::Divide:
+			if (!RequireNumbers(TEXT("/")))
+			{
+				return false;
+			}
+			if (Right->AsNumber() == 0.0)
+			{
+				return Context.Fail(TEXT("division by zero"));
+			}
+			OutValue = MakeNumber(Left->AsNumber() / Right->AsNumber());
+			return true;
+		case EExpressionType::Modulo:
+			if (!RequireNumbers(TEXT("%")))
+			{
+				return false;
+			}
+			if (static_cast<int64>(Right->AsNumber()) == 0)
+			{
+				return Context.Fail(TEXT("modulo by zero"));
+			}
+			OutValue = MakeNumber(static_cast<double>(static_cast<int64>(Left->AsNumber()) %
+													   static_cast<int64>(Right->AsNumber())));
+			return true;
+		case EExpressionType::Power:
+			if (!RequireNumbers(TEXT("^")))
+			{
+				return false;
+			}
+			OutValue = MakeNumber(FMath::Pow(Left->AsNumber(), Right->AsNumber()));
+			return true;
+		case EExpressionType::Concat:
+			OutValue = MakeString(ToDisplayString(Left) + ToDisplayString(Right));
+			return true;
+		default:
+			return Context.Fail(TEXT("invalid expression"));
+	}
+}
+
+bool FDocGenTemplate::EvaluateFunction(const FExpression& Expression, FRenderContext& Context,
+									   TSharedPtr<FJsonValue>& OutValue) const
+{
+	// Both tolerate a missing variable, so they evaluate their own arguments
+	if (Expression.Function == EFunction::Default)
+	{
+		if (Evaluate(Expression.Operands[0], Context, OutValue))
+		{
+			return true;
+		}
+		Context.Error.Reset();
+		return Evaluate(Expression.Operands[1], Context, OutValue);
+	}
+	if (Expression.Function == EFunction::Exists)
+	{
+		TSharedPtr<FJsonValue> Name;
+		if (!Evaluate(Expression.Operands[0], Context, Name))
+		{
+			return false;
+		}
+		if (Name->Type != EJson::String)
+		{
+			return Context.Fail(TEXT("exists expects a variable name"));
+		}
+		TArray<FString> Path;
+		Name->AsString().ParseIntoArray(Path, TEXT("."));
+		TSharedPtr<FJsonValue> Value;
+		OutValue = MakeBool(Path.Num() && LookUp(Path, Context, Value));
+		Context.Error.Reset();
+		return true;
+	}
+
+	TArray<TSharedPtr<FJsonValue>, TInlineAllocator<3>> Arguments;
+	for (int32 Operand : Expression.Operands)
+	{
+		if (!Evaluate(Operand, Context, Arguments.AddDefaulted_GetRef()))
+		{
+			return false;
+		}
+	}
+	const TSharedPtr<FJsonValue>& Argument = Arguments[0];
+	auto Require = [&Context](const TCHAR* FunctionName, const TSharedPtr<FJsonValue>& Value, EJson Type) {
+		return Value->Type == Type || Context.Fail(FString::Printf(TEXT("%s can't be applied to %s"), FunctionName,
+																	 GetTypeName(Value)));
+	};
+	auto RequireNonEmptyArray = [&Context, &Require](const TCHAR* FunctionName, const TSharedPtr<FJsonValue>& Value) {
+		if (!Require(FunctionName, Value, EJson::Array))
+		{
+			return false;
+		}
+		return Value->AsArray().Num() > 0 ||
+			   Context.Fail(FString::Printf(TEXT("%s can't be applied to an empty array"), FunctionName));
+	};
+
+	switch (Expression.Function)
+	{
+		case EFunction::At:
+		{
+			const TSharedPtr<FJsonValue>& Key = Arguments[1];
+			if (Argument->Type == EJson::Object && Key->Type == EJson::String)
+			{
+				OutValue = Argument->AsObject()->Values.FindRef(Key->AsString());
+			}
+			else if (Argument->Type == EJson::Array && Key->Type == EJson::Number)
+			{
+				const TArray<TSharedPtr<FJsonValue>>& Elements = Argument->AsArray();
+				const int32 Index = static_cast<int32>(Key->AsNumber());
+				OutValue = Elements.IsValidIndex(Index) ? Elements[Index] : nullptr;
+			}
+			else
+			{
+				OutValue = nullptr;
+			}
+			return OutValue || Context.Fail(FString::Printf(TEXT("at: %s has no member %s"), GetTypeName(Argument),
+															 *ToDisplayString(Key)));
+		}
+		case EFunction::Capitalize:
+		{
+			if (!Require(TEXT("capitalize"), Argument, EJson::String))
+			{
+				return false;
+			}
+			const FString& Text = Argument->AsString();
+			OutValue = MakeString(Text.Left(1).ToUpper() + Text.Mid(1).ToLower());
+			return true;
+		}
+		case EFunction::DivisibleBy:
+		case EFunction::Even:
+		case EFunction::Odd:
+		{
+			const int64 Divisor = Expression.Function == EFunction::DivisibleBy ? 0 : 2;
+			if (!Require(TEXT("divisibleBy, even and odd"), Argument, EJson::Number) ||
+				(Arguments.Num() > 1 && !Require(TEXT("divisibleBy"), Arguments[1], EJson::Number)))
+			{
+				return false;
+			}
+			const int64 ActualDivisor = Divisor ? Divisor : static_cast<int64>(Arguments[1]->AsNumber());
+			if (ActualDivisor == 0)
+			{
+				return Context.Fail(TEXT("divisibleBy: division by zero"));
+			}
+			const bool bDivisible = static_cast<int64>(Argument->AsNumber()) % ActualDivisor == 0;
+			OutValue = MakeBool(Expression.Function == EFunction::Odd ? !bDivisible : bDivisible);
+			return true;
+		}
+		case EFunction::ExistsIn:
+			if (!Require(TEXT("existsIn"), Argument, EJson::Object) ||
+				!Require(TEXT("existsIn"), Arguments[1], EJson::String))
+			{
+				return false;
+			}
+			OutValue = MakeBool(Argument->AsObject()->HasField(Arguments[1]->AsString()));
+			return true;
+		case EFunction::First:
+			if (!RequireNonEmptyArray(TEXT("first"), Argument))
+			{
+				return false;
+			}
+			OutValue = Argument->AsArray()[0];
+			return true;
+		case EFunction::Last:
+			if (!RequireNonEmptyArray(TEXT("last"), Argument))
+			{
+				return false;
+			}
+			OutValue = Argument->AsArray().Last();
+			return true;
+		case EFunction::Float:
+		case EFunction::Int:
+		{
+			double Value = 0.0;
+			if (Argument->Type == EJson::String)
+			{
+				Value = FCString::Atod(*Argument->AsString());
+			}
+			else if (Require(TEXT("float and int"), Argument, EJson::Number))
+			{
+				Value = Argument->AsNumber();
+			}
+			else
+			{
+				return false;
+			}
+			OutValue = MakeNumber(Expression.Function == EFunction::Int ? FMath::TruncToDouble(Value) : Value);
+			return true;
+		}
+		case EFunction::IsArray:
+			OutValue = MakeBool(Argument->Type == EJson::Array);
+			return true;
+		case EFunction::IsBoolean:
+			OutValue = MakeBool(Argument->Type == EJson::Boolean);
+			return true;
+		case EFunction::IsFloat:
+			OutValue = MakeBool(Argument->Type == EJson::Number && !IsWholeNumber(Argument->AsNumber()));
+			return true;
+		case EFunction::IsInteger:
+			OutValue = MakeBool(Argument->Type == EJson::Number && IsWholeNumber(Argument->AsNumber()));
+			return true;
+		case EFunction::IsNumber:
+			OutValue = MakeBool(Argument->Type == EJson::Number);
+			return true;
+		case EFunction::IsObject:
+			OutValue = MakeBool(Argument->Type == EJson::Object);
+			return true;
+		case EFunction::IsString:
+			OutValue = MakeBool(Argument->Type == EJson::String);
+			return true;
+		case EFunction::Join:
+		{
+			if (!Require(TEXT("join"), Argument, EJson::Array))
+			{
+				return false;
+			}
+			const FString Separator = ToDisplayString(Arguments[1]);
+			const TArray<TSharedPtr<FJsonValue>>& Elements = Argument->AsArray();
+			FString Joined;
+			for (int32 Index = 0; Index < Elements.Num(); ++Index)
+			{
+				Joined += Index ? Separator + ToDisplayString(Elements[Index]) : ToDisplayString(Elements[Index]);
+			}
+			OutValue = MakeString(Joined);
+			return true;
+		}
+		case EFunction::Length:
+			if (Argument->Type == EJson::String)
+			{
+				OutValue = MakeNumber(Argument->AsString().Len());
+			}
+			else if (Argument->Type == EJson::Array)
+			{
+				OutValue = MakeNumber(Argument->AsArray().Num());
+			}
+			else if (Require(TEXT("length"), Argument, EJson::Object))
+			{
+				OutValue = MakeNumber(Argument->AsObject()->Values.Num());
+			}
+			else
+			{
+				return false;
+			}
+			return true;
+		case EFunction::Lower:
+		case EFunction::Upper:
+			if (!Require(TEXT("lower and upper"), Argument, EJson::String))
+			{
+				return false;
+			}
+			OutValue = MakeString(Expression.Function == EFunction::Lower ? Argument->AsString().ToLower()
+																		  : Argument->AsString().ToUpper());
+			return true;
+		case EFunction::Max:
+		case EFunction::Min:
+		{
+			if (!RequireNonEmptyArray(TEXT("max and min"), Argument))
+			{
+				return false;
+			}
+			const bool bMax = Expression.Function == EFunction::Max;
+			OutValue = Argument->AsArray()[0];
+			for (const TSharedPtr<FJsonValue>& Element : Argument->AsArray())
+			{
+				if (bMax ? JsonLess(OutValue, Element) : JsonLess(Element, OutValue))
+				{
+					OutValue = Element;
+				}
+			}
+			return true;
+		}
+		case EFunction::Range:
+		{
+			if (!Require(TEXT("range"), Argument, EJson::Number))
+			{
+				return false;
+			}
+			TArray<TSharedPtr<FJsonValue>> Elements;
+			for (int64 Value = 0; Value < static_cast<int64>(Argument->AsNumber()); ++Value)
+			{
+				Elements.Add(MakeNumber(static_cast<double>(Value)));
+			}
+			OutValue = MakeShared<FJsonValueArray>(Elements);
+			return true;
+		}
+		case EFunction::Replace:
+			if (!Require(TEXT("replace"), Argument, EJson::String) ||
+				!Require(TEXT("replace"), Arguments[1], EJson::String) ||
+				!Require(TEXT("replace"), Arguments[2], EJson::String))
+			{
+				return false;
+			}
+			OutValue = MakeString(Arguments[1]->AsString().IsEmpty()
+									  ? Argument->AsString()
+									  : Argument->AsString().Replace(*Arguments[1]->AsString(),
+																	 *Arguments[2]->AsString(),
+																	 ESearchCase::CaseSensitive));
+			return true;
+		case EFunction::Round:
+		{
+			if (!Require(TEXT("round"), Argument, EJson::Number) ||
+				!Require(TEXT("round"), Arguments[1], EJson::Number))
+			{
+				return false;
+			}
+			const double Scale = FMath::Pow(10.0, Arguments[1]->AsNumber());
+			OutValue = MakeNumber(FMath::RoundToDouble(Argument->AsNumber() * Scale) / Scale);
+			return true;
+		}
+		case EFunction::Sort:
+		{
+			if (!Require(TEXT("sort"), Argument, EJson::Array))
+			{
+				return false;
+			}
+			TArray<TSharedPtr<FJsonValue>> Elements = Argument->AsArray();
+			Algo::StableSort(Elements, [](const TSharedPtr<FJsonValue>& A, const TSharedPtr<FJsonValue>& B) {
+				return JsonLess(A, B);
+			});
+			OutValue = MakeShared<FJsonValueArray>(Elements);
+			return true;
+		}
+		default:
+			return Context.Fail(TEXT("invalid function"));
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+
+class FJsonObject;
+class FJsonValue;
+
+/// @brief In-process renderer for the inja templates convert.exe renders docs.mdx.in and docs.adoc.in with.
+/// Understands {{ expressions }}, {# comments #}, whitespace control markers and the if, else if, else, for (over
+/// arrays, and key/value pairs of objects), set, include and raw statements. Expressions support literals, variable
+/// paths, the loop variable, the logical, comparison and arithmetic operators, pipes and inja's built-in functions.
+/// Templates are compiled once, includes inlined, into a flat instruction list that renders straight into an archive.
+/// Iterations of a loop that isn't nested in another one render in parallel and are written out in order, where json
+/// values are reference counted thread safely.
+/// Anything outside that subset, such as callbacks convert.exe may register, fails to compile, callers fall back to
+/// convert.exe for those templates.
+class FDocGenTemplate
+{
+public:
+	/// @brief Loads and compiles TemplatePath and every template it includes, which are looked up relative to the
+	/// including template like inja does
+	/// @param OutError why the template couldn't be compiled
+	/// @return the compiled template, or nullptr
+	static TSharedPtr<FDocGenTemplate> Compile(const FString& TemplatePath, FString& OutError);
+
+	/// @brief Renders the template with Data as its root object
+	/// @param OutError why rendering failed, the output is incomplete in that case
+	bool Render(const TSharedPtr<FJsonObject>& Data, FArchive& Output, FString& OutError) const;
+
+	/// @brief Compiles TemplatePath and renders it with Data to OutputPath, logging why if either fails
+	static bool RenderFile(const FString& TemplatePath, const TSharedPtr<FJsonObject>& Data, const FString& OutputPath);
+
+private:
+	enum class EFunction : uint8
+	{
+		At,
+		Capitalize,
+		Default,
+		DivisibleBy,
+		Even,
+		Exists,
+		ExistsIn,
+		First,
+		Float,
+		Int,
+		IsArray,
+		IsBoolean,
+		IsFloat,
+		IsInteger,
+		IsNumber,
+		IsObject,
+		IsString,
+		Join,
+		Last,
+		Length,
+		Lower,
+		Max,
+		Min,
+		Odd,
+		Range,
+		Replace,
+		Round,
+		Sort,
+		Upper,
+	};
+
+	enum class EExpressionType : uint8
+	{
+		Literal,
+		Variable,
+		Function,
+		MakeArray,
+		And,
+		Or,
+		Not,
+		Negate,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		In,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Modulo,
+		Power,
+		Concat,
+	};
+
+	struct FExpression
+	{
+		EExpressionType Type = EExpressionType::Literal;
+		EFunction Function = EFunction::At;
+		TSharedPtr<FJsonValue> Literal;
+		// Variable path, split at its dots
+		TArray<FString> Path;
+		// Indices into Expressions
+		TArray<int32> Operands;
+	};
+
+	enum class EInstructionType : uint8
+	{
+		Text,
+		Print,
+		JumpIfFalse,
+		Jump,
+		ForBegin,
+		ForEnd,
+		Set,
+	};
+
+	struct FInstruction
+	{
+		EInstructionType Type = EInstructionType::Text;
+		int32 Expression = INDEX_NONE;
+		// Jumps: where to continue. ForBegin: its ForEnd, ForEnd: its ForBegin.
+		int32 Target = INDEX_NONE;
+		// Text: already encoded as UTF-8
+		TArray<uint8> Text;
+		// ForBegin: the loop variables, KeyName only for loops over objects. Set: the variable assigned.
+		FString ValueName;
+		FString KeyName;
+		// ForBegin: whether the body leaves no state behind, so its iterations can render independently
+		bool bIndependentIterations = false;
+	};
+
+	struct FRenderContext;
+	class FCompiler;
+
+	bool Execute(int32 Begin, int32 End, FRenderContext& Context) const;
+	bool ExecuteFor(int32 ForBegin, FRenderContext& Context) const;
+	bool Evaluate(int32 ExpressionIndex, FRenderContext& Context, TSharedPtr<FJsonValue>& OutValue) const;
+	bool EvaluateFunction(const FExpression& Expression, FRenderContext& Context,
+						  TSharedPtr<FJsonValue>& OutValue) const;
+	bool LookUp(const TArray<FString>& Path, FRenderContext& Context, TSharedPtr<FJsonValue>& OutValue) const;
+
+	TArray<FInstruction> Instructions;
+	TArray<FExpression> Expressions;
+};
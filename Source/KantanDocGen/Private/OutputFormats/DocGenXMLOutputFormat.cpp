@@ -1,6 +1,6 @@
 #include "OutputFormats/DocGenXMLOutputFormat.h"
 #include "OutputFormats/DocGenXMLOutputProcessor.h"
-#include "XmlFile.h"
+#include "OutputFormats/DocGenXMLStreamWriter.h"
  
 FString DocGenXMLSerializer::EscapeString(const FString& InString)
 {
@@ -14,42 +14,40 @@ FString DocGenXMLSerializer::GetFileExtension()
 
 void DocGenXMLSerializer::SerializeObject(const DocTreeNode::Object& Obj)
 {
+	// for each value in Obj open an element using the key as a name, then have the value serialize itself into it
 	for (auto& Member : Obj)
 	{
-		TargetNode->AppendChildNode(Member.Key, FString());
-		Member.Value->SerializeWith(MakeShared<DocGenXMLSerializer>(TargetNode->GetChildrenNodes().Last()));
+		Writer->BeginElement(Member.Key);
+		Member.Value->SerializeWith(*this);
+		Writer->EndElement();
 	}
-	// for each value in Obj
-	// create a node using the key as a name
-	// then call SerializeWith and pass ourselves
 }
 
 void DocGenXMLSerializer::SerializeString(const FString& InString)
 {
-	TargetNode->SetContent(InString);
+	Writer->WriteText(InString);
+}
+
+void DocGenXMLSerializer::SerializeEscapedString(const FString& InString)
+{
+	Writer->WriteCData(InString);
 }
 
 void DocGenXMLSerializer::SerializeNull() {}
 
-DocGenXMLSerializer::DocGenXMLSerializer()
+DocGenXMLSerializer::DocGenXMLSerializer() : Writer(MakeShared<DocGenXMLStreamWriter>())
 {
-	const FString FileTemplate = R"xxx(<?xml version="1.0" encoding="UTF-8"?>)xxx"
-								 "\r\n"
-								 R"xxx(<root></root>)xxx";
-
-	TopLevelFile = MakeShared<FXmlFile>(FileTemplate, EConstructMethod::ConstructFromBuffer);
-	TargetNode = TopLevelFile->GetRootNode();
+	Writer->BeginElement(TEXT("root"));
 }
 
-DocGenXMLSerializer::DocGenXMLSerializer(FXmlNode* TargetNode) : TargetNode(TargetNode) {}
-
 bool DocGenXMLSerializer::SaveToFile(const FString& OutFileDirectory, const FString& OutFileName)
 {
-	if (!TopLevelFile)
-	{
-		return false;
-	}
-	return TopLevelFile->Save(OutFileDirectory / OutFileName + GetFileExtension());
+	return Writer->SaveToFile(OutFileDirectory / OutFileName + GetFileExtension());
+}
+
+bool DocGenXMLSerializer::SaveToBuffer(TArray<uint8>& OutBuffer)
+{
+	return Writer->SaveToBuffer(OutBuffer);
 }
 
 TSharedPtr<struct DocTreeNode::IDocTreeSerializer> UDocGenXMLOutputFactory::CreateSerializer()
@@ -8,19 +8,18 @@
 
 class DocGenXMLSerializer : public DocTreeNode::IDocTreeSerializer
 {
-	TSharedPtr<class FXmlFile> TopLevelFile;
-	class FXmlNode* TargetNode;
+	TSharedPtr<class DocGenXMLStreamWriter> Writer;
 	virtual FString EscapeString(const FString& InString) override;
 	virtual FString GetFileExtension() override;
 	virtual void SerializeObject(const DocTreeNode::Object& Obj) override;
 	virtual void SerializeString(const FString& InString) override;
+	virtual void SerializeEscapedString(const FString& InString) override;
 	virtual void SerializeNull() override;
 
 public:
-	// constructor taking initial document state
-	DocGenXMLSerializer(FXmlNode* TargetNode);
 	DocGenXMLSerializer();
 	virtual bool SaveToFile(const FString& OutFileDirectory, const FString& OutFileName);;
+	virtual bool SaveToBuffer(TArray<uint8>& OutBuffer) override;
 };
 
 
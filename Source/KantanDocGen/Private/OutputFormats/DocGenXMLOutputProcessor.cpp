@@ -1,7 +1,19 @@
 #include "OutputFormats/DocGenXMLOutputProcessor.h"
-#include "HAL/PlatformProcess.h"
+#include "Async/ParallelFor.h"
+#include "DocGenImageManifest.h"
+#include "DocGenProcessLimiter.h"
+#include "DocGenWriteQueue.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Interfaces/IPluginManager.h"
 #include "KantanDocGenLog.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenHTMLRenderer.h"
+#include "OutputFormats/DocGenXMLReader.h"
+
+bool DocGenXMLOutputProcessor::IsCancelRequested() const
+{
+	return ProcessLimiter && ProcessLimiter->IsCancelRequested();
+}
 
 EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(FString const& IntermediateDir,
 																				FString const& OutputDir,
@@ -16,77 +28,127 @@ EIntermediateProcessingResult DocGenXMLOutputProcessor::ProcessIntermediateDocs(
 		return EIntermediateProcessingResult::UnknownError;
 	}
 
-	const FString DocGenToolBinPath =
-		Plugin->GetBaseDir() / TEXT("ThirdParty") / TEXT("KantanDocGenTool") / TEXT("bin");
-	const FString DocGenToolExeName = TEXT("KantanDocGen.exe");
-	const FString DocGenToolPath = DocGenToolBinPath / DocGenToolExeName;
+	// bCleanOutput needs no handling here, the task has emptied the output directory before processing started and
+	// every page is regenerated
+	FDocGenXMLElement Index;
+	if (!FDocGenXMLReader::LoadFile(IntermediateDir / TEXT("index.xml"), Index))
+	{
+		return EIntermediateProcessingResult::UnknownError;
+	}
 
-	// Create a read and write pipe for the child process
-	void* PipeRead = nullptr;
-	void* PipeWrite = nullptr;
-	verify(FPlatformProcess::CreatePipe(PipeRead, PipeWrite));
+	const TSharedPtr<FDocGenImageManifest> ImageManifest =
+		FDocGenImageManifest::Load(IntermediateDir / FDocGenImageManifest::ManifestFileName);
+	if (!ImageManifest)
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("No image manifest in %s, node images won't be copied"),
+			   *IntermediateDir);
+	}
 
-	FString Args = FString(TEXT("-outputdir=")) + TEXT("\"") + OutputDir + TEXT("\"") +
-				   TEXT(" -fromintermediate -intermediatedir=") + TEXT("\"") + IntermediateDir + TEXT("\"") +
-				   TEXT(" -name=") + DocTitle + (bCleanOutput ? TEXT(" -cleanoutput") : TEXT(""));
-	UE_LOG(LogKantanDocGen, Log, TEXT("Invoking conversion tool: %s %s"), *DocGenToolPath, *Args);
-	FProcHandle Proc =
-		FPlatformProcess::CreateProc(*DocGenToolPath, *Args, true, false, false, nullptr, 0, nullptr, PipeWrite);
+	FDocGenWriteQueue WriteQueue;
+	WriteQueue.SetManifest(OutputManifest);
+	WriteQueue.EnqueueWrite(OutputDir / TEXT("index.html"), FDocGenHTMLRenderer::RenderIndexPage(Index));
+	WriteQueue.EnqueueCopy(OutputDir / TEXT("css") / TEXT("bpdoc.css"),
+						   Plugin->GetBaseDir() / TEXT("ThirdParty") / TEXT("KantanDocGenTool") / TEXT("css") /
+							   TEXT("bpdoc.css"));
 
-	int32 ReturnCode = 0;
-	if (Proc.IsValid())
+	TArray<FString> ClassIds;
+	if (const FDocGenXMLElement* Classes = Index.FindChild(TEXT("classes")))
 	{
-		FString BufferedText;
-		for (bool bProcessFinished = false; !bProcessFinished;)
+		for (const FDocGenXMLElement& Class : Classes->Children)
 		{
-			bProcessFinished = FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
-
-			/*			if(!bProcessFinished && Warn->ReceivedUserCancel())
-			{
-			FPlatformProcess::TerminateProc(ProcessHandle);
-			bProcessFinished = true;
-			}
-			*/
-			BufferedText += FPlatformProcess::ReadPipe(PipeRead);
+			ClassIds.Add(Class.GetChildText(TEXT("id")));
+		}
+	}
+	// Only the ids are needed from here on, the class pages list the nodes
+	Index = FDocGenXMLElement();
 
-			int32 EndOfLineIdx;
-			while (BufferedText.FindChar('\n', EndOfLineIdx))
+	// Pages only depend on their own document, so every class and then every node is rendered on whichever worker is
+	// free. Documents are dropped as soon as their page is queued, the write queue bounds what's waiting on disk.
+	FThreadSafeCounter FailedPages;
+	TArray<TArray<FString>> NodeIdsPerClass;
+	NodeIdsPerClass.SetNum(ClassIds.Num());
+	ParallelFor(ClassIds.Num(), [&](int32 ClassIndex) {
+		if (IsCancelRequested())
+		{
+			return;
+		}
+		const FString& ClassId = ClassIds[ClassIndex];
+		FDocGenXMLElement ClassDoc;
+		if (!FDocGenXMLReader::LoadFile(IntermediateDir / ClassId / ClassId + TEXT(".xml"), ClassDoc))
+		{
+			FailedPages.Increment();
+			return;
+		}
+		if (const FDocGenXMLElement* Nodes = ClassDoc.FindChild(TEXT("nodes")))
+		{
+			for (const FDocGenXMLElement& Node : Nodes->Children)
 			{
-				FString Line = BufferedText.Left(EndOfLineIdx);
-				Line.RemoveFromEnd(TEXT("\r"));
-
-				UE_LOG(LogKantanDocGen, Log, TEXT("[KantanDocGen] %s"), *Line);
-
-				BufferedText = BufferedText.Mid(EndOfLineIdx + 1);
+				NodeIdsPerClass[ClassIndex].Add(Node.GetChildText(TEXT("id")));
 			}
-
-			FPlatformProcess::Sleep(0.1f);
 		}
+		WriteQueue.EnqueueWrite(OutputDir / ClassId / ClassId + TEXT(".html"),
+								FDocGenHTMLRenderer::RenderClassPage(ClassDoc));
+	});
 
-		// FPlatformProcess::WaitForProc(Proc);
-		// FPlatformProcess::GetProcReturnCode(Proc, &ReturnCode);
-		FPlatformProcess::CloseProc(Proc);
-		Proc.Reset();
-
-		if (ReturnCode != 0)
+	// Nodes of all classes share one pass, so a class with hundreds of nodes doesn't end up on a single thread
+	TArray<TPair<int32, int32>> NodeRefs;
+	for (int32 ClassIndex = 0; ClassIndex < NodeIdsPerClass.Num(); ++ClassIndex)
+	{
+		for (int32 NodeIndex = 0; NodeIndex < NodeIdsPerClass[ClassIndex].Num(); ++NodeIndex)
 		{
-			UE_LOG(LogKantanDocGen, Error, TEXT("KantanDocGen tool failed (code %i), see above output."), ReturnCode);
+			NodeRefs.Emplace(ClassIndex, NodeIndex);
 		}
 	}
+	ParallelFor(NodeRefs.Num(), [&](int32 RefIndex) {
+		if (IsCancelRequested())
+		{
+			return;
+		}
+		const FString& ClassId = ClassIds[NodeRefs[RefIndex].Key];
+		const FString& NodeId = NodeIdsPerClass[NodeRefs[RefIndex].Key][NodeRefs[RefIndex].Value];
+		const FString NodeDir = IntermediateDir / ClassId / TEXT("nodes");
+		FDocGenXMLElement NodeDoc;
+		if (!FDocGenXMLReader::LoadFile(NodeDir / NodeId + TEXT(".xml"), NodeDoc))
+		{
+			FailedPages.Increment();
+			return;
+		}
+		const FString& RelImagePath = NodeDoc.GetChildText(TEXT("imgpath"));
+		if (!RelImagePath.IsEmpty() && ImageManifest)
+		{
+			const FDocGenImageManifest::FImage* Image = ImageManifest->Find(FPaths::GetCleanFilename(RelImagePath));
+			if (!Image)
+			{
+				UE_LOG(LogKantanDocGen, Warning, TEXT("Image %s is missing from the image manifest"), *RelImagePath);
+			}
+			else
+			{
+				// The page references the image relative to itself, so it goes to the same place relative to the
+				// output
+				FString DestinationImagePath = OutputDir / ClassId / TEXT("nodes") / RelImagePath;
+				FPaths::CollapseRelativeDirectories(DestinationImagePath);
+				FDocGenImageManifest::EnqueuePlacement(WriteQueue, DestinationImagePath, *Image, false);
+			}
+		}
+		WriteQueue.EnqueueWrite(OutputDir / ClassId / TEXT("nodes") / NodeId + TEXT(".html"),
+								FDocGenHTMLRenderer::RenderNodePage(NodeDoc));
+	});
 
-	// Close the pipes
-	FPlatformProcess::ClosePipe(0, PipeRead);
-	FPlatformProcess::ClosePipe(0, PipeWrite);
-
-	switch (ReturnCode)
+	if (!WriteQueue.Flush())
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to write html docs to %s"), *OutputDir);
+		return EIntermediateProcessingResult::DiskWriteFailure;
+	}
+	if (IsCancelRequested())
+	{
+		UE_LOG(LogKantanDocGen, Warning, TEXT("Rendering html docs was cancelled"));
+		return EIntermediateProcessingResult::UnknownError;
+	}
+	UE_LOG(LogKantanDocGen, Log, TEXT("Rendered %d class pages and %d node pages"), ClassIds.Num(), NodeRefs.Num());
+	if (FailedPages.GetValue())
 	{
-		case 0:
-			return EIntermediateProcessingResult::Success;
-		case -1:
-			return EIntermediateProcessingResult::UnknownError;
-		case -2:
-			return EIntermediateProcessingResult::DiskWriteFailure;
-		default:
-			return EIntermediateProcessingResult::SuccessWithErrors;
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to render %d pages, see above output."), FailedPages.GetValue());
+		return EIntermediateProcessingResult::SuccessWithErrors;
 	}
+	return EIntermediateProcessingResult::Success;
 }
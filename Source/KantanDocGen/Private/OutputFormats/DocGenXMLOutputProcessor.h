@@ -1,10 +1,26 @@
 #pragma once
 #include "OutputFormats/DocGenOutputProcessor.h"
 
+/// @brief Renders the xml intermediate docs to html pages in process, see FDocGenHTMLRenderer
 class DocGenXMLOutputProcessor : public IDocGenOutputProcessor
 {
 public:
 	virtual EIntermediateProcessingResult ProcessIntermediateDocs(FString const& IntermediateDir,
 																  FString const& OutputDir, FString const& DocTitle,
 																  bool bCleanOutput) override;
-};
\ No newline at end of file
+	virtual void SetOutputManifest(TSharedPtr<class FDocGenOutputManifest> Manifest) override
+	{
+		OutputManifest = Manifest;
+	}
+	virtual void SetProcessLimiter(TSharedPtr<class FDocGenProcessLimiter> InProcessLimiter) override
+	{
+		ProcessLimiter = InProcessLimiter;
+	}
+
+private:
+	bool IsCancelRequested() const;
+
+	TSharedPtr<FDocGenOutputManifest> OutputManifest;
+	// Nothing is launched any more, but stopping the task still cancels rendering through it
+	TSharedPtr<FDocGenProcessLimiter> ProcessLimiter;
+};
@@ -0,0 +1,342 @@
+#include "OutputFormats/DocGenXMLReader.h"
+#include "DocGenUTF8.h"
+#include "KantanDocGenLog.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	bool IsXMLWhitespace(uint8 Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\r' || Char == '\n';
+	}
+
+	/// @return the start of the first occurrence of Sequence in [Current, End), or nullptr if there is none
+	const uint8* FindSequence(const uint8* Current, const uint8* End, const ANSICHAR* Sequence)
+	{
+		const int32 SequenceLen = FCStringAnsi::Strlen(Sequence);
+		for (; End - Current >= SequenceLen; ++Current)
+		{
+			if (*Current == Sequence[0] && FMemory::Memcmp(Current, Sequence, SequenceLen) == 0)
+			{
+				return Current;
+			}
+		}
+		return nullptr;
+	}
+
+	void AppendUtf8CodePoint(TArray<uint8>& Out, uint32 CodePoint)
+	{
+		if (CodePoint < 0x80)
+		{
+			Out.Add(static_cast<uint8>(CodePoint));
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out.Add(static_cast<uint8>(0xC0 | (CodePoint >> 6)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out.Add(static_cast<uint8>(0xE0 | (CodePoint >> 12)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add(static_cast<uint8>(0xF0 | (CodePoint >> 18)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+
+	/// @brief Decodes the entity reference whose body (without & and ;) is [Start, End) onto Out
+	/// @return false if the entity isn't one XML predefines or a valid character reference
+	bool AppendEntity(TArray<uint8>& Out, const uint8* Start, const uint8* End)
+	{
+		const int64 Len = End - Start;
+		auto Matches = [Start, Len](const ANSICHAR* Name) {
+			return Len == FCStringAnsi::Strlen(Name) && FMemory::Memcmp(Start, Name, Len) == 0;
+		};
+		if (Matches("amp"))
+		{
+			Out.Add('&');
+		}
+		else if (Matches("lt"))
+		{
+			Out.Add('<');
+		}
+		else if (Matches("gt"))
+		{
+			Out.Add('>');
+		}
+		else if (Matches("quot"))
+		{
+			Out.Add('"');
+		}
+		else if (Matches("apos"))
+		{
+			Out.Add('\'');
+		}
+		else if (Len > 1 && Start[0] == '#')
+		{
+			const bool bHex = Start[1] == 'x';
+			const uint32 Base = bHex ? 16 : 10;
+			const uint8* Digit = Start + (bHex ? 2 : 1);
+			if (Digit == End)
+			{
+				return false;
+			}
+			uint32 CodePoint = 0;
+			for (; Digit < End; ++Digit)
+			{
+				uint32 Value = Base;
+				if (*Digit >= '0' && *Digit <= '9')
+				{
+					Value = *Digit - '0';
+				}
+				else if (*Digit >= 'a' && *Digit <= 'f')
+				{
+					Value = *Digit - 'a' + 10;
+				}
+				else if (*Digit >= 'A' && *Digit <= 'F')
+				{
+					Value = *Digit - 'A' + 10;
+				}
+				// Checked before accumulating, so the code point can't overflow
+				if (Value >= Base || CodePoint > 0x10FFFF)
+				{
+					return false;
+				}
+				CodePoint = CodePoint * Base + Value;
+			}
+			if (CodePoint == 0 || CodePoint > 0x10FFFF)
+			{
+				return false;
+			}
+			AppendUtf8CodePoint(Out, CodePoint);
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+} // namespace
+
+const FDocGenXMLElement* FDocGenXMLElement::FindChild(const TCHAR* ChildName) const
+{
+	for (const FDocGenXMLElement& Child : Children)
+	{
+		if (Child.Name == ChildName)
+		{
+			return &Child;
+		}
+	}
+	return nullptr;
+}
+
+const FString& FDocGenXMLElement::GetChildText(const TCHAR* ChildName) const
+{
+	static const FString Empty;
+	const FDocGenXMLElement* Child = FindChild(ChildName);
+	return Child ? Child->Text : Empty;
+}
+
+bool FDocGenXMLReader::Parse(const uint8* Data, int64 Size, FDocGenXMLElement& OutRoot, const FString& DocumentName)
+{
+	const uint8* Current = Data;
+	const uint8* const End = Data + Size;
+	// Skip a byte order mark
+	if (Size >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF)
+	{
+		Current += 3;
+	}
+
+	auto Fail = [&DocumentName, Data, &Current](const TCHAR* Reason) {
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to parse %s at byte %lld: %s"), *DocumentName,
+			   static_cast<long long>(Current - Data), Reason);
+		return false;
+	};
+
+	// Elements only ever gain children while they're the innermost open one, so pointers to the open elements stay
+	// valid until they're closed
+	TArray<FDocGenXMLElement*> OpenElements;
+	// Character data of each open element, decoded to UTF-8 but not yet converted
+	TArray<TArray<uint8>> OpenText;
+	bool bHasRoot = false;
+
+	while (Current < End)
+	{
+		if (*Current != '<')
+		{
+			const uint8* TextStart = Current;
+			while (Current < End && *Current != '<')
+			{
+				++Current;
+			}
+			if (OpenElements.Num() == 0)
+			{
+				for (const uint8* Char = TextStart; Char < Current; ++Char)
+				{
+					if (!IsXMLWhitespace(*Char))
+					{
+						return Fail(TEXT("character data outside of the document element"));
+					}
+				}
+				continue;
+			}
+			TArray<uint8>& Text = OpenText.Last();
+			for (const uint8* Char = TextStart; Char < Current;)
+			{
+				if (*Char != '&')
+				{
+					const uint8* RunStart = Char;
+					while (Char < Current && *Char != '&')
+					{
+						++Char;
+					}
+					Text.Append(RunStart, Char - RunStart);
+					continue;
+				}
+				const uint8* EntityEnd = Char + 1;
+				while (EntityEnd < Current && *EntityEnd != ';')
+				{
+					++EntityEnd;
+				}
+				if (EntityEnd == Current || !AppendEntity(Text, Char + 1, EntityEnd))
+				{
+					return Fail(TEXT("invalid entity reference"));
+				}
+				Char = EntityEnd + 1;
+			}
+			continue;
+		}
+
+		const int64 Remaining = End - Current;
+		if (Remaining >= 9 && FMemory::Memcmp(Current, "<![CDATA[", 9) == 0)
+		{
+			const uint8* SectionEnd = FindSequence(Current + 9, End, "]]>");
+			if (!SectionEnd || OpenElements.Num() == 0)
+			{
+				return Fail(TEXT("misplaced or unterminated CDATA section"));
+			}
+			OpenText.Last().Append(Current + 9, SectionEnd - (Current + 9));
+			Current = SectionEnd + 3;
+		}
+		else if (Remaining >= 4 && FMemory::Memcmp(Current, "<!--", 4) == 0)
+		{
+			const uint8* CommentEnd = FindSequence(Current + 4, End, "-->");
+			if (!CommentEnd)
+			{
+				return Fail(TEXT("unterminated comment"));
+			}
+			Current = CommentEnd + 3;
+		}
+		else if (Remaining >= 2 && (Current[1] == '?' || Current[1] == '!'))
+		{
+			// Declaration, processing instruction or doctype, none of which carry content the documents use
+			const uint8* DeclarationEnd = FindSequence(Current + 2, End, ">");
+			if (!DeclarationEnd)
+			{
+				return Fail(TEXT("unterminated declaration"));
+			}
+			Current = DeclarationEnd + 1;
+		}
+		else if (Remaining >= 2 && Current[1] == '/')
+		{
+			const uint8* NameStart = Current + 2;
+			const uint8* NameEnd = NameStart;
+			while (NameEnd < End && *NameEnd != '>' && !IsXMLWhitespace(*NameEnd))
+			{
+				++NameEnd;
+			}
+			const uint8* TagEnd = FindSequence(NameEnd, End, ">");
+			if (!TagEnd || OpenElements.Num() == 0 ||
+				OpenElements.Last()->Name != DocGenUTF8::ToString(NameStart, NameEnd - NameStart))
+			{
+				return Fail(TEXT("mismatched end tag"));
+			}
+			FDocGenXMLElement* Element = OpenElements.Pop();
+			TArray<uint8> Text = OpenText.Pop();
+			if (Element->Children.Num() == 0)
+			{
+				Element->Text = DocGenUTF8::ToString(Text.GetData(), Text.Num());
+			}
+			Current = TagEnd + 1;
+		}
+		else
+		{
+			const uint8* NameStart = Current + 1;
+			const uint8* NameEnd = NameStart;
+			while (NameEnd < End && *NameEnd != '>' && *NameEnd != '/' && !IsXMLWhitespace(*NameEnd))
+			{
+				++NameEnd;
+			}
+			if (NameEnd == NameStart)
+			{
+				return Fail(TEXT("element without a name"));
+			}
+			// Skip over attributes, honouring quotes so a > inside a value doesn't end the tag
+			const uint8* TagEnd = NameEnd;
+			uint8 Quote = 0;
+			while (TagEnd < End && (Quote || *TagEnd != '>'))
+			{
+				if (Quote ? *TagEnd == Quote : (*TagEnd == '"' || *TagEnd == '\''))
+				{
+					Quote = Quote ? 0 : *TagEnd;
+				}
+				++TagEnd;
+			}
+			if (TagEnd == End)
+			{
+				return Fail(TEXT("unterminated start tag"));
+			}
+			const bool bSelfClosing = TagEnd[-1] == '/';
+
+			FDocGenXMLElement* Element = nullptr;
+			if (OpenElements.Num())
+			{
+				Element = &OpenElements.Last()->Children.AddDefaulted_GetRef();
+			}
+			else if (!bHasRoot)
+			{
+				bHasRoot = true;
+				OutRoot = FDocGenXMLElement();
+				Element = &OutRoot;
+			}
+			else
+			{
+				return Fail(TEXT("more than one document element"));
+			}
+			Element->Name = DocGenUTF8::ToString(NameStart, NameEnd - NameStart);
+			if (!bSelfClosing)
+			{
+				OpenElements.Add(Element);
+				OpenText.AddDefaulted();
+			}
+			Current = TagEnd + 1;
+		}
+	}
+
+	if (OpenElements.Num())
+	{
+		return Fail(TEXT("unexpected end of document"));
+	}
+	if (!bHasRoot)
+	{
+		return Fail(TEXT("no document element"));
+	}
+	return true;
+}
+
+bool FDocGenXMLReader::LoadFile(const FString& FilePath, FDocGenXMLElement& OutRoot)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+	{
+		UE_LOG(LogKantanDocGen, Error, TEXT("Failed to read %s"), *FilePath);
+		return false;
+	}
+	return Parse(Bytes.GetData(), Bytes.Num(), OutRoot, FilePath);
+}
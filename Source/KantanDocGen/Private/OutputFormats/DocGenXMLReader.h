@@ -0,0 +1,35 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+
+/// @brief Element of a document read by FDocGenXMLReader. Attributes are skipped, and as the doc tree never produces
+/// mixed content only the character data of leaf elements is kept.
+struct FDocGenXMLElement
+{
+	FString Name;
+	FString Text;
+	TArray<FDocGenXMLElement> Children;
+
+	/// @return the first child element with the given name, or nullptr if there is none
+	const FDocGenXMLElement* FindChild(const TCHAR* ChildName) const;
+
+	/// @return the text of the first child element with the given name, empty if there is none
+	const FString& GetChildText(const TCHAR* ChildName) const;
+};
+
+/// @brief Reads the intermediate documents DocGenXMLStreamWriter produces into an element tree. Understands the
+/// subset of XML the writer uses (elements, character data with the predefined and numeric entities, CDATA sections),
+/// and skips the declaration, comments and doctypes.
+class FDocGenXMLReader
+{
+public:
+	/// @param Data UTF-8 encoded document
+	/// @param OutRoot receives the document element
+	/// @return false if the document isn't well formed, the reason is logged
+	static bool Parse(const uint8* Data, int64 Size, FDocGenXMLElement& OutRoot, const FString& DocumentName);
+
+	/// @brief Loads and parses the document at FilePath
+	/// @return false if the file couldn't be read or isn't well formed, the reason is logged
+	static bool LoadFile(const FString& FilePath, FDocGenXMLElement& OutRoot);
+};
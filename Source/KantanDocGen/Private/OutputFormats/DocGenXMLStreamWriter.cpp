@@ -0,0 +1,164 @@
+#include "OutputFormats/DocGenXMLStreamWriter.h"
+#include "DocGenUTF8.h"
+#include "Misc/FileHelper.h"
+
+DocGenXMLStreamWriter::DocGenXMLStreamWriter()
+{
+	// Typical node documents are a few KB, reserving up front avoids most regrowth
+	Buffer.Reserve(4096);
+	WriteAscii("<?xml version=\"1.0\" encoding=\"UTF-8\"?>" LINE_TERMINATOR_ANSI);
+}
+
+void DocGenXMLStreamWriter::BeginElement(const FString& Name)
+{
+	TerminateStartTagForChildren();
+	WriteIndent(ElementStack.Num());
+	WriteAscii("<");
+	WriteString(*Name, Name.Len());
+	ElementStack.Add({Name, EElementState::Open});
+}
+
+void DocGenXMLStreamWriter::EndElement()
+{
+	check(ElementStack.Num());
+	FOpenElement Element = ElementStack.Pop();
+	if (Element.State == EElementState::Open)
+	{
+		WriteAscii(" />" LINE_TERMINATOR_ANSI);
+		return;
+	}
+	if (Element.State == EElementState::HasChildren)
+	{
+		WriteIndent(ElementStack.Num());
+	}
+	WriteAscii("</");
+	WriteString(*Element.Name, Element.Name.Len());
+	WriteAscii(">" LINE_TERMINATOR_ANSI);
+}
+
+void DocGenXMLStreamWriter::WriteText(const FString& Text)
+{
+	if (Text.IsEmpty())
+	{
+		return;
+	}
+	TerminateStartTagForContent();
+
+	const TCHAR* Start = *Text;
+	const TCHAR* Current = Start;
+	while (*Current)
+	{
+		const ANSICHAR* Entity = nullptr;
+		switch (*Current)
+		{
+			case TEXT('&'):
+				Entity = "&amp;";
+				break;
+			case TEXT('<'):
+				Entity = "&lt;";
+				break;
+			case TEXT('>'):
+				Entity = "&gt;";
+				break;
+			default:
+				break;
+		}
+		if (Entity)
+		{
+			WriteString(Start, Current - Start);
+			WriteAscii(Entity);
+			Start = Current + 1;
+		}
+		++Current;
+	}
+	WriteString(Start, Current - Start);
+}
+
+void DocGenXMLStreamWriter::WriteCData(const FString& Text)
+{
+	TerminateStartTagForContent();
+
+	WriteAscii("<![CDATA[");
+	// A literal ]]> would terminate the section early, so split it across two sections
+	const TCHAR* Start = *Text;
+	const TCHAR* Current = Start;
+	while (*Current)
+	{
+		if (Current[0] == TEXT(']') && Current[1] == TEXT(']') && Current[2] == TEXT('>'))
+		{
+			WriteString(Start, Current - Start + 2);
+			WriteAscii("]]><![CDATA[");
+			Start = Current + 2;
+			Current += 2;
+			continue;
+		}
+		++Current;
+	}
+	WriteString(Start, Current - Start);
+	WriteAscii("]]>");
+}
+
+bool DocGenXMLStreamWriter::SaveToFile(const FString& FilePath)
+{
+	while (ElementStack.Num())
+	{
+		EndElement();
+	}
+	return FFileHelper::SaveArrayToFile(Buffer, *FilePath);
+}
+
+bool DocGenXMLStreamWriter::SaveToBuffer(TArray<uint8>& OutBuffer)
+{
+	while (ElementStack.Num())
+	{
+		EndElement();
+	}
+	OutBuffer = MoveTemp(Buffer);
+	return true;
+}
+
+void DocGenXMLStreamWriter::TerminateStartTagForChildren()
+{
+	if (ElementStack.Num() == 0)
+	{
+		return;
+	}
+	FOpenElement& Parent = ElementStack.Last();
+	// Mixed content isn't produced by the doc tree, text always lives in leaf elements
+	check(Parent.State != EElementState::HasContent);
+	if (Parent.State == EElementState::Open)
+	{
+		WriteAscii(">" LINE_TERMINATOR_ANSI);
+		Parent.State = EElementState::HasChildren;
+	}
+}
+
+void DocGenXMLStreamWriter::TerminateStartTagForContent()
+{
+	check(ElementStack.Num());
+	FOpenElement& Element = ElementStack.Last();
+	check(Element.State != EElementState::HasChildren);
+	if (Element.State == EElementState::Open)
+	{
+		WriteAscii(">");
+		Element.State = EElementState::HasContent;
+	}
+}
+
+void DocGenXMLStreamWriter::WriteIndent(int32 Depth)
+{
+	for (int32 Index = 0; Index < Depth; ++Index)
+	{
+		Buffer.Add('\t');
+	}
+}
+
+void DocGenXMLStreamWriter::WriteAscii(const ANSICHAR* Text)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+}
+
+void DocGenXMLStreamWriter::WriteString(const TCHAR* Text, int32 Len)
+{
+	DocGenUTF8::Append(Buffer, Text, Len);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "CoreMinimal.h"
+
+/// @brief Forward-only XML writer emitting UTF-8 directly into a byte buffer.
+/// Output layout matches what FXmlFile::Save produces (tab indentation, one element per line, empty elements
+/// self-closed), FDocGenXMLReader reads it back when rendering the html pages.
+class DocGenXMLStreamWriter
+{
+public:
+	DocGenXMLStreamWriter();
+
+	/// @brief Opens a new element as a child of the currently open element
+	void BeginElement(const FString& Name);
+	/// @brief Closes the most recently opened element
+	void EndElement();
+	/// @brief Writes character data into the currently open element, escaping markup characters
+	void WriteText(const FString& Text);
+	/// @brief Writes character data into the currently open element wrapped in a CDATA section
+	void WriteCData(const FString& Text);
+
+	/// @brief Closes any elements still open and writes the buffered document to disk
+	bool SaveToFile(const FString& FilePath);
+	/// @brief Closes any elements still open and hands the buffered document off, nothing can be written afterwards
+	bool SaveToBuffer(TArray<uint8>& OutBuffer);
+
+private:
+	enum class EElementState : uint8
+	{
+		// Start tag has been written but not terminated
+		Open,
+		// Element has character content
+		HasContent,
+		// Element has child elements
+		HasChildren
+	};
+
+	struct FOpenElement
+	{
+		FString Name;
+		EElementState State;
+	};
+
+	void TerminateStartTagForChildren();
+	void TerminateStartTagForContent();
+	void WriteIndent(int32 Depth);
+	void WriteAscii(const ANSICHAR* Text);
+	void WriteString(const TCHAR* Text, int32 Len);
+
+	TArray<uint8> Buffer;
+	TArray<FOpenElement> ElementStack;
+};
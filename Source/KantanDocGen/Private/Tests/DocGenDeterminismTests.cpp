@@ -0,0 +1,191 @@
+#include "Algo/Reverse.h"
+#include "Async/Async.h"
+#include "BlueprintActionDatabase.h"
+#include "BlueprintNodeSpawner.h"
+#include "DocGenSettings.h"
+#include "HAL/FileManager.h"
+#include "K2Node.h"
+#include "Kismet/BlueprintMapLibrary.h"
+#include "Kismet/KismetGuidLibrary.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NodeDocsGenerator.h"
+#include "OutputFormats/DocGenConsolidator.h"
+#include "OutputFormats/DocGenJsonOutputFormat.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/// @brief One generation of the intermediate docs and consolidated.json for a few small libraries into Dir
+	struct FGenerationRun
+	{
+		FString Dir;
+		// Classes and their nodes are enumerated in reverse, the output has to be the same either way
+		bool bReverseOrder = false;
+		TStrongObjectPtr<UDocGenJsonOutputFactory> JsonFormat;
+		TUniquePtr<FNodeDocsGenerator> DocGen;
+		TArray<UClass*> Classes;
+		TArray<TPair<UK2Node*, FNodeDocsGenerator::FNodeProcessingState>> Nodes;
+		TFuture<bool> Generation;
+		bool bSucceeded = false;
+	};
+
+	/// @brief Spawns the nodes to document and starts generating them on a worker thread, node images are rendered
+	/// through the game thread so it has to keep ticking until that's done
+	bool StartGeneration(FGenerationRun& Run)
+	{
+		IFileManager::Get().DeleteDirectory(*Run.Dir, false, true);
+		Run.JsonFormat.Reset(NewObject<UDocGenJsonOutputFactory>());
+		FKantanDocGenSettings Settings;
+		Settings.DocumentationTitle = TEXT("DeterminismTest");
+		Settings.OutputFormats.Add(Run.JsonFormat.Get());
+		Run.DocGen = MakeUnique<FNodeDocsGenerator>(Settings);
+		if (!Run.DocGen->GT_Init(Settings.DocumentationTitle, Run.Dir))
+		{
+			return false;
+		}
+
+		Run.Classes = {UKismetGuidLibrary::StaticClass(), UBlueprintMapLibrary::StaticClass()};
+		if (Run.bReverseOrder)
+		{
+			Algo::Reverse(Run.Classes);
+		}
+		for (UClass* Class : Run.Classes)
+		{
+			const auto* Spawners = FBlueprintActionDatabase::Get().GetAllActions().Find(Class);
+			if (!Spawners)
+			{
+				continue;
+			}
+			for (int32 Index = 0; Index < Spawners->Num(); ++Index)
+			{
+				UBlueprintNodeSpawner* Spawner = (*Spawners)[Run.bReverseOrder ? Spawners->Num() - 1 - Index : Index];
+				FNodeDocsGenerator::FNodeProcessingState State;
+				if (UK2Node* Node = Run.DocGen->GT_InitializeForSpawner(Spawner, Class, State))
+				{
+					Node->AddToRoot();
+					Run.Nodes.Emplace(Node, State);
+				}
+			}
+		}
+
+		Run.Generation = Async(EAsyncExecution::Thread, [&Run]() {
+			bool bGenerated = Run.Nodes.Num() > 0;
+			for (auto& Node : Run.Nodes)
+			{
+				bGenerated &= Run.DocGen->GenerateNodeImage(Node.Key, Node.Value) &&
+							  Run.DocGen->GenerateNodeDocTree(Node.Key, Node.Value);
+			}
+			for (UClass* Class : Run.Classes)
+			{
+				Run.DocGen->GenerateTypeMembers(Class);
+			}
+			return bGenerated;
+		});
+		return true;
+	}
+
+	/// @brief Writes the documents generated and consolidates them, once the worker started by StartGeneration is done
+	bool FinishGeneration(FGenerationRun& Run)
+	{
+		for (auto& Node : Run.Nodes)
+		{
+			Node.Key->RemoveFromRoot();
+		}
+		Run.Nodes.Reset();
+		if (!Run.Generation.Get() || !Run.DocGen->GT_Finalize(Run.Dir))
+		{
+			return false;
+		}
+		FDocGenConsolidator Consolidator(Run.Dir, Run.Dir / TEXT("output"), nullptr, Run.DocGen->GetDocModel());
+		const bool bConsolidated = Consolidator.Consolidate() == EIntermediateProcessingResult::Success;
+		Run.DocGen.Reset();
+		Run.JsonFormat.Reset();
+		return bConsolidated;
+	}
+
+	/// @return index.json, consolidated.json and the documents of every class, struct and enum in Dir, which are named
+	/// after the directory they're in, relative to Dir
+	TArray<FString> FindComparedFiles(const FString& Dir)
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFilesRecursive(Files, *Dir, TEXT("*.json"), true, false);
+		TArray<FString> Compared;
+		for (const FString& File : Files)
+		{
+			const FString DirectoryName = FPaths::GetCleanFilename(FPaths::GetPath(File));
+			FString Relative = File;
+			FPaths::MakePathRelativeTo(Relative, *(Dir / TEXT("")));
+			if (Relative == TEXT("index.json") || Relative == FDocGenConsolidator::ConsolidatedFileName ||
+				FPaths::GetBaseFilename(File) == DirectoryName)
+			{
+				Compared.Add(Relative);
+			}
+		}
+		Compared.Sort();
+		return Compared;
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenDeterminismTest, "KantanDocGen.Generation.ByteStableOutput",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenDeterminismTest::RunTest(const FString& Parameters)
+{
+	const FString TestDir = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir()) /
+							TEXT("KantanDocGen") / TEXT("Determinism");
+	TSharedRef<TArray<FGenerationRun>> Runs = MakeShared<TArray<FGenerationRun>>();
+	Runs->SetNum(2);
+	(*Runs)[0].Dir = TestDir / TEXT("First");
+	(*Runs)[1].Dir = TestDir / TEXT("Second");
+	(*Runs)[1].bReverseOrder = true;
+
+	for (int32 RunIndex = 0; RunIndex < Runs->Num(); ++RunIndex)
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Runs, RunIndex]() {
+			FGenerationRun& Run = (*Runs)[RunIndex];
+			Run.bSucceeded = StartGeneration(Run);
+			TestTrue(FString::Printf(TEXT("Generation %d started"), RunIndex + 1), Run.bSucceeded);
+			return true;
+		}));
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Runs, RunIndex]() {
+			FGenerationRun& Run = (*Runs)[RunIndex];
+			if (Run.bSucceeded && !Run.Generation.IsReady())
+			{
+				return false;
+			}
+			Run.bSucceeded = Run.bSucceeded && FinishGeneration(Run);
+			TestTrue(FString::Printf(TEXT("Generation %d succeeded"), RunIndex + 1), Run.bSucceeded);
+			return true;
+		}));
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Runs, TestDir]() {
+		const FGenerationRun& First = (*Runs)[0];
+		const FGenerationRun& Second = (*Runs)[1];
+		if (First.bSucceeded && Second.bSucceeded)
+		{
+			const TArray<FString> Files = FindComparedFiles(First.Dir);
+			TestTrue(TEXT("index.json was written"), Files.Contains(TEXT("index.json")));
+			TestTrue(TEXT("consolidated.json was written"), Files.Contains(FDocGenConsolidator::ConsolidatedFileName));
+			TestTrue(TEXT("Both generations wrote the same documents"), FindComparedFiles(Second.Dir) == Files);
+			for (const FString& File : Files)
+			{
+				TArray<uint8> FirstBytes;
+				TArray<uint8> SecondBytes;
+				TestTrue(FString::Printf(TEXT("%s is byte identical"), *File),
+						 FFileHelper::LoadFileToArray(FirstBytes, *(First.Dir / File)) &&
+							 FFileHelper::LoadFileToArray(SecondBytes, *(Second.Dir / File)) &&
+							 FirstBytes == SecondBytes);
+			}
+		}
+		IFileManager::Get().DeleteDirectory(*TestDir, false, true);
+		return true;
+	}));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,227 @@
+#include "Containers/StringConv.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenJsonIndex.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	TSharedRef<FDocGenJsonIndex> MakeIndex(const FString& Json)
+	{
+		const FTCHARToUTF8 Utf8(*Json, Json.Len());
+		TArray<uint8> Bytes(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+		return FDocGenJsonIndex::FromBuffer(MoveTemp(Bytes), TEXT("test document")).ToSharedRef();
+	}
+
+	TSharedPtr<FJsonObject> ParseWithSerializer(const FString& Json)
+	{
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root))
+		{
+			return nullptr;
+		}
+		return Root;
+	}
+
+	FString ToCondensedString(const TSharedPtr<FJsonObject>& Object)
+	{
+		FString Json;
+		const auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		FJsonSerializer::Serialize(Object.ToSharedRef(), Writer);
+		return Json;
+	}
+
+	/// @brief Checks the index parses Json into the same object FJsonSerializer does
+	void TestMatchesSerializer(FAutomationTestBase& Test, const FString& What, const FString& Json)
+	{
+		const TSharedPtr<FJsonObject> Expected = ParseWithSerializer(Json);
+		if (!Expected)
+		{
+			Test.AddError(FString::Printf(TEXT("%s: invalid test document %s"), *What, *Json));
+			return;
+		}
+		const TSharedPtr<FJsonObject> Parsed = MakeIndex(Json)->Parse();
+		if (Test.TestTrue(FString::Printf(TEXT("%s parsed"), *What), Parsed.IsValid()))
+		{
+			Test.TestEqual(What, ToCondensedString(Parsed), ToCondensedString(Expected));
+		}
+	}
+
+	/// @brief Checks both the index and FJsonSerializer reject Json
+	void TestRejected(FAutomationTestBase& Test, const FString& What, const FString& Json)
+	{
+		Test.TestFalse(FString::Printf(TEXT("%s is rejected by FJsonSerializer"), *What),
+					   ParseWithSerializer(Json).IsValid());
+		Test.TestFalse(FString::Printf(TEXT("%s is rejected"), *What), MakeIndex(Json)->Parse().IsValid());
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonIndexValuesTest, "KantanDocGen.JsonIndex.Values",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonIndexValuesTest::RunTest(const FString& Parameters)
+{
+	TestMatchesSerializer(*this, TEXT("Empty object"), TEXT("{}"));
+	TestMatchesSerializer(*this, TEXT("Whitespace"), TEXT(" \r\n\t{ \"a\" :\t1 ,\n\"b\" : [ ] , \"c\":{ } }\n "));
+	TestMatchesSerializer(*this, TEXT("Scalars"),
+						  TEXT(R"({"t": true, "f": false, "n": null, "i": -12, "r": 3.25, "e": 1e3, "s": ""})"));
+	TestMatchesSerializer(*this, TEXT("Nested arrays and objects"),
+						  TEXT(R"({"a": [[], [{}], {"b": [1, [2, [3, {"c": [[[]]]}]]]}], "d": {"e": {"f": {}}}})"));
+	TestMatchesSerializer(*this, TEXT("Structural characters in strings"),
+						  TEXT(R"({"{[:,]}": "}]:,[{", "a": ["\"{\"", "[]"], "b": {"c": ":,"}})"));
+	TestMatchesSerializer(*this, TEXT("Escapes"),
+						  TEXT(R"({"s": "\"\\\/\b\f\n\r\t", "k\"e\\y": "A\u00e9\u20AC"})"));
+	TestMatchesSerializer(*this, TEXT("Backslash runs before quotes"),
+						  TEXT(R"({"a": "\\", "b": "\\\\", "c": "\\\"", "d": "x\\\\\\\"y\\", "e": ["\\\\\\\\"]})"));
+	TestMatchesSerializer(*this, TEXT("Multi-byte text"),
+						  FString::Printf(TEXT("{\"%s\": \"a%sb%sc%s\"}"), TEXT("\u00FC"), TEXT("\u00E9"),
+										  TEXT("\u20AC"), TEXT("\u4E2D")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonIndexBlockBoundaryTest, "KantanDocGen.JsonIndex.BlockBoundaries",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonIndexBlockBoundaryTest::RunTest(const FString& Parameters)
+{
+	// The structural pass works 64 bytes at a time, padding moves every escape and quote across the first two block
+	// boundaries in turn
+	const TCHAR* const Strings[] = {TEXT(R"(\")"),
+									TEXT(R"(\\)"),
+									TEXT(R"(\\\")"),
+									TEXT(R"(\\\\)"),
+									TEXT(R"(a\\\\\\\"b)"),
+									TEXT(R"(\\\\\\\\\\)"),
+									TEXT(R"(\uD83D\uDE00)"),
+									TEXT(R"({[:,]})")};
+	for (const TCHAR* String : Strings)
+	{
+		for (int32 Padding = 0; Padding <= 130; ++Padding)
+		{
+			const FString Json = FString::Printf(TEXT(R"({"p": "%s", "s": "%s", "a": ["%s", {"o": "%s"}]})"),
+												 *FString::ChrN(Padding, TEXT('x')), String, String, String);
+			TestMatchesSerializer(*this, FString::Printf(TEXT("%s after %d bytes"), String, Padding), Json);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonIndexSurrogateTest, "KantanDocGen.JsonIndex.Surrogates",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonIndexSurrogateTest::RunTest(const FString& Parameters)
+{
+	TestMatchesSerializer(*this, TEXT("Escaped surrogate pair"), TEXT(R"({"s": "a\uD83D\uDE00b"})"));
+	TestMatchesSerializer(*this, TEXT("Lower case surrogate pair"), TEXT(R"({"s": "\ud834\udd1e"})"));
+	TestMatchesSerializer(*this, TEXT("Unescaped supplementary character"),
+						  FString::Printf(TEXT("{\"s\": \"a%sb\"}"), TEXT("\U0001F600")));
+
+	// FJsonSerializer keeps lone surrogates as they are on some engine versions, the index always replaces them
+	const FString Replacement = FString::Chr(TCHAR(0xFFFD));
+	const struct
+	{
+		const TCHAR* What;
+		const TCHAR* Escaped;
+		FString Expected;
+	} LoneSurrogates[] = {
+		{TEXT("High surrogate"), TEXT(R"(a\uD800b)"), TEXT("a") + Replacement + TEXT("b")},
+		{TEXT("Low surrogate"), TEXT(R"(\uDC00)"), Replacement},
+		{TEXT("High surrogate before another escape"), TEXT(R"(\uD800\u0041)"), Replacement + TEXT("A")},
+		{TEXT("Reversed pair"), TEXT(R"(\uDE00\uD83D)"), Replacement + Replacement},
+		{TEXT("High surrogate at the end"), TEXT(R"(x\uDBFF)"), TEXT("x") + Replacement},
+	};
+	for (const auto& Case : LoneSurrogates)
+	{
+		const FString Json = FString::Printf(TEXT(R"({"s": "%s"})"), Case.Escaped);
+		const TSharedPtr<FJsonObject> Parsed = MakeIndex(Json)->Parse();
+		if (TestTrue(FString::Printf(TEXT("%s parsed"), Case.What), Parsed.IsValid()))
+		{
+			TestEqual(Case.What, Parsed->GetStringField(TEXT("s")), Case.Expected);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonIndexMalformedTest, "KantanDocGen.JsonIndex.Malformed",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonIndexMalformedTest::RunTest(const FString& Parameters)
+{
+	AddExpectedError(TEXT("Failed to parse test document"), EAutomationExpectedErrorFlags::Contains, 0);
+	TestRejected(*this, TEXT("Empty document"), TEXT(""));
+	TestRejected(*this, TEXT("Array document"), TEXT(R"(["a"])"));
+	TestRejected(*this, TEXT("Unterminated string"), TEXT(R"({"a": "b)"));
+	TestRejected(*this, TEXT("Escaped closing quote"), TEXT(R"({"a": "b\"})"));
+	TestRejected(*this, TEXT("Mismatched brackets"), TEXT(R"({"a": [1, 2}])"));
+	TestRejected(*this, TEXT("Missing colon"), TEXT(R"({"a" 1})"));
+	TestRejected(*this, TEXT("Missing comma"), TEXT(R"({"a": 1 "b": 2})"));
+	TestRejected(*this, TEXT("Two values"), TEXT(R"({"a": 1 2})"));
+	TestRejected(*this, TEXT("Unquoted key"), TEXT(R"({a: 1})"));
+	TestRejected(*this, TEXT("Misspelled literal"), TEXT(R"({"a": tru})"));
+	TestRejected(*this, TEXT("Invalid escape"), TEXT(R"({"a": "\q"})"));
+	TestRejected(*this, TEXT("Short unicode escape"), TEXT(R"({"a": "\u12"})"));
+	TestRejected(*this, TEXT("Invalid unicode escape"), TEXT(R"({"a": "\u12G4"})"));
+
+	// No prefix of a document is a document of its own, wherever it's cut off
+	const FString Document = TEXT(R"({"a": [1, {"b": "c\"d\\"}, [true]], "e": "\u00e9", "f": {"g": null}})");
+	for (int32 Len = 0; Len < Document.Len(); ++Len)
+	{
+		const FString Truncated = Document.Left(Len);
+		TestFalse(FString::Printf(TEXT("Truncated to %s is rejected"), *Truncated),
+				  MakeIndex(Truncated)->Parse().IsValid());
+	}
+	TestMatchesSerializer(*this, TEXT("Whole document"), Document);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonIndexMembersTest, "KantanDocGen.JsonIndex.Members",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonIndexMembersTest::RunTest(const FString& Parameters)
+{
+	// Every member but the one asked for is stepped over without being parsed
+	const FString Json = TEXT(R"({"skipped": {"a": ["}", "\\\"", [{"b": "]"}]]}, "Wanted": {"c": [1, "\\"]},)")
+		TEXT(R"( "after": ["{", 2]})");
+	const TSharedPtr<FJsonObject> Expected = ParseWithSerializer(Json);
+	if (!TestTrue(TEXT("Test document is valid"), Expected.IsValid()))
+	{
+		return false;
+	}
+	for (const TCHAR* MemberName : {TEXT("Wanted"), TEXT("wanted")})
+	{
+		const TSharedPtr<FJsonObject> Members = MakeIndex(Json)->ParseMembers({MemberName, TEXT("missing")});
+		if (TestTrue(FString::Printf(TEXT("%s parsed"), MemberName), Members.IsValid()))
+		{
+			TestEqual(FString::Printf(TEXT("%s is the only member"), MemberName), Members->Values.Num(), 1);
+			TestTrue(FString::Printf(TEXT("%s matches FJsonSerializer"), MemberName),
+					 Members->HasField(TEXT("Wanted")) &&
+						 ToCondensedString(Members->GetObjectField(TEXT("Wanted"))) ==
+							 ToCondensedString(Expected->GetObjectField(TEXT("Wanted"))));
+		}
+	}
+
+	// Files are memory mapped rather than read where the platform allows it
+	const FString FilePath = FPaths::AutomationTransientDir() / TEXT("KantanDocGen") / TEXT("JsonIndex.json");
+	if (TestTrue(TEXT("Test file written"),
+				 FFileHelper::SaveStringToFile(Json, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)))
+	{
+		TSharedPtr<FDocGenJsonIndex> File = FDocGenJsonIndex::Open(FilePath);
+		const TSharedPtr<FJsonObject> Parsed = File ? File->Parse() : nullptr;
+		TestTrue(TEXT("Opened file matches FJsonSerializer"),
+				 Parsed && ToCondensedString(Parsed) == ToCondensedString(Expected));
+		// The mapping has to be released before the file can be deleted
+		File.Reset();
+		IFileManager::Get().Delete(*FilePath);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,156 @@
+#include "Containers/StringConv.h"
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "OutputFormats/DocGenJsonIndex.h"
+#include "OutputFormats/DocGenJsonStreamWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	TSharedRef<FDocGenJsonIndex> MakeIndex(TArray<uint8> Bytes)
+	{
+		return FDocGenJsonIndex::FromBuffer(MoveTemp(Bytes), TEXT("string table document")).ToSharedRef();
+	}
+
+	TSharedRef<FDocGenJsonIndex> MakeIndex(const FString& Json)
+	{
+		const FTCHARToUTF8 Utf8(*Json, Json.Len());
+		return MakeIndex(TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()));
+	}
+
+	FString ToCondensedString(const TSharedPtr<FJsonObject>& Object)
+	{
+		FString Json;
+		const auto Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		FJsonSerializer::Serialize(Object.ToSharedRef(), Writer);
+		return Json;
+	}
+
+	/// @brief Writes the members of Document the way the consolidator does, the string table last
+	TArray<uint8> WriteDocument(const TSharedPtr<FJsonObject>& Document, bool bPrettyPrint, bool bStringTable)
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Archive(Bytes);
+		DocGenJsonStreamWriter Writer(Archive, bPrettyPrint);
+		if (bStringTable)
+		{
+			Writer.SetStringTable(MakeShared<FDocGenJsonStringTable>());
+		}
+		Writer.BeginObject();
+		for (const auto& Member : Document->Values)
+		{
+			Writer.WriteKey(Member.Key);
+			Writer.WriteJsonValue(Member.Value);
+		}
+		if (bStringTable)
+		{
+			Writer.WriteStringTable();
+		}
+		Writer.EndObject();
+		Writer.Close();
+		return Bytes;
+	}
+
+	/// @brief Checks Json resolves to the same object FJsonSerializer parses ExpectedJson into
+	void TestResolves(FAutomationTestBase& Test, const TCHAR* What, const FString& Json, const FString& ExpectedJson)
+	{
+		TSharedPtr<FJsonObject> Expected;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ExpectedJson), Expected) || !Expected)
+		{
+			Test.AddError(FString::Printf(TEXT("%s: invalid expected document %s"), What, *ExpectedJson));
+			return;
+		}
+		const TSharedPtr<FJsonObject> Parsed = MakeIndex(Json)->ParseResolvingStrings();
+		if (Test.TestTrue(FString::Printf(TEXT("%s parsed"), What), Parsed.IsValid()))
+		{
+			Test.TestEqual(What, ToCondensedString(Parsed), ToCondensedString(Expected));
+		}
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonStringTableRoundTripTest, "KantanDocGen.JsonStringTable.RoundTrip",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonStringTableRoundTripTest::RunTest(const FString& Parameters)
+{
+	// Repeated long strings, strings either side of the interned length, long keys and escapes, at every depth
+	const FString Json = TEXT(R"({"name": "A long enough name value", "short": "tiny", "fifteen chars..": )")
+		TEXT(R"("fifteen chars..", "sixteen chars...": "sixteen chars...", "repeated": ["A long enough name value", )")
+		TEXT(R"("Another string long enough", "A long enough name value"], "nested": {"deep": [{"text": )")
+		TEXT(R"("Another string long enough"}], "n": 3, "r": 0.25, "b": true, "z": null}, "A key longer than )")
+		TEXT(R"(sixteen characters": "Escapes \"quoted\" \\ and \u00e9 in a long string", "empty": {}, "list": []})");
+	TSharedPtr<FJsonObject> Document;
+	if (!TestTrue(TEXT("Test document is valid"),
+				  FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Document) && Document))
+	{
+		return false;
+	}
+	const FString Expected = ToCondensedString(Document);
+
+	for (const bool bPrettyPrint : {false, true})
+	{
+		const TCHAR* const Style = bPrettyPrint ? TEXT("Pretty") : TEXT("Compact");
+		const TSharedPtr<FJsonObject> WithoutTable = MakeIndex(WriteDocument(Document, bPrettyPrint, false))->Parse();
+		TestTrue(FString::Printf(TEXT("%s document without a table matches"), Style),
+				 WithoutTable && ToCondensedString(WithoutTable) == Expected);
+
+		const TArray<uint8> TableBytes = WriteDocument(Document, bPrettyPrint, true);
+		const FUTF8ToTCHAR TableText(reinterpret_cast<const ANSICHAR*>(TableBytes.GetData()), TableBytes.Num());
+		const FString TableJson(TableText.Length(), TableText.Get());
+		TestTrue(FString::Printf(TEXT("%s document refers to its table"), Style),
+				 TableJson.Contains(TEXT("\"$ref\"")) && TableJson.Contains(TEXT("\"$strings\"")));
+
+		const TSharedPtr<FJsonObject> WithTable = MakeIndex(TableBytes)->ParseResolvingStrings();
+		TestTrue(FString::Printf(TEXT("%s document with a table matches"), Style),
+				 WithTable && ToCondensedString(WithTable) == Expected);
+		const TArray<uint8> PlainBytes = WriteDocument(Document, bPrettyPrint, false);
+		const TSharedPtr<FJsonObject> ResolvedWithoutTable = MakeIndex(PlainBytes)->ParseResolvingStrings();
+		TestTrue(FString::Printf(TEXT("%s document without a table resolves to itself"), Style),
+				 ResolvedWithoutTable && ToCondensedString(ResolvedWithoutTable) == Expected);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenJsonStringTableReferencesTest, "KantanDocGen.JsonStringTable.References",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenJsonStringTableReferencesTest::RunTest(const FString& Parameters)
+{
+	// The table is written last but may be anywhere, and is left out of the document either way
+	TestResolves(*this, TEXT("Table first"),
+				 TEXT(R"({"$strings": ["zero", "one"], "a": {"$ref": 1}, "b": [{"$ref": 0}]})"),
+				 TEXT(R"({"a": "one", "b": ["zero"]})"));
+	TestResolves(*this, TEXT("Table in the middle"),
+				 TEXT(R"({"a": {"$ref": 0}, "$strings": ["zero"], "b": {"c": { "$ref" : 0 }}})"),
+				 TEXT(R"({"a": "zero", "b": {"c": "zero"}})"));
+	TestResolves(*this, TEXT("Objects that only look like references"),
+				 TEXT(R"({"a": {"$ref": "0"}, "b": {"$ref": 0, "c": 1}, "c": {"$Ref": 0}, "$strings": ["zero"]})"),
+				 TEXT(R"({"a": {"$ref": "0"}, "b": {"$ref": 0, "c": 1}, "c": {"$Ref": 0}})"));
+	TestResolves(*this, TEXT("No table"), TEXT(R"({"a": {"$ref": 0}})"), TEXT(R"({"a": {"$ref": 0}})"));
+
+	AddExpectedError(TEXT("Failed to parse string table document"), EAutomationExpectedErrorFlags::Contains, 0);
+	const TCHAR* const OutOfRange[] = {
+		TEXT(R"({"a": {"$ref": 2}, "$strings": ["zero", "one"]})"),
+		TEXT(R"({"a": {"$ref": -1}, "$strings": ["zero", "one"]})"),
+		TEXT(R"({"a": {"$ref": 0.5}, "$strings": ["zero", "one"]})"),
+		TEXT(R"({"a": {"$ref": 1e20}, "$strings": ["zero", "one"]})"),
+		TEXT(R"({"a": {"$ref": x}, "$strings": ["zero", "one"]})"),
+		TEXT(R"({"a": [{"$ref": 0}], "$strings": []})"),
+		TEXT(R"({"$strings": ["zero"], "a": {"b": {"$ref": 1}}})"),
+	};
+	for (const TCHAR* Json : OutOfRange)
+	{
+		TestFalse(FString::Printf(TEXT("%s is rejected"), Json), MakeIndex(Json)->ParseResolvingStrings().IsValid());
+	}
+	TestFalse(TEXT("A table holding something other than strings is rejected"),
+			  MakeIndex(TEXT(R"({"a": {"$ref": 0}, "$strings": ["zero", 1]})"))->ParseResolvingStrings().IsValid());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,51 @@
+#include "Misc/AutomationTest.h"
+#include "NodeDocsGenerator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenMetaDataFilterTest, "KantanDocGen.Generation.MetaDataFilter",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenMetaDataFilterTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> None;
+	const TArray<FString> Include = {TEXT("Display*"), TEXT("ToolTip"), TEXT("Category?")};
+	const TArray<FString> Exclude = {TEXT("ModuleRelativePath"), TEXT("*Internal")};
+
+	TestTrue(TEXT("Every key is documented without patterns"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("ModuleRelativePath"), None, None));
+	TestTrue(TEXT("An empty include list documents keys that aren't excluded"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("BlueprintType"), None, Exclude));
+	TestFalse(TEXT("An empty include list still applies the exclude list"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("ModuleRelativePath"), None, Exclude));
+
+	TestTrue(TEXT("Wildcard include"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("DisplayName"), Include, Exclude));
+	TestTrue(TEXT("Exact include"), FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("ToolTip"), Include, Exclude));
+	TestTrue(TEXT("Single character wildcard"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("Categorys"), Include, Exclude));
+	TestFalse(TEXT("Single character wildcard needs the character"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("Category"), Include, Exclude));
+	TestFalse(TEXT("Keys matching no include pattern are left out"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("BlueprintType"), Include, Exclude));
+	TestFalse(TEXT("Include patterns match whole keys"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("ShortToolTip"), Include, Exclude));
+
+	TestFalse(TEXT("Excluding overrides including"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("DisplayInternal"), Include, Exclude));
+	TestFalse(TEXT("A key in both lists is excluded"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("ToolTip"), Include, {TEXT("ToolTip")}));
+
+	// Metadata keys are names, which compare ignoring case, so the patterns do too
+	TestTrue(TEXT("Include ignores case"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("displayname"), Include, Exclude));
+	TestTrue(TEXT("Include pattern ignores case"),
+			 FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("TOOLTIP"), Include, Exclude));
+	TestFalse(TEXT("Exclude ignores case"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("modulerelativepath"), None, Exclude));
+	TestFalse(TEXT("Exclude wildcard ignores case"),
+			  FNodeDocsGenerator::ShouldDocumentMetaDataKey(TEXT("DISPLAYINTERNAL"), Include, Exclude));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
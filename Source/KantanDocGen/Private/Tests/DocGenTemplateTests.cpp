@@ -0,0 +1,187 @@
+#include "Containers/StringConv.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OutputFormats/DocGenTemplate.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FString GetTemplateTestDir()
+	{
+		return FPaths::AutomationTransientDir() / TEXT("KantanDocGen") / TEXT("Template");
+	}
+
+	/// @brief Writes Source and the templates it includes into a fresh directory, then compiles and renders Source with
+	/// the json document Data
+	/// @param Includes template files by their path relative to Source
+	/// @return whether the template compiled and rendered, failures are added to Test as errors
+	bool RenderTemplate(FAutomationTestBase& Test, const FString& Source, const FString& Data, FString& OutRendered,
+						const TMap<FString, FString>& Includes = {})
+	{
+		const FString TemplateTestDir = GetTemplateTestDir();
+		IFileManager::Get().DeleteDirectory(*TemplateTestDir, false, true);
+		const FString TemplatePath = TemplateTestDir / TEXT("main.in");
+		bool bWritten = FFileHelper::SaveStringToFile(Source, *TemplatePath);
+		for (const TPair<FString, FString>& Include : Includes)
+		{
+			bWritten &= FFileHelper::SaveStringToFile(Include.Value, *(TemplateTestDir / Include.Key));
+		}
+		if (!Test.TestTrue(TEXT("Template files written"), bWritten))
+		{
+			return false;
+		}
+
+		FString Error;
+		const TSharedPtr<FDocGenTemplate> Template = FDocGenTemplate::Compile(TemplatePath, Error);
+		IFileManager::Get().DeleteDirectory(*TemplateTestDir, false, true);
+		if (!Template)
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to compile: %s"), *Error));
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Data), Root) || !Root)
+		{
+			Test.AddError(FString::Printf(TEXT("Invalid test data: %s"), *Data));
+			return false;
+		}
+
+		TArray<uint8> Output;
+		FMemoryWriter Writer(Output);
+		if (!Template->Render(Root, Writer, Error))
+		{
+			Test.AddError(FString::Printf(TEXT("Failed to render: %s"), *Error));
+			return false;
+		}
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Output.GetData()), Output.Num());
+		OutRendered = FString(Converted.Length(), Converted.Get());
+		return true;
+	}
+
+	void TestRender(FAutomationTestBase& Test, const TCHAR* What, const FString& Source, const FString& Data,
+					const FString& Expected, const TMap<FString, FString>& Includes = {})
+	{
+		FString Rendered;
+		if (RenderTemplate(Test, Source, Data, Rendered, Includes))
+		{
+			Test.TestEqual(What, Rendered, Expected);
+		}
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenTemplateExpressionTest, "KantanDocGen.Template.Expressions",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenTemplateExpressionTest::RunTest(const FString& Parameters)
+{
+	const FString Data = TEXT(R"({"name": "Actor", "count": 3, "ratio": 0.5, "flag": true, "items": ["a", "b"],)")
+						 TEXT(R"("nested": {"id": "Pawn"}})");
+	TestRender(*this, TEXT("Variables"), TEXT("{{ name }} {{ nested.id }} {{ items.1 }}"), Data, TEXT("Actor Pawn b"));
+	TestRender(*this, TEXT("Literals"), TEXT("{{ \"text\" }} {{ 2 }} {{ true }} {{ [\"x\", \"y\"] }}"), Data,
+			   TEXT("text 2 true [\"x\",\"y\"]"));
+	TestRender(*this, TEXT("Arithmetic"), TEXT("{{ count + 2 }} {{ count * ratio }} {{ count % 2 }} {{ -count }}"),
+			   Data, TEXT("5 1.5 1 -3"));
+	TestRender(*this, TEXT("Comparison and logic"),
+			   TEXT("{{ count > 2 and flag }} {{ count == 2 or not flag }} {{ \"a\" in items }}"), Data,
+			   TEXT("true false true"));
+	TestRender(*this, TEXT("Functions and pipes"),
+			   TEXT("{{ upper(name) }} {{ name | lower }} {{ length(items) }} {{ join(items, \"-\") }} "
+					"{{ default(missing, \"none\") }} {{ exists(\"name\") }}"),
+			   Data, TEXT("ACTOR actor 2 a-b none true"));
+	TestRender(*this, TEXT("Conditions"),
+			   TEXT("{% if count < 2 %}few{% else if count < 5 %}some{% else %}many{% endif %}"), Data,
+			   TEXT("some"));
+	TestRender(*this, TEXT("Set"), TEXT("{% set total = count * 2 %}{{ total }}"), Data, TEXT("6"));
+	TestRender(*this, TEXT("Comments"), TEXT("a{# dropped #}b"), Data, TEXT("ab"));
+	TestRender(*this, TEXT("Raw"), TEXT("{% raw %}{{ name }}{% endraw %}"), Data, TEXT("{{ name }}"));
+
+	FString Error;
+	const FString TemplateTestDir = GetTemplateTestDir();
+	IFileManager::Get().DeleteDirectory(*TemplateTestDir, false, true);
+	const FString UnsupportedPath = TemplateTestDir / TEXT("unsupported.in");
+	FFileHelper::SaveStringToFile(TEXT("{% macro name %}"), *UnsupportedPath);
+	TestFalse(TEXT("Unsupported statements fail to compile"),
+			  FDocGenTemplate::Compile(UnsupportedPath, Error).IsValid());
+	TestFalse(TEXT("Compile errors are described"), Error.IsEmpty());
+	IFileManager::Get().DeleteDirectory(*TemplateTestDir, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenTemplateLoopTest, "KantanDocGen.Template.Loops",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenTemplateLoopTest::RunTest(const FString& Parameters)
+{
+	TestRender(*this, TEXT("Array loop"),
+			   TEXT("{% for item in items %}{{ loop.index }}:{{ item }}{% if not loop.is_last %},{% endif %}"
+					"{% endfor %}"),
+			   TEXT(R"({"items": ["a", "b", "c"]})"), TEXT("0:a,1:b,2:c"));
+	TestRender(*this, TEXT("Object loop in key order"),
+			   TEXT("{% for key, value in members %}{{ key }}={{ value }};{% endfor %}"),
+			   TEXT(R"({"members": {"b": 2, "a": 1, "c": 3}})"), TEXT("a=1;b=2;c=3;"));
+	TestRender(*this, TEXT("Nested loops"),
+			   TEXT("{% for row in rows %}[{% for cell in row %}{{ loop.parent.index }}{{ cell }}{% endfor %}]"
+					"{% endfor %}"),
+			   TEXT(R"({"rows": [["a", "b"], ["c"]]})"), TEXT("[0a0b][1c]"));
+	TestRender(*this, TEXT("Empty loop"), TEXT("<{% for item in items %}{{ item }}{% endfor %}>"),
+			   TEXT(R"({"items": []})"), TEXT("<>"));
+
+	// Top level loops may render their iterations in parallel, they still have to come out in order
+	FString Items;
+	FString Expected;
+	for (int32 Index = 0; Index < 1000; ++Index)
+	{
+		Items += FString::Printf(TEXT("%s%d"), Index ? TEXT(",") : TEXT(""), Index);
+		Expected += FString::Printf(TEXT("%d;"), Index);
+	}
+	TestRender(*this, TEXT("Parallel iterations in order"), TEXT("{% for item in items %}{{ item }};{% endfor %}"),
+			   FString::Printf(TEXT(R"({"items": [%s]})"), *Items), Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenTemplateWhitespaceTest, "KantanDocGen.Template.WhitespaceControl",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenTemplateWhitespaceTest::RunTest(const FString& Parameters)
+{
+	const FString Data = TEXT(R"({"name": "Actor", "items": ["a", "b"]})");
+	TestRender(*this, TEXT("Untrimmed"), TEXT("a {{ name }} b"), Data, TEXT("a Actor b"));
+	TestRender(*this, TEXT("Trimmed expression"), TEXT("a \n {{- name -}} \n b"), Data, TEXT("aActorb"));
+	TestRender(*this, TEXT("Trimmed statements"),
+			   TEXT("<\n{%- for item in items -%}\n  {{ item }}\n{%- endfor -%}\n>"), Data, TEXT("<ab>"));
+	TestRender(*this, TEXT("Trimmed one side"), TEXT("a \n{%- if true %} b {% endif -%}\n c"), Data, TEXT("a b c"));
+	TestRender(*this, TEXT("Trimmed comment"), TEXT("a \n{#- dropped -#}\n b"), Data, TEXT("ab"));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenTemplateIncludeTest, "KantanDocGen.Template.Includes",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenTemplateIncludeTest::RunTest(const FString& Parameters)
+{
+	const FString Data = TEXT(R"({"name": "Actor", "items": ["a", "b"]})");
+	TestRender(*this, TEXT("Include"), TEXT("<{% include \"part.in\" %}>"), Data, TEXT("<Actor>"),
+			   {{TEXT("part.in"), TEXT("{{ name }}")}});
+	TestRender(*this, TEXT("Nested include next to the including template"),
+			   TEXT("<{% include \"sub/part.in\" %}>"), Data, TEXT("<[inner]>"),
+			   {{TEXT("sub/part.in"), TEXT("[{% include \"inner.in\" %}]")}, {TEXT("sub/inner.in"), TEXT("inner")}});
+	TestRender(*this, TEXT("Include in a loop"),
+			   TEXT("{% for item in items %}{% include \"item.in\" %}{% endfor %}"), Data, TEXT("(a)(b)"),
+			   {{TEXT("item.in"), TEXT("({{ item }})")}});
+
+	FString Rendered;
+	AddExpectedError(TEXT("Failed to compile"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestFalse(TEXT("Missing includes fail to compile"),
+			  RenderTemplate(*this, TEXT("{% include \"missing.in\" %}"), Data, Rendered));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
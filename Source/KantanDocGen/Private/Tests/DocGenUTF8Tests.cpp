@@ -0,0 +1,159 @@
+#include "Containers/StringConv.h"
+#include "DocGenUTF8.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	TArray<uint8> EngineEncode(const FString& Text)
+	{
+		const FTCHARToUTF8 Converted(*Text, Text.Len());
+		return TArray<uint8>(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+	}
+
+	FString EngineDecode(const TArray<uint8>& Bytes)
+	{
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	/// @brief Checks Text encodes and decodes the same as with the engine's converters, and survives the round trip
+	void TestRoundTrip(FAutomationTestBase& Test, const FString& What, const FString& Text)
+	{
+		const TArray<uint8> Encoded = DocGenUTF8::FromString(Text);
+		Test.TestTrue(FString::Printf(TEXT("%s encodes like FTCHARToUTF8"), *What), Encoded == EngineEncode(Text));
+		Test.TestEqual(FString::Printf(TEXT("%s encoded length"), *What), DocGenUTF8::EncodedLength(Text),
+					   static_cast<int64>(Encoded.Num()));
+		const FString Decoded = DocGenUTF8::ToString(Encoded.GetData(), Encoded.Num());
+		Test.TestEqual(FString::Printf(TEXT("%s decodes like FUTF8ToTCHAR"), *What), Decoded, EngineDecode(Encoded));
+		Test.TestEqual(FString::Printf(TEXT("%s round trips"), *What), Decoded, Text);
+	}
+
+	/// @brief Checks Bytes decode to Expected, where the engine's converter may substitute something else
+	void TestDecode(FAutomationTestBase& Test, const TCHAR* What, const TArray<uint8>& Bytes, const FString& Expected)
+	{
+		Test.TestEqual(What, DocGenUTF8::ToString(Bytes.GetData(), Bytes.Num()), Expected);
+	}
+
+	FString Replacements(int32 Count)
+	{
+		return FString::ChrN(Count, TCHAR(0xFFFD));
+	}
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenUTF8RoundTripTest, "KantanDocGen.UTF8.RoundTrip",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenUTF8RoundTripTest::RunTest(const FString& Parameters)
+{
+	// ASCII is converted 8 characters at a time when encoding and 16 when decoding, every length up to a few blocks
+	// leaves a different remainder for the per character path
+	FString Ascii;
+	for (int32 Len = 0; Len <= 50; ++Len)
+	{
+		TestRoundTrip(*this, FString::Printf(TEXT("%d ASCII characters"), Len), Ascii);
+		Ascii.AppendChar(TCHAR('!' + Len % 90));
+	}
+
+	// A character outside ASCII ends a vector block wherever it is
+	const TCHAR* const MultiByte[] = {TEXT("\u00E9"), TEXT("\u20AC"), TEXT("\U0001F600")};
+	for (const TCHAR* Char : MultiByte)
+	{
+		for (int32 Position = 0; Position <= 34; ++Position)
+		{
+			const FString Text = Ascii.Left(Position) + Char + Ascii.Left(34 - Position);
+			TestRoundTrip(*this, FString::Printf(TEXT("%s after %d ASCII characters"), Char, Position), Text);
+		}
+	}
+
+	TestRoundTrip(*this, TEXT("Mixed text"),
+				  TEXT("Vector \u00E9l\u00E9ment \u2192 \u4E2D\u6587 \U0001F600\U0001F680 done, \u00FC\u00DF\u00F8"));
+	TestRoundTrip(*this, TEXT("Only multi-byte"), TEXT("\u00E9\u00E9\u20AC\u20AC\U0001F600\U0001F600\u4E2D"));
+	TestRoundTrip(*this, TEXT("Control characters"), TEXT("\t\r\n\x01\x7F"));
+	TestRoundTrip(*this, TEXT("Highest code points"), TEXT("\u07FF\u0800\uFFFD\U00010000\U0010FFFF"));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenUTF8LoneSurrogateTest, "KantanDocGen.UTF8.LoneSurrogates",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenUTF8LoneSurrogateTest::RunTest(const FString& Parameters)
+{
+	// UTF-16 only, elsewhere a TCHAR holds the whole code point
+	if (sizeof(TCHAR) != 2)
+	{
+		return true;
+	}
+	const FString Padding = TEXT("0123456789abcdef");
+	const struct
+	{
+		const TCHAR* What;
+		TArray<TCHAR> Units;
+		FString Replaced;
+	} Cases[] = {
+		{TEXT("High surrogate"), {0xD800}, Replacements(1)},
+		{TEXT("Low surrogate"), {0xDC00}, Replacements(1)},
+		{TEXT("Reversed pair"), {0xDE00, 0xD83D}, Replacements(2)},
+		{TEXT("Two high surrogates"), {0xD83D, 0xD83D}, Replacements(2)},
+		{TEXT("High surrogate before ASCII"), {0xDBFF, TCHAR('A')}, Replacements(1) + TEXT("A")},
+	};
+	for (const auto& Case : Cases)
+	{
+		// At the start of a vector block, in the middle of one and at the start of the next
+		for (const int32 PaddingLen : {0, 5, 16})
+		{
+			FString Text = Padding.Left(PaddingLen);
+			FString Replaced = Text;
+			for (TCHAR Unit : Case.Units)
+			{
+				Text.AppendChar(Unit);
+			}
+			Replaced += Case.Replaced;
+			Text += Padding;
+			Replaced += Padding;
+
+			const FString What = FString::Printf(TEXT("%s after %d characters"), Case.What, PaddingLen);
+			const TArray<uint8> Encoded = DocGenUTF8::FromString(Text);
+			TestTrue(FString::Printf(TEXT("%s is replaced"), *What), Encoded == EngineEncode(Replaced));
+			TestEqual(FString::Printf(TEXT("%s encoded length"), *What), DocGenUTF8::EncodedLength(Text),
+					  static_cast<int64>(Encoded.Num()));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDocGenUTF8MalformedTest, "KantanDocGen.UTF8.Malformed",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FDocGenUTF8MalformedTest::RunTest(const FString& Parameters)
+{
+	// Each byte of a malformed sequence that can't start a valid one becomes a replacement character of its own
+	TestDecode(*this, TEXT("Overlong two byte slash"), {0xC0, 0xAF}, Replacements(2));
+	TestDecode(*this, TEXT("Overlong three byte slash"), {0xE0, 0x80, 0xAF}, Replacements(3));
+	TestDecode(*this, TEXT("Overlong four byte"), {0xF0, 0x80, 0x80, 0xAF}, Replacements(4));
+	TestDecode(*this, TEXT("Encoded surrogate"), {0xED, 0xA0, 0x80}, Replacements(3));
+	TestDecode(*this, TEXT("Past the last code point"), {0xF4, 0x90, 0x80, 0x80}, Replacements(4));
+	TestDecode(*this, TEXT("Invalid lead byte"), {'a', 0xF8, 'b'}, TEXT("a") + Replacements(1) + TEXT("b"));
+	TestDecode(*this, TEXT("Lone continuation byte"), {'a', 0x80, 'b'}, TEXT("a") + Replacements(1) + TEXT("b"));
+	TestDecode(*this, TEXT("Truncated at the end"), {'a', 0xE2, 0x82}, TEXT("a") + Replacements(2));
+	TestDecode(*this, TEXT("Truncated before ASCII"), {0xE2, 0x82, 'a'}, Replacements(2) + TEXT("a"));
+	TestDecode(*this, TEXT("Truncated before another sequence"), {0xF0, 0x9F, 0xC3, 0xA9},
+			   Replacements(2) + TEXT("\u00E9"));
+
+	// A malformed byte in the middle of a 16 byte ASCII block
+	TArray<uint8> Block;
+	for (int32 Index = 0; Index < 40; ++Index)
+	{
+		Block.Add(Index == 20 ? 0xFF : 'x');
+	}
+	TestDecode(*this, TEXT("Malformed byte among ASCII"), Block,
+			   FString::ChrN(20, TCHAR('x')) + Replacements(1) + FString::ChrN(19, TCHAR('x')));
+
+	const TArray<uint8> WithMark = {0xEF, 0xBB, 0xBF, 'a', 0xC3, 0xA9};
+	TestEqual(TEXT("Byte order mark is skipped"), DocGenUTF8::BufferToString(WithMark.GetData(), WithMark.Num()),
+			  FString(TEXT("a\u00E9")));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
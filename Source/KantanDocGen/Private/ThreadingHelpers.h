@@ -7,10 +7,25 @@
 #pragma once
 
 #include "Async/TaskGraphInterfaces.h"
+#include "Templates/SharedPointer.h"
 
+class FJsonObject;
 
 namespace DocGenThreads
 {
+	template <typename TPointer>
+	struct TSharedPointerMode;
+
+	template <typename TObject, ESPMode Mode>
+	struct TSharedPointerMode<TSharedPtr<TObject, Mode>>
+	{
+		static constexpr ESPMode Value = Mode;
+	};
+
+	/// Whether json documents are reference counted thread safely, which depends on the engine's default shared
+	/// pointer mode. Where they aren't, copying a pointer into a document races with other threads doing the same,
+	/// so each parsed document has to stay on the thread that parsed it.
+	constexpr bool bThreadSafeJson = TSharedPointerMode<TSharedPtr<FJsonObject>>::Value == ESPMode::ThreadSafe;
 
 	template < typename TLambda >
 	inline auto RunOnGameThread(TLambda Func) -> void